@@ -1,4 +1,5 @@
 #include "battle_scene.h"
+#include "ui_font.h"
 #include <raylib.h>
 #include <algorithm>
 #include <cstdlib>
@@ -558,11 +559,11 @@ void BattleScene::draw() {
             stateText = "Escaped! (Press SPACE)";
             break;
     }
-    DrawText(stateText, 300, 50, 20, WHITE);
+    UIFont::drawText(stateText, 300, 50, 20, WHITE);
 
     // Draw party status
     int yPos = 100;
-    DrawText("PARTY:", 50, yPos, 20, GREEN);
+    UIFont::drawText("PARTY:", 50, yPos, 20, GREEN);
     yPos += 30;
     for (size_t i = 0; i < m_party->getActiveCount(); ++i) {
         PartyMember* member = m_party->getActiveMember(i);
@@ -572,7 +573,7 @@ void BattleScene::draw() {
                 (m_selectedSkill && m_selectedSkill->targetsAlly() || m_selectedItem)) {
                 color = YELLOW;
             }
-            DrawText(TextFormat("%s HP: %d/%d MP: %d/%d",
+            UIFont::drawText(TextFormat("%s HP: %d/%d MP: %d/%d",
                 member->getName().c_str(),
                 member->getStats().getHP(),
                 member->getStats().getMaxHP(),
@@ -586,7 +587,7 @@ void BattleScene::draw() {
     // Draw enemies
     if (m_enemyFormation) {
         yPos = 100;
-        DrawText("ENEMIES:", 500, yPos, 20, RED);
+        UIFont::drawText("ENEMIES:", 500, yPos, 20, RED);
         yPos += 30;
         for (size_t i = 0; i < m_enemyFormation->getEnemies().size(); ++i) {
             Enemy* enemy = m_enemyFormation->getEnemy(i);
@@ -596,7 +597,7 @@ void BattleScene::draw() {
                     (!m_selectedSkill || m_selectedSkill->targetsEnemy())) {
                     color = YELLOW;
                 }
-                DrawText(TextFormat("%s HP: %d/%d",
+                UIFont::drawText(TextFormat("%s HP: %d/%d",
                     enemy->getName().c_str(),
                     enemy->getStats().getHP(),
                     enemy->getStats().getMaxHP()),
@@ -612,7 +613,7 @@ void BattleScene::draw() {
         const char* commands[] = {"ATTACK", "MAGIC", "ITEM", "DEFEND", "RUN"};
         for (int i = 0; i < 5; ++i) {
             Color color = (i == static_cast<int>(m_selectedCommand)) ? YELLOW : WHITE;
-            DrawText(commands[i], 70, 420 + i * 25, 20, color);
+            UIFont::drawText(commands[i], 70, 420 + i * 25, 20, color);
         }
     }
 
@@ -623,12 +624,12 @@ void BattleScene::draw() {
         if (member) {
             const auto& skills = member->getSkills();
             DrawRectangle(50, 300, 400, 250, Fade(PURPLE, 0.5f));
-            DrawText("SKILLS:", 60, 310, 20, WHITE);
+            UIFont::drawText("SKILLS:", 60, 310, 20, WHITE);
             for (size_t i = 0; i < skills.size(); ++i) {
                 Color color = (i == m_selectedSkillIndex) ? YELLOW : WHITE;
                 bool hasMP = member->getStats().hasEnoughMP(skills[i].getMPCost());
                 if (!hasMP) color = GRAY;
-                DrawText(TextFormat("%s (MP: %d)", skills[i].getName().c_str(), skills[i].getMPCost()),
+                UIFont::drawText(TextFormat("%s (MP: %d)", skills[i].getName().c_str(), skills[i].getMPCost()),
                     70, 340 + i * 25, 16, color);
             }
         }
@@ -645,16 +646,16 @@ void BattleScene::draw() {
         }
 
         DrawRectangle(50, 300, 400, 250, Fade(GREEN, 0.5f));
-        DrawText("ITEMS:", 60, 310, 20, WHITE);
+        UIFont::drawText("ITEMS:", 60, 310, 20, WHITE);
         for (size_t i = 0; i < usableItems.size(); ++i) {
             Color color = (i == m_selectedItemIndex) ? YELLOW : WHITE;
-            DrawText(TextFormat("%s x%d", usableItems[i]->item->getName().c_str(), usableItems[i]->quantity),
+            UIFont::drawText(TextFormat("%s x%d", usableItems[i]->item->getName().c_str(), usableItems[i]->quantity),
                 70, 340 + i * 25, 16, color);
         }
     }
 
     // Highlight target in TARGET_SELECT state
     if (m_battleState == BattleState::TARGET_SELECT) {
-        DrawText("< Use LEFT/RIGHT to select target >", 250, 560, 16, YELLOW);
+        UIFont::drawText("< Use LEFT/RIGHT to select target >", 250, 560, 16, YELLOW);
     }
 }
@@ -9,6 +9,8 @@ public:
 
     int getOffsetX() const { return m_offsetX; }
     int getOffsetY() const { return m_offsetY; }
+    int getViewWidth() const { return m_screenWidth; }
+    int getViewHeight() const { return m_screenHeight; }
 
 private:
     int m_screenWidth;
@@ -0,0 +1,192 @@
+#include "chunk_mesh_renderer.h"
+#include <rlgl.h>
+#include <raymath.h>
+#include <algorithm>
+
+namespace {
+
+const char* TILE_VERTEX_SHADER = R"(#version 330
+in vec3 vertexPosition;
+in vec2 vertexTexCoord;
+in float vertexAnimation;
+out vec2 fragTexCoord;
+uniform mat4 mvp;
+uniform vec2 animationOffsets[32];
+void main() {
+    fragTexCoord = vertexTexCoord;
+    if (vertexAnimation >= 0.0) {
+        fragTexCoord += animationOffsets[int(vertexAnimation)];
+    }
+    gl_Position = mvp * vec4(vertexPosition.xy, 0.0, 1.0);
+}
+)";
+
+const char* TILE_FRAGMENT_SHADER = R"(#version 330
+in vec2 fragTexCoord;
+out vec4 finalColor;
+uniform sampler2D texture0;
+void main() {
+    finalColor = texture(texture0, fragTexCoord);
+}
+)";
+
+// Attribute locations raylib binds vertexPosition / vertexTexCoord to
+constexpr int POSITION_ATTRIBUTE = 0;
+constexpr int TEXCOORD_ATTRIBUTE = 1;
+
+} // namespace
+
+ChunkMeshRenderer::ChunkMeshRenderer(int maxMeshes)
+    : m_maxMeshes(std::max(1, maxMeshes)), m_mvpLoc(-1), m_textureLoc(-1),
+      m_animationOffsetsLoc(-1), m_animationAttribute(-1) {
+    m_shader = {0};
+}
+
+ChunkMeshRenderer::~ChunkMeshRenderer() {
+    clear();
+    if (m_shader.id > 0) {
+        UnloadShader(m_shader);
+    }
+}
+
+bool ChunkMeshRenderer::hasMesh(int chunkIndex, uint32_t revision) {
+    auto it = m_meshes.find(chunkIndex);
+    if (it == m_meshes.end() || it->second.revision != revision) {
+        return false;
+    }
+
+    m_lru.splice(m_lru.begin(), m_lru, it->second.lruPosition);
+    return true;
+}
+
+void ChunkMeshRenderer::upload(int chunkIndex, uint32_t revision, const std::vector<float>& vertices) {
+    // The animation attribute location comes from the shader
+    ensureShader();
+
+    int vertexCount = static_cast<int>(vertices.size()) / FLOATS_PER_VERTEX;
+    int byteSize = static_cast<int>(vertices.size() * sizeof(float));
+
+    auto it = m_meshes.find(chunkIndex);
+    if (it != m_meshes.end() && it->second.vao > 0 && it->second.capacity >= vertexCount) {
+        // Same chunk with a buffer that is big enough: update in place
+        Mesh& mesh = it->second;
+        if (vertexCount > 0) {
+            rlUpdateVertexBuffer(mesh.vbo, vertices.data(), byteSize, 0);
+        }
+        mesh.vertexCount = vertexCount;
+        mesh.revision = revision;
+        m_lru.splice(m_lru.begin(), m_lru, mesh.lruPosition);
+        return;
+    }
+
+    if (it != m_meshes.end()) {
+        unloadMesh(it->second);
+        m_lru.erase(it->second.lruPosition);
+        m_meshes.erase(it);
+    }
+
+    while (static_cast<int>(m_meshes.size()) >= m_maxMeshes) {
+        int victim = m_lru.back();
+        m_lru.pop_back();
+        unloadMesh(m_meshes[victim]);
+        m_meshes.erase(victim);
+    }
+
+    Mesh mesh = {};
+    if (vertexCount > 0) {
+        mesh.vao = rlLoadVertexArray();
+        rlEnableVertexArray(mesh.vao);
+        mesh.vbo = rlLoadVertexBuffer(vertices.data(), byteSize, true);
+
+        int stride = FLOATS_PER_VERTEX * sizeof(float);
+        rlSetVertexAttribute(POSITION_ATTRIBUTE, 2, RL_FLOAT, false, stride, nullptr);
+        rlEnableVertexAttribute(POSITION_ATTRIBUTE);
+        rlSetVertexAttribute(TEXCOORD_ATTRIBUTE, 2, RL_FLOAT, false, stride, reinterpret_cast<const void*>(2 * sizeof(float)));
+        rlEnableVertexAttribute(TEXCOORD_ATTRIBUTE);
+        if (m_animationAttribute >= 0) {
+            rlSetVertexAttribute(m_animationAttribute, 1, RL_FLOAT, false, stride, reinterpret_cast<const void*>(4 * sizeof(float)));
+            rlEnableVertexAttribute(m_animationAttribute);
+        }
+        rlDisableVertexArray();
+    }
+
+    mesh.vertexCount = vertexCount;
+    mesh.capacity = vertexCount;
+    mesh.revision = revision;
+
+    m_lru.push_front(chunkIndex);
+    mesh.lruPosition = m_lru.begin();
+    m_meshes[chunkIndex] = mesh;
+}
+
+void ChunkMeshRenderer::begin(const Texture2D& tileset, int cameraOffsetX, int cameraOffsetY) {
+    ensureShader();
+
+    // Anything queued in raylib's internal batch must be drawn before our buffers
+    rlDrawRenderBatchActive();
+
+    Matrix view = MatrixMultiply(MatrixTranslate(static_cast<float>(-cameraOffsetX),
+                                                 static_cast<float>(-cameraOffsetY), 0.0f),
+                                 rlGetMatrixModelview());
+    Matrix mvp = MatrixMultiply(view, rlGetMatrixProjection());
+
+    rlEnableShader(m_shader.id);
+    rlSetUniformMatrix(m_mvpLoc, mvp);
+
+    int textureSlot = 0;
+    rlActiveTextureSlot(textureSlot);
+    rlEnableTexture(tileset.id);
+    rlSetUniform(m_textureLoc, &textureSlot, SHADER_UNIFORM_INT, 1);
+}
+
+void ChunkMeshRenderer::setAnimationOffsets(const std::vector<Vector2>& offsets) {
+    int count = std::min(static_cast<int>(offsets.size()), MAX_ANIMATIONS);
+    if (count > 0) {
+        rlSetUniform(m_animationOffsetsLoc, offsets.data(), SHADER_UNIFORM_VEC2, count);
+    }
+}
+
+bool ChunkMeshRenderer::draw(int chunkIndex) {
+    auto it = m_meshes.find(chunkIndex);
+    if (it == m_meshes.end() || it->second.vertexCount == 0) {
+        return false;
+    }
+
+    rlEnableVertexArray(it->second.vao);
+    rlDrawVertexArray(0, it->second.vertexCount);
+    return true;
+}
+
+void ChunkMeshRenderer::end() {
+    rlDisableVertexArray();
+    rlDisableTexture();
+    rlDisableShader();
+}
+
+void ChunkMeshRenderer::clear() {
+    for (const auto& pair : m_meshes) {
+        unloadMesh(pair.second);
+    }
+    m_meshes.clear();
+    m_lru.clear();
+}
+
+void ChunkMeshRenderer::ensureShader() {
+    if (m_shader.id > 0) {
+        return;
+    }
+
+    m_shader = LoadShaderFromMemory(TILE_VERTEX_SHADER, TILE_FRAGMENT_SHADER);
+    m_mvpLoc = GetShaderLocation(m_shader, "mvp");
+    m_textureLoc = GetShaderLocation(m_shader, "texture0");
+    m_animationOffsetsLoc = GetShaderLocation(m_shader, "animationOffsets");
+    m_animationAttribute = GetShaderLocationAttrib(m_shader, "vertexAnimation");
+}
+
+void ChunkMeshRenderer::unloadMesh(const Mesh& mesh) {
+    if (mesh.vao == 0) {
+        return;
+    }
+    rlUnloadVertexBuffer(mesh.vbo);
+    rlUnloadVertexArray(mesh.vao);
+}
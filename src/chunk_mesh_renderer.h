@@ -0,0 +1,79 @@
+#pragma once
+
+#include <raylib.h>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+// GPU-side tile meshes for the BATCHED_MESH render mode.
+// Each chunk is uploaded once as an rlgl vertex array (two triangles per tile, with
+// position + UV per vertex) and drawn with a single call. Buffers are only rebuilt
+// when the chunk revision changes, and the number of resident meshes is capped with
+// the same LRU policy as ChunkRenderCache.
+//
+// Animated tiles carry the index of their TileAnimation in the vertex data; the shader
+// adds that animation's current UV offset (see setAnimationOffsets), so advancing an
+// animation is one uniform per animation and never touches the vertex buffers.
+class ChunkMeshRenderer {
+public:
+    // Interleaved vertex layout: x, y, u, v, animation index (-1 for static tiles)
+    static constexpr int FLOATS_PER_VERTEX = 5;
+    static constexpr int MAX_ANIMATIONS = 32; // Size of the shader's offset array
+    static constexpr int VERTICES_PER_TILE = 6;
+
+    explicit ChunkMeshRenderer(int maxMeshes);
+    ~ChunkMeshRenderer();
+
+    ChunkMeshRenderer(const ChunkMeshRenderer&) = delete;
+    ChunkMeshRenderer& operator=(const ChunkMeshRenderer&) = delete;
+
+    // True if the chunk has an up-to-date mesh (and marks it as recently used)
+    bool hasMesh(int chunkIndex, uint32_t revision);
+
+    // Upload (or re-upload) the vertices of a chunk; an empty vertex list is remembered
+    // without allocating GPU buffers
+    void upload(int chunkIndex, uint32_t revision, const std::vector<float>& vertices);
+
+    // Draw calls must be wrapped in begin()/end(); vertex positions are in world pixels.
+    // Returns false if the chunk has nothing to draw.
+    void begin(const Texture2D& tileset, int cameraOffsetX, int cameraOffsetY);
+    // UV offset of each animation's current frame from its base tile; call after begin()
+    void setAnimationOffsets(const std::vector<Vector2>& offsets);
+    bool draw(int chunkIndex);
+    void end();
+
+    void clear();
+
+    // True if the chunk has no mesh or one without vertices
+    bool isEmpty(int chunkIndex) const {
+        auto it = m_meshes.find(chunkIndex);
+        return it == m_meshes.end() || it->second.vertexCount == 0;
+    }
+
+    int getMeshCount() const { return static_cast<int>(m_meshes.size()); }
+
+private:
+    struct Mesh {
+        unsigned int vao;   // 0 when the chunk has no vertices
+        unsigned int vbo;
+        int vertexCount;
+        int capacity;   // Vertices the buffer was allocated for
+        uint32_t revision;
+        std::list<int>::iterator lruPosition;
+    };
+
+    void ensureShader();
+    void unloadMesh(const Mesh& mesh);
+
+    int m_maxMeshes;
+
+    std::list<int> m_lru;
+    std::unordered_map<int, Mesh> m_meshes;
+
+    Shader m_shader;
+    int m_mvpLoc;
+    int m_textureLoc;
+    int m_animationOffsetsLoc;
+    int m_animationAttribute; // Location of vertexAnimation
+};
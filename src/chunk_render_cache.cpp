@@ -0,0 +1,73 @@
+#include "chunk_render_cache.h"
+#include <algorithm>
+
+ChunkRenderCache::ChunkRenderCache(int chunkPixelSize, int maxBakedChunks)
+    : m_chunkPixelSize(chunkPixelSize), m_maxBakedChunks(std::max(1, maxBakedChunks)) {}
+
+ChunkRenderCache::~ChunkRenderCache() {
+    clear();
+}
+
+const RenderTexture2D* ChunkRenderCache::find(int chunkIndex, uint32_t revision) {
+    auto it = m_entries.find(chunkIndex);
+    if (it == m_entries.end() || it->second.revision != revision) {
+        return nullptr;
+    }
+
+    // Move to front of the LRU list
+    m_lru.splice(m_lru.begin(), m_lru, it->second.lruPosition);
+    return &it->second.target;
+}
+
+const RenderTexture2D& ChunkRenderCache::acquire(int chunkIndex, uint32_t revision) {
+    auto it = m_entries.find(chunkIndex);
+    if (it != m_entries.end()) {
+        // Stale entry: re-bake into the texture we already own
+        it->second.revision = revision;
+        m_lru.splice(m_lru.begin(), m_lru, it->second.lruPosition);
+        return it->second.target;
+    }
+
+    RenderTexture2D target = {0};
+    if (static_cast<int>(m_entries.size()) >= m_maxBakedChunks) {
+        // Recycle the least recently used texture instead of allocating a new one
+        int victim = m_lru.back();
+        target = m_entries[victim].target;
+        m_lru.pop_back();
+        m_entries.erase(victim);
+    } else {
+        target = LoadRenderTexture(m_chunkPixelSize, m_chunkPixelSize);
+    }
+
+    m_lru.push_front(chunkIndex);
+    m_entries[chunkIndex] = Entry{target, revision, m_lru.begin()};
+    return m_entries[chunkIndex].target;
+}
+
+void ChunkRenderCache::clear() {
+    for (auto& pair : m_entries) {
+        if (pair.second.target.id > 0) {
+            UnloadRenderTexture(pair.second.target);
+        }
+    }
+    m_entries.clear();
+    m_lru.clear();
+}
+
+void ChunkRenderCache::setMaxBakedChunks(int maxBakedChunks) {
+    m_maxBakedChunks = std::max(1, maxBakedChunks);
+    while (static_cast<int>(m_entries.size()) > m_maxBakedChunks) {
+        evictLeastRecentlyUsed();
+    }
+}
+
+void ChunkRenderCache::evictLeastRecentlyUsed() {
+    int victim = m_lru.back();
+    m_lru.pop_back();
+
+    auto it = m_entries.find(victim);
+    if (it->second.target.id > 0) {
+        UnloadRenderTexture(it->second.target);
+    }
+    m_entries.erase(it);
+}
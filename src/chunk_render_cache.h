@@ -0,0 +1,50 @@
+#pragma once
+
+#include <raylib.h>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+
+// LRU cache of pre-rendered tilemap chunks.
+// Each entry remembers the chunk revision it was baked from, so a chunk only needs
+// to be re-baked after setTile changed something inside it. The number of resident
+// render textures is capped; the least recently drawn chunk is recycled first.
+class ChunkRenderCache {
+public:
+    ChunkRenderCache(int chunkPixelSize, int maxBakedChunks);
+    ~ChunkRenderCache();
+
+    ChunkRenderCache(const ChunkRenderCache&) = delete;
+    ChunkRenderCache& operator=(const ChunkRenderCache&) = delete;
+
+    // Returns the baked texture for a chunk if it is up to date (and marks it as recently used),
+    // nullptr otherwise
+    const RenderTexture2D* find(int chunkIndex, uint32_t revision);
+
+    // Returns a render texture the caller must bake the chunk into.
+    // Reuses the chunk's stale texture or recycles the least recently used one when full.
+    const RenderTexture2D& acquire(int chunkIndex, uint32_t revision);
+
+    // Drop every baked chunk (e.g. when the tileset changes)
+    void clear();
+
+    void setMaxBakedChunks(int maxBakedChunks);
+    int getMaxBakedChunks() const { return m_maxBakedChunks; }
+    int getBakedChunkCount() const { return static_cast<int>(m_entries.size()); }
+
+private:
+    struct Entry {
+        RenderTexture2D target;
+        uint32_t revision;
+        std::list<int>::iterator lruPosition;
+    };
+
+    void evictLeastRecentlyUsed();
+
+    int m_chunkPixelSize;
+    int m_maxBakedChunks;
+
+    // Front = most recently used chunk index
+    std::list<int> m_lru;
+    std::unordered_map<int, Entry> m_entries;
+};
@@ -0,0 +1,308 @@
+#include "chunk_streamer.h"
+#include "jmap_format.h"
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <utility>
+
+ChunkStreamer::ChunkStreamer(Tilemap& tilemap, const std::string& path, size_t memoryBudget)
+    : m_tilemap(tilemap)
+    , m_path(path)
+    , m_memoryBudget(memoryBudget)
+    , m_streamRadius(DEFAULT_STREAM_RADIUS)
+    , m_chunksX(tilemap.getChunksX())
+    , m_chunksY(tilemap.getChunksY())
+    , m_layerCount(0)
+    , m_fileSize(0)
+    , m_residentBytes(0)
+    , m_residentChunks(0)
+    , m_pending(0)
+    , m_requests(QUEUE_CAPACITY)
+    , m_results(QUEUE_CAPACITY)
+    , m_running(false)
+{
+    if (!open(path)) {
+        return;
+    }
+
+    int chunkCount = m_chunksX * m_chunksY;
+    m_states.assign(chunkCount, ChunkState::UNLOADED);
+    m_chunkBytes.assign(chunkCount, 0);
+    m_revisions.resize(chunkCount);
+    for (int i = 0; i < chunkCount; i++) {
+        for (int layer = 0; layer < Tilemap::LAYER_COUNT; layer++) {
+            m_revisions[i][layer] = m_tilemap.getChunkRevision(i % m_chunksX, i / m_chunksX,
+                                                               static_cast<MapLayer>(layer));
+        }
+    }
+
+    m_running = true;
+    m_worker = std::thread(&ChunkStreamer::workerLoop, this);
+}
+
+ChunkStreamer::~ChunkStreamer() {
+    if (m_worker.joinable()) {
+        m_running = false;
+        m_wake.notify_one();
+        m_worker.join();
+    }
+}
+
+bool ChunkStreamer::open(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        std::cerr << "Failed to open map for streaming: " << path << std::endl;
+        return false;
+    }
+
+    jmap::Header header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        header.magic != jmap::MAGIC || header.version != jmap::VERSION ||
+        header.chunkSize != TileChunk::SIZE ||
+        header.chunksX != static_cast<uint32_t>(m_chunksX) || header.chunksY != static_cast<uint32_t>(m_chunksY)) {
+        std::cerr << "Map does not match the streamed tilemap: " << path << std::endl;
+        return false;
+    }
+
+    m_layerCount = std::min<int>(header.layerCount, Tilemap::LAYER_COUNT);
+    m_fileSize = header.fileSize;
+
+    // Only the layers this build knows about, which come first in the index
+    m_chunkOffsets.resize(static_cast<size_t>(m_layerCount) * m_chunksX * m_chunksY);
+    file.seekg(static_cast<std::streamoff>(header.chunkIndexOffset));
+    if (!file.read(reinterpret_cast<char*>(m_chunkOffsets.data()),
+                   static_cast<std::streamsize>(m_chunkOffsets.size() * sizeof(uint64_t)))) {
+        std::cerr << "Failed to read the chunk index of " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void ChunkStreamer::workerLoop() {
+    std::ifstream file(m_path, std::ios::binary);
+
+    while (m_running) {
+        ChunkRequest request;
+        if (!m_requests.pop(request)) {
+            // The main thread notifies without taking the lock, so a wakeup can be missed;
+            // the timeout bounds the delay in that case.
+            std::unique_lock<std::mutex> lock(m_wakeMutex);
+            m_wake.wait_for(lock, WORKER_IDLE_WAIT);
+            continue;
+        }
+
+        ChunkResult result;
+        result.chunkIndex = request.chunkIndex;
+        result.ok = file && readChunk(file, request.chunkIndex, result);
+        if (!result.ok) {
+            file.clear();
+        }
+
+        // Never fails: the main thread keeps at most QUEUE_CAPACITY chunks in flight
+        m_results.push(std::move(result));
+    }
+}
+
+bool ChunkStreamer::readChunk(std::ifstream& file, int chunkIndex, ChunkResult& result) const {
+    size_t chunkCount = static_cast<size_t>(m_chunksX) * m_chunksY;
+    for (int layer = 0; layer < m_layerCount; layer++) {
+        uint64_t offset = m_chunkOffsets[layer * chunkCount + chunkIndex];
+        if (offset == 0) {
+            continue;
+        }
+
+        jmap::ChunkBlock block;
+        file.seekg(static_cast<std::streamoff>(offset));
+        // Compared so that a corrupt offset near 2^64 can't wrap around
+        if (offset > m_fileSize || sizeof(block) > m_fileSize - offset || !file.read(reinterpret_cast<char*>(&block), sizeof(block))) {
+            return false;
+        }
+        uint64_t blockSize = jmap::getChunkBlockSize(block);
+        if (blockSize == 0 || blockSize > m_fileSize - offset) {
+            return false;
+        }
+
+        LoadedChunk& loaded = result.layers[layer];
+        loaded.encoding = static_cast<ChunkEncoding>(block.encoding);
+        loaded.uniformTile = block.uniformTile;
+        loaded.paletteSize = block.paletteSize;
+        loaded.indexBits = block.indexBits;
+
+        size_t words = (blockSize - sizeof(block)) / sizeof(uint64_t);
+        if (words > 0) {
+            loaded.data = std::make_unique<uint64_t[]>(words);
+            if (!file.read(reinterpret_cast<char*>(loaded.data.get()),
+                           static_cast<std::streamsize>(words * sizeof(uint64_t)))) {
+                return false;
+            }
+        }
+        result.hasBlock[layer] = true;
+    }
+    return true;
+}
+
+void ChunkStreamer::update(int centerTileX, int centerTileY, int moveDirX, int moveDirY) {
+    if (!isOpen()) {
+        return;
+    }
+
+    installResults();
+
+    int centerX = std::clamp(centerTileX / TileChunk::SIZE, 0, m_chunksX - 1);
+    int centerY = std::clamp(centerTileY / TileChunk::SIZE, 0, m_chunksY - 1);
+    int aheadX = std::clamp(centerX + moveDirX * LOOKAHEAD_CHUNKS, 0, m_chunksX - 1);
+    int aheadY = std::clamp(centerY + moveDirY * LOOKAHEAD_CHUNKS, 0, m_chunksY - 1);
+
+    requestChunks(centerX, centerY, aheadX, aheadY);
+    evictOverBudget(centerX, centerY, aheadX, aheadY);
+}
+
+void ChunkStreamer::flush() {
+    while (m_pending > 0) {
+        installResults();
+        if (m_pending > 0) {
+            m_wake.notify_one();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+}
+
+void ChunkStreamer::installResults() {
+    ChunkResult result;
+    while (m_results.pop(result)) {
+        int chunkIndex = result.chunkIndex;
+        m_pending--;
+
+        if (!result.ok) {
+            // Leave it as the default tile; retrying every frame would only spam the log
+            std::cerr << "Failed to stream chunk " << chunkIndex << " of " << m_path << std::endl;
+            m_tilemap.finishChunkStream(chunkIndex % m_chunksX, chunkIndex / m_chunksX);
+            m_states[chunkIndex] = ChunkState::RESIDENT;
+            m_residentChunks++;
+            continue;
+        }
+
+        int chunkX = chunkIndex % m_chunksX;
+        int chunkY = chunkIndex / m_chunksX;
+        size_t bytes = 0;
+        for (int layer = 0; layer < m_layerCount; layer++) {
+            if (!result.hasBlock[layer]) {
+                continue;
+            }
+            MapLayer mapLayer = static_cast<MapLayer>(layer);
+            m_tilemap.installChunk(chunkX, chunkY, mapLayer, std::move(result.layers[layer]));
+            m_revisions[chunkIndex][layer] = m_tilemap.getChunkRevision(chunkX, chunkY, mapLayer);
+        }
+        // Tiles set before the chunk arrived go back on top of the file's. They leave the
+        // layer dirty, which keeps it from being evicted.
+        m_tilemap.finishChunkStream(chunkX, chunkY);
+        for (int layer = 0; layer < m_layerCount; layer++) {
+            if (result.hasBlock[layer]) {
+                bytes += m_tilemap.getChunkMemoryUsage(chunkX, chunkY, static_cast<MapLayer>(layer));
+            }
+        }
+
+        m_states[chunkIndex] = ChunkState::RESIDENT;
+        m_chunkBytes[chunkIndex] = bytes;
+        m_residentBytes += bytes;
+        m_residentChunks++;
+    }
+}
+
+void ChunkStreamer::requestChunks(int centerX, int centerY, int aheadX, int aheadY) {
+    int minX = std::max(std::min(centerX, aheadX) - m_streamRadius, 0);
+    int maxX = std::min(std::max(centerX, aheadX) + m_streamRadius, m_chunksX - 1);
+    int minY = std::max(std::min(centerY, aheadY) - m_streamRadius, 0);
+    int maxY = std::min(std::max(centerY, aheadY) + m_streamRadius, m_chunksY - 1);
+
+    // (distance, chunk index) of every missing chunk in either window, nearest first
+    std::vector<std::pair<int, int>> missing;
+    for (int y = minY; y <= maxY; y++) {
+        for (int x = minX; x <= maxX; x++) {
+            int chunkIndex = y * m_chunksX + x;
+            if (m_states[chunkIndex] != ChunkState::UNLOADED) {
+                continue;
+            }
+            int distance = distanceToWindow(chunkIndex, centerX, centerY, aheadX, aheadY);
+            if (distance <= m_streamRadius) {
+                missing.emplace_back(distance, chunkIndex);
+            }
+        }
+    }
+    if (missing.empty()) {
+        return;
+    }
+    std::sort(missing.begin(), missing.end());
+
+    for (const auto& entry : missing) {
+        if (m_pending >= static_cast<int>(QUEUE_CAPACITY) || !m_requests.push(ChunkRequest{entry.second})) {
+            break;
+        }
+        m_states[entry.second] = ChunkState::PENDING;
+        m_pending++;
+    }
+    m_wake.notify_one();
+}
+
+void ChunkStreamer::evictOverBudget(int centerX, int centerY, int aheadX, int aheadY) {
+    if (m_residentBytes <= m_memoryBudget) {
+        return;
+    }
+
+    // Farthest chunks go first; anything inside the stream windows stays
+    std::vector<std::pair<int, int>> candidates;
+    for (int i = 0; i < static_cast<int>(m_states.size()); i++) {
+        if (m_states[i] != ChunkState::RESIDENT) {
+            continue;
+        }
+        int distance = distanceToWindow(i, centerX, centerY, aheadX, aheadY);
+        if (distance > m_streamRadius) {
+            candidates.emplace_back(distance, i);
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), std::greater<std::pair<int, int>>());
+
+    for (const auto& entry : candidates) {
+        if (m_residentBytes <= m_memoryBudget) {
+            break;
+        }
+        evict(entry.second);
+    }
+}
+
+void ChunkStreamer::evict(int chunkIndex) {
+    // Evicting would throw away edits, so edited chunks stay resident
+    for (int layer = 0; layer < m_layerCount; layer++) {
+        if (isLayerDirty(chunkIndex, layer)) {
+            return;
+        }
+    }
+
+    int chunkX = chunkIndex % m_chunksX;
+    int chunkY = chunkIndex / m_chunksX;
+    for (int layer = 0; layer < m_layerCount; layer++) {
+        MapLayer mapLayer = static_cast<MapLayer>(layer);
+        m_tilemap.evictChunk(chunkX, chunkY, mapLayer);
+        m_revisions[chunkIndex][layer] = m_tilemap.getChunkRevision(chunkX, chunkY, mapLayer);
+    }
+
+    m_states[chunkIndex] = ChunkState::UNLOADED;
+    m_residentBytes -= m_chunkBytes[chunkIndex];
+    m_chunkBytes[chunkIndex] = 0;
+    m_residentChunks--;
+}
+
+int ChunkStreamer::distanceToWindow(int chunkIndex, int centerX, int centerY, int aheadX, int aheadY) const {
+    int x = chunkIndex % m_chunksX;
+    int y = chunkIndex / m_chunksX;
+    int toCenter = std::max(std::abs(x - centerX), std::abs(y - centerY));
+    int toAhead = std::max(std::abs(x - aheadX), std::abs(y - aheadY));
+    return std::min(toCenter, toAhead);
+}
+
+bool ChunkStreamer::isLayerDirty(int chunkIndex, int layer) const {
+    int chunkX = chunkIndex % m_chunksX;
+    int chunkY = chunkIndex / m_chunksX;
+    return m_tilemap.getChunkRevision(chunkX, chunkY, static_cast<MapLayer>(layer)) != m_revisions[chunkIndex][layer];
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "tilemap.h"
+#include "spsc_queue.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Streams the chunk tiles of a .jmap file into a Tilemap loaded with MapLoadMode::STREAMED.
+//
+// A worker thread reads the chunks around the player (and ahead of them, in the direction
+// they are walking) into LoadedChunk buffers and hands them back through a lock-free queue.
+// update() runs on the main thread and only swaps the finished buffers into the map, so the
+// map itself is never touched off the main thread and needs no locking. Chunks far away
+// from the player are dropped again once the tile memory goes over the budget.
+//
+// Collision, tile flags and objects are not streamed; Tilemap keeps those mapped.
+// Tiles set with setTile before their chunk streams in are applied again over the file's,
+// and edited chunks are never evicted.
+class ChunkStreamer {
+public:
+    static constexpr size_t DEFAULT_MEMORY_BUDGET = 16 * 1024 * 1024;
+    static constexpr int DEFAULT_STREAM_RADIUS = 2; // Chunks around the player kept loaded
+
+    // The tilemap must outlive the streamer and match the file's dimensions
+    ChunkStreamer(Tilemap& tilemap, const std::string& path, size_t memoryBudget = DEFAULT_MEMORY_BUDGET);
+    ~ChunkStreamer();
+
+    ChunkStreamer(const ChunkStreamer&) = delete;
+    ChunkStreamer& operator=(const ChunkStreamer&) = delete;
+
+    bool isOpen() const { return m_worker.joinable(); }
+
+    // Call once per frame with the player's tile and movement direction (-1, 0 or 1 per axis).
+    // Installs finished chunks, queues missing ones and evicts distant ones over the budget.
+    void update(int centerTileX, int centerTileY, int moveDirX, int moveDirY);
+
+    // Blocks until every queued chunk has been installed (e.g. right after loading)
+    void flush();
+
+    void setStreamRadius(int chunks) { m_streamRadius = chunks; }
+    void setMemoryBudget(size_t bytes) { m_memoryBudget = bytes; }
+
+    size_t getResidentBytes() const { return m_residentBytes; }
+    int getResidentChunkCount() const { return m_residentChunks; }
+    int getPendingCount() const { return m_pending; }
+
+private:
+    enum class ChunkState : uint8_t { UNLOADED, PENDING, RESIDENT };
+
+    struct ChunkRequest {
+        int chunkIndex = -1;
+    };
+
+    struct ChunkResult {
+        int chunkIndex = -1;
+        bool ok = false;
+        std::array<bool, Tilemap::LAYER_COUNT> hasBlock = {};  // false = layer's default tile
+        std::array<LoadedChunk, Tilemap::LAYER_COUNT> layers;
+    };
+
+    static constexpr size_t QUEUE_CAPACITY = 64;
+    static constexpr int LOOKAHEAD_CHUNKS = 2; // How far ahead of a moving player to prefetch
+    static constexpr std::chrono::milliseconds WORKER_IDLE_WAIT{10};
+
+    bool open(const std::string& path);
+    void workerLoop();
+    bool readChunk(std::ifstream& file, int chunkIndex, ChunkResult& result) const;
+
+    void installResults();
+    void requestChunks(int centerX, int centerY, int aheadX, int aheadY);
+    void evictOverBudget(int centerX, int centerY, int aheadX, int aheadY);
+    void evict(int chunkIndex);
+
+    // Chebyshev distance in chunks to the nearer of the two stream centers
+    int distanceToWindow(int chunkIndex, int centerX, int centerY, int aheadX, int aheadY) const;
+    bool isLayerDirty(int chunkIndex, int layer) const;
+
+    Tilemap& m_tilemap;
+    std::string m_path;
+    size_t m_memoryBudget;
+    int m_streamRadius;
+
+    // Read from the file in the constructor; read-only afterwards, so the worker can use them
+    int m_chunksX;
+    int m_chunksY;
+    int m_layerCount;
+    uint64_t m_fileSize;
+    std::vector<uint64_t> m_chunkOffsets; // Layer-major like the file's chunk index
+
+    // Main thread only
+    std::vector<ChunkState> m_states;
+    std::vector<size_t> m_chunkBytes;
+    std::vector<std::array<uint32_t, Tilemap::LAYER_COUNT>> m_revisions; // Last revision the streamer wrote
+    size_t m_residentBytes;
+    int m_residentChunks;
+    int m_pending;
+
+    SpscQueue<ChunkRequest> m_requests; // Main -> worker
+    SpscQueue<ChunkResult> m_results;   // Worker -> main, the staging side of the chunk cache
+
+    std::atomic<bool> m_running;
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wake;
+    std::thread m_worker;
+};
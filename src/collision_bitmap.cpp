@@ -0,0 +1,115 @@
+#include "collision_bitmap.h"
+#include <algorithm>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace {
+
+// Bits [from, to] of a word (0 <= from <= to <= 63)
+uint64_t bitRange(int from, int to) {
+    uint64_t high = (to == 63) ? ~uint64_t(0) : ((uint64_t(1) << (to + 1)) - 1);
+    return high & ~((uint64_t(1) << from) - 1);
+}
+
+int countTrailingZeros(uint64_t value) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, value);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(value);
+#endif
+}
+
+} // namespace
+
+CollisionBitmap::CollisionBitmap(int width, int height)
+    : m_width(width), m_height(height), m_wordsPerRow((width + 63) / 64) {
+    m_owned.resize(getWordCount(), 0);
+    m_words = m_owned.data();
+}
+
+void CollisionBitmap::attach(uint64_t* words) {
+    m_words = words;
+    m_owned.clear();
+    m_owned.shrink_to_fit();
+}
+
+void CollisionBitmap::set(int x, int y, bool value) {
+    uint64_t& word = m_words[static_cast<size_t>(y) * m_wordsPerRow + x / 64];
+    uint64_t bit = uint64_t(1) << (x % 64);
+    word = value ? (word | bit) : (word & ~bit);
+}
+
+void CollisionBitmap::clear() {
+    std::fill(m_words, m_words + getWordCount(), 0);
+}
+
+bool CollisionBitmap::anyInRow(int y, int x0, int x1) const {
+    x0 = std::max(x0, 0);
+    x1 = std::min(x1, m_width - 1);
+    if (y < 0 || y >= m_height || x0 > x1) {
+        return false;
+    }
+
+    const uint64_t* row = getRow(y);
+    int firstWord = x0 / 64;
+    int lastWord = x1 / 64;
+
+    if (firstWord == lastWord) {
+        return (row[firstWord] & bitRange(x0 % 64, x1 % 64)) != 0;
+    }
+
+    if (row[firstWord] & bitRange(x0 % 64, 63)) {
+        return true;
+    }
+    for (int w = firstWord + 1; w < lastWord; w++) {
+        if (row[w]) {
+            return true;
+        }
+    }
+    return (row[lastWord] & bitRange(0, x1 % 64)) != 0;
+}
+
+bool CollisionBitmap::anyInRect(int x, int y, int w, int h) const {
+    int y0 = std::max(y, 0);
+    int y1 = std::min(y + h - 1, m_height - 1);
+    for (int row = y0; row <= y1; row++) {
+        if (anyInRow(row, x, x + w - 1)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int CollisionBitmap::findNextSet(int y, int x0, int x1) const {
+    return findNext<true>(y, x0, x1);
+}
+
+int CollisionBitmap::findNextClear(int y, int x0, int x1) const {
+    return findNext<false>(y, x0, x1);
+}
+
+template <bool Set>
+int CollisionBitmap::findNext(int y, int x0, int x1) const {
+    x0 = std::max(x0, 0);
+    x1 = std::min(x1, m_width - 1);
+    if (y < 0 || y >= m_height || x0 > x1) {
+        return -1;
+    }
+
+    const uint64_t* row = getRow(y);
+    int lastWord = x1 / 64;
+    for (int w = x0 / 64; w <= lastWord; w++) {
+        uint64_t word = Set ? row[w] : ~row[w];
+        int from = (w == x0 / 64) ? x0 % 64 : 0;
+        int to = (w == lastWord) ? x1 % 64 : 63;
+        word &= bitRange(from, to);
+        if (word) {
+            return w * 64 + countTrailingZeros(word);
+        }
+    }
+    return -1;
+}
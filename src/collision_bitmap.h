@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// One bit per tile, packed into 64-bit words with each row padded to a whole word.
+// Span and rectangle queries test up to 64 tiles per operation, which is what
+// pathfinding and movement checks lean on.
+class CollisionBitmap {
+public:
+    CollisionBitmap(int width, int height);
+
+    // Use externally owned words (e.g. a mapped file) instead of the internal storage.
+    // The memory must hold getWordCount() words and outlive the bitmap.
+    void attach(uint64_t* words);
+
+    // Coordinates must be inside the bitmap
+    bool test(int x, int y) const {
+        return (m_words[static_cast<size_t>(y) * m_wordsPerRow + x / 64] >> (x % 64)) & 1;
+    }
+    void set(int x, int y, bool value);
+    void clear();
+
+    // Any bit set in columns [x0, x1] of row y (clamped to the bitmap)
+    bool anyInRow(int y, int x0, int x1) const;
+
+    // Any bit set in the w x h rectangle at (x, y) (clamped to the bitmap)
+    bool anyInRect(int x, int y, int w, int h) const;
+
+    // First column in [x0, x1] of row y whose bit is set / clear, or -1
+    int findNextSet(int y, int x0, int x1) const;
+    int findNextClear(int y, int x0, int x1) const;
+
+    int getWidth() const { return m_width; }
+    int getHeight() const { return m_height; }
+    int getWordsPerRow() const { return m_wordsPerRow; }
+    size_t getWordCount() const { return static_cast<size_t>(m_wordsPerRow) * m_height; }
+    const uint64_t* getRow(int y) const { return m_words + static_cast<size_t>(y) * m_wordsPerRow; }
+    uint64_t* getWords() { return m_words; }
+    const uint64_t* getWords() const { return m_words; }
+
+private:
+    template <bool Set>
+    int findNext(int y, int x0, int x1) const;
+
+    int m_width;
+    int m_height;
+    int m_wordsPerRow;
+    uint64_t* m_words;
+    std::vector<uint64_t> m_owned;
+};
@@ -1,6 +1,6 @@
 #include "dialog_scene.h"
+#include "ui_font.h"
 #include "raylib.h"
-#include <sstream>
 
 DialogScene::DialogScene()
     : m_currentDialog(nullptr)
@@ -145,22 +145,19 @@ void DialogScene::drawDialogLine() {
 
     // Draw speaker name if present
     if (!line.speakerName.empty()) {
-        DrawText(line.speakerName.c_str(), TEXT_BOX_PADDING, textY, 20, YELLOW);
+        UIFont::drawText(line.speakerName.c_str(), TEXT_BOX_PADDING, textY, 20, YELLOW);
         textY += LINE_HEIGHT;
     }
 
-    // Wrap and draw dialog text
-    auto wrappedLines = wrapText(line.text, MAX_TEXT_WIDTH);
-    for (const auto& wrappedLine : wrappedLines) {
-        DrawText(wrappedLine.c_str(), TEXT_BOX_PADDING, textY, 18, WHITE);
-        textY += LINE_HEIGHT;
-    }
+    // Draw dialog text, wrapped the first time the line is shown
+    const TextLayout& layout = m_textLayouts.get(line.text, 18, MAX_TEXT_WIDTH);
+    layout.draw(TEXT_BOX_PADDING, textY, LINE_HEIGHT, WHITE);
 
     // Draw continuation indicator if not at choices
     if (!m_showingChoices && m_currentLineIndex < m_currentDialog->getLineCount() - 1) {
-        DrawText("▼", 760, boxY + TEXT_BOX_HEIGHT - 30, 20, WHITE);
+        UIFont::drawText("▼", 760, boxY + TEXT_BOX_HEIGHT - 30, 20, WHITE);
     } else if (!m_showingChoices && !m_currentDialog->hasChoices()) {
-        DrawText("[SPACE to close]", 600, boxY + TEXT_BOX_HEIGHT - 30, 14, GRAY);
+        UIFont::drawText("[SPACE to close]", 600, boxY + TEXT_BOX_HEIGHT - 30, 14, GRAY);
     }
 }
 
@@ -169,40 +166,15 @@ void DialogScene::drawChoices() {
     int boxY = 600 - TEXT_BOX_HEIGHT;
     int choiceY = boxY + TEXT_BOX_HEIGHT - TEXT_BOX_PADDING - (choices.size() * LINE_HEIGHT);
 
-    DrawText("Choose:", TEXT_BOX_PADDING, choiceY - LINE_HEIGHT, 18, YELLOW);
+    UIFont::drawText("Choose:", TEXT_BOX_PADDING, choiceY - LINE_HEIGHT, 18, YELLOW);
 
     for (int i = 0; i < choices.size(); i++) {
         Color color = (i == m_choiceSelection) ? YELLOW : WHITE;
         const char* arrow = (i == m_choiceSelection) ? ">" : " ";
 
-        DrawText(arrow, TEXT_BOX_PADDING + CHOICE_INDENT, choiceY, 18, color);
-        DrawText(choices[i].text.c_str(), TEXT_BOX_PADDING + CHOICE_INDENT + 20, choiceY, 18, color);
+        UIFont::drawText(arrow, TEXT_BOX_PADDING + CHOICE_INDENT, choiceY, 18, color);
+        UIFont::drawText(choices[i].text.c_str(), TEXT_BOX_PADDING + CHOICE_INDENT + 20, choiceY, 18, color);
 
         choiceY += LINE_HEIGHT;
     }
 }
-
-std::vector<std::string> DialogScene::wrapText(const std::string& text, int maxWidth) {
-    std::vector<std::string> lines;
-    std::istringstream words(text);
-    std::string word;
-    std::string currentLine;
-
-    while (words >> word) {
-        std::string testLine = currentLine.empty() ? word : currentLine + " " + word;
-        int textWidth = MeasureText(testLine.c_str(), 18);
-
-        if (textWidth > maxWidth && !currentLine.empty()) {
-            lines.push_back(currentLine);
-            currentLine = word;
-        } else {
-            currentLine = testLine;
-        }
-    }
-
-    if (!currentLine.empty()) {
-        lines.push_back(currentLine);
-    }
-
-    return lines;
-}
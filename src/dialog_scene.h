@@ -2,6 +2,7 @@
 
 #include "scene.h"
 #include "dialog.h"
+#include "text_layout.h"
 #include <functional>
 #include <memory>
 #include <unordered_map>
@@ -32,9 +33,6 @@ private:
     void drawDialogLine();
     void drawChoices();
 
-    // Text wrapping helper
-    std::vector<std::string> wrapText(const std::string& text, int maxWidth);
-
     // Dialog state
     std::unordered_map<int, std::unique_ptr<Dialog>> m_dialogs;
     Dialog* m_currentDialog;
@@ -45,6 +43,9 @@ private:
     // Callback
     std::function<void()> m_returnCallback;
 
+    // Wrapped dialog lines, laid out once each
+    TextLayoutCache m_textLayouts;
+
     // Name
     std::string m_name = "dialog";
 
@@ -0,0 +1,33 @@
+#include "draw_stats.h"
+#include <raylib.h>
+#include <rlgl.h>
+
+int DrawStats::s_drawCalls = 0;
+int DrawStats::s_lastFrameDrawCalls = 0;
+unsigned int DrawStats::s_currentTexture = 0;
+
+void DrawStats::beginFrame() {
+    s_lastFrameDrawCalls = s_drawCalls;
+    s_drawCalls = 0;
+    s_currentTexture = 0;
+}
+
+void DrawStats::useTexture(unsigned int textureId) {
+    if (textureId != s_currentTexture) {
+        s_currentTexture = textureId;
+        s_drawCalls++;
+    }
+}
+
+void DrawStats::useShapes() {
+    useTexture(rlGetTextureIdDefault());
+}
+
+void DrawStats::useDefaultFont() {
+    useTexture(GetFontDefault().texture.id);
+}
+
+void DrawStats::directDraw() {
+    s_drawCalls++;
+    s_currentTexture = 0;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+// Per-frame estimate of the GPU draw calls raylib issues.
+// raylib's batcher merges consecutive quads that use the same texture into one call, so
+// the count only grows when a draw switches texture or bypasses the batch (vertex array
+// draws, render texture passes). Renderers report what they are about to draw; the
+// total for the previous frame is shown in the exploration debug overlay (F3).
+class DrawStats {
+public:
+    // Call once per frame before drawing
+    static void beginFrame();
+
+    // Before a batched draw with this texture (sprites, tiles, baked chunks)
+    static void useTexture(unsigned int textureId);
+    // Before DrawRectangle & co. / DrawText with the default font
+    static void useShapes();
+    static void useDefaultFont();
+    // A draw that flushes the batch and is a call of its own
+    static void directDraw();
+    // The batch was flushed without drawing anything new (render texture switch)
+    static void breakBatch() { s_currentTexture = 0; }
+
+    static int getLastFrameDrawCalls() { return s_lastFrameDrawCalls; }
+    static int getDrawCalls() { return s_drawCalls; } // So far this frame
+
+private:
+    static int s_drawCalls;
+    static int s_lastFrameDrawCalls;
+    static unsigned int s_currentTexture; // 0 = nothing batched yet
+};
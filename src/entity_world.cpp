@@ -0,0 +1,31 @@
+#include "entity_world.h"
+
+Entity EntityWorld::create() {
+    Entity entity;
+    if (!m_freeIds.empty()) {
+        entity = m_freeIds.back();
+        m_freeIds.pop_back();
+    } else {
+        entity = static_cast<Entity>(m_alive.size());
+        m_alive.push_back(false);
+    }
+    m_alive[entity] = true;
+    m_count++;
+    return entity;
+}
+
+void EntityWorld::destroy(Entity entity) {
+    if (!isAlive(entity)) {
+        return;
+    }
+    m_positions.remove(entity);
+    m_movements.remove(entity);
+    m_sprites.remove(entity);
+    m_interactions.remove(entity);
+    m_followers.remove(entity);
+    m_playerControls.remove(entity);
+
+    m_alive[entity] = false;
+    m_freeIds.push_back(entity);
+    m_count--;
+}
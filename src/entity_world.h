@@ -0,0 +1,154 @@
+#pragma once
+
+#include "pathfinder.h"
+#include "sprite.h"
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Exploration-world objects (the player, NPCs, ...) are plain ids with components
+// attached. Behaviour lives in WorldSystems, which walks the component arrays.
+using Entity = uint32_t;
+constexpr Entity INVALID_ENTITY = 0xFFFFFFFF;
+
+// Components of one type, packed in a dense array. A sparse per-entity index maps an
+// entity to its slot; removing swaps the last component into the hole, so iterating
+// size()/at(i) never touches a gap. Pointers and references into the array are only
+// good until the next add() or remove().
+template <typename T>
+class ComponentArray {
+public:
+    // Replaces the component if the entity already has one
+    T& add(Entity entity, T component) {
+        if (entity >= m_slots.size()) {
+            m_slots.resize(entity + 1, NO_SLOT);
+        }
+        if (m_slots[entity] != NO_SLOT) {
+            T& existing = m_components[m_slots[entity]];
+            existing = std::move(component);
+            return existing;
+        }
+        m_slots[entity] = static_cast<uint32_t>(m_components.size());
+        m_components.push_back(std::move(component));
+        m_entities.push_back(entity);
+        return m_components.back();
+    }
+
+    void remove(Entity entity) {
+        if (!has(entity)) {
+            return;
+        }
+        uint32_t slot = m_slots[entity];
+        uint32_t last = static_cast<uint32_t>(m_components.size()) - 1;
+        if (slot != last) {
+            m_components[slot] = std::move(m_components[last]);
+            m_entities[slot] = m_entities[last];
+            m_slots[m_entities[slot]] = slot;
+        }
+        m_components.pop_back();
+        m_entities.pop_back();
+        m_slots[entity] = NO_SLOT;
+    }
+
+    bool has(Entity entity) const { return entity < m_slots.size() && m_slots[entity] != NO_SLOT; }
+    // The entity must have the component
+    T& get(Entity entity) { return m_components[m_slots[entity]]; }
+    const T& get(Entity entity) const { return m_components[m_slots[entity]]; }
+    // Null if the entity doesn't have the component
+    T* find(Entity entity) { return has(entity) ? &m_components[m_slots[entity]] : nullptr; }
+    const T* find(Entity entity) const { return has(entity) ? &m_components[m_slots[entity]] : nullptr; }
+
+    // Dense iteration
+    size_t size() const { return m_components.size(); }
+    T& at(size_t index) { return m_components[index]; }
+    const T& at(size_t index) const { return m_components[index]; }
+    Entity getEntity(size_t index) const { return m_entities[index]; }
+
+private:
+    static constexpr uint32_t NO_SLOT = 0xFFFFFFFF;
+
+    std::vector<T> m_components;
+    std::vector<Entity> m_entities; // Owner of each component
+    std::vector<uint32_t> m_slots;  // Per entity
+};
+
+// Where an entity stands. The tile changes when a step ends; the pixel position follows
+// the step in between.
+struct Position {
+    int tileX = 0;
+    int tileY = 0;
+    int pixelX = 0;
+    int pixelY = 0;
+};
+
+// Tile-by-tile walking. A step holds both tiles in the OccupancyGrid until it ends.
+struct Movement {
+    float speed = 4.0f; // Tiles per second
+    bool moving = false;
+    int targetX = 0;
+    int targetY = 0;
+    float progress = 0.0f;
+};
+
+struct SpriteComponent {
+    Sprite sprite;
+    bool turns = false; // The sheet has a row per direction, so steps turn the sprite
+};
+
+enum class NPCType {
+    DIALOG,     // Triggers dialog
+    SHOP        // Triggers shop
+};
+
+// Something the player can talk to from an adjacent tile; its name is shown above it
+struct Interaction {
+    std::string name;
+    int dialogId = 0;
+    NPCType type = NPCType::DIALOG;
+};
+
+// Walks after the player over the shared flow field
+struct FollowAI {
+    bool followsPlayer = false; // Always, not only while everyone is gathered
+};
+
+// Keyboard, gamepad and click-to-move routes
+struct PlayerControl {
+    std::vector<TilePoint> path; // Route being followed, path[pathIndex] is next
+    size_t pathIndex = 0;
+};
+
+// Owns the entities and their component arrays.
+class EntityWorld {
+public:
+    Entity create();
+    // Drops every component; the id is reused by a later create()
+    void destroy(Entity entity);
+    bool isAlive(Entity entity) const { return entity < m_alive.size() && m_alive[entity]; }
+    int getEntityCount() const { return m_count; }
+
+    ComponentArray<Position>& getPositions() { return m_positions; }
+    ComponentArray<Movement>& getMovements() { return m_movements; }
+    ComponentArray<SpriteComponent>& getSprites() { return m_sprites; }
+    ComponentArray<Interaction>& getInteractions() { return m_interactions; }
+    ComponentArray<FollowAI>& getFollowers() { return m_followers; }
+    ComponentArray<PlayerControl>& getPlayerControls() { return m_playerControls; }
+
+    const ComponentArray<Position>& getPositions() const { return m_positions; }
+    const ComponentArray<Movement>& getMovements() const { return m_movements; }
+    const ComponentArray<SpriteComponent>& getSprites() const { return m_sprites; }
+    const ComponentArray<Interaction>& getInteractions() const { return m_interactions; }
+
+private:
+    ComponentArray<Position> m_positions;
+    ComponentArray<Movement> m_movements;
+    ComponentArray<SpriteComponent> m_sprites;
+    ComponentArray<Interaction> m_interactions;
+    ComponentArray<FollowAI> m_followers;
+    ComponentArray<PlayerControl> m_playerControls;
+
+    std::vector<bool> m_alive;
+    std::vector<Entity> m_freeIds;
+    int m_count = 0;
+};
@@ -3,11 +3,17 @@
 #include "dialog_scene.h"
 #include "enemy.h"
 #include "enemy_formation.h"
+#include "draw_stats.h"
+#include "texture_cache.h"
+#include "ui_font.h"
 #include <raylib.h>
+#include <algorithm>
+#include <cstdio>
 
 ExplorationScene::ExplorationScene(int screenWidth, int screenHeight, int tileSize, int mapWidth, int mapHeight,
-                                   SceneManager* sceneManager, Party* party)
+                                   SceneManager* sceneManager, Party* party, const TextureAtlas* atlas)
     : m_name("exploration")
+    , m_player(INVALID_ENTITY)
     , m_screenWidth(screenWidth)
     , m_screenHeight(screenHeight)
     , m_tileSize(tileSize)
@@ -15,19 +21,76 @@ ExplorationScene::ExplorationScene(int screenWidth, int screenHeight, int tileSi
     , m_mapHeight(mapHeight)
     , m_sceneManager(sceneManager)
     , m_party(party)
+    , m_atlas(atlas)
+    , m_lastPlayerTileX(-1)
+    , m_lastPlayerTileY(-1)
+    , m_playerPath(INVALID_PATH_HANDLE)
+    , m_showDebugOverlay(false)
+    , m_showWorldMap(false)
+    , m_gatherNPCs(false)
+    , m_worldMapZoom(4.0f)
 {
-    m_tilemap = std::make_unique<Tilemap>(mapWidth, mapHeight, tileSize);
+    // Prefer the cooked map file, with its chunks streamed in around the player;
+    // fall back to the built-in test layout
+    m_tilemap = Tilemap::loadFromFile(MAP_PATH, MapLoadMode::STREAMED);
+    bool mapLoaded = m_tilemap != nullptr;
+    if (mapLoaded) {
+        m_mapWidth = m_tilemap->getWidth();
+        m_mapHeight = m_tilemap->getHeight();
+        m_streamer = std::make_unique<ChunkStreamer>(*m_tilemap, MAP_PATH);
+    } else {
+        m_tilemap = std::make_unique<Tilemap>(mapWidth, mapHeight, tileSize);
+    }
+
+    // Cooked maps carry their own tile flags; the built-in layout uses the tileset's
+    // property file (or the defaults if it is missing)
+    if (!mapLoaded) {
+        TileProperties tileProperties;
+        tileProperties.loadFromFile(TILE_PROPERTIES_PATH);
+        m_tilemap->setTileProperties(tileProperties);
+    }
+
+    // Water and other animated tiles; the map works without them
+    TileAnimations tileAnimations;
+    if (tileAnimations.loadFromFile(TILE_ANIMATIONS_PATH)) {
+        m_tilemap->setTileAnimations(tileAnimations);
+    }
 
-    // Load tileset if it exists (8 tiles per row is a reasonable default for a small tileset)
-    m_tilemap->loadTileset("assets/tileset.png", 8);
+    // Use the tileset from the atlas, or load it if it exists (8 tiles per row is a
+    // reasonable default for a small tileset)
+    if (!m_atlas || !m_tilemap->setTileset(*m_atlas, "tileset", 8)) {
+        m_tilemap->loadTileset("assets/tileset.png", 8);
+    }
+
+    // Walk cycles; without them sprites show their standing frame
+    m_spriteAnimations.loadFromFile(SPRITE_ANIMATIONS_PATH);
+    m_animations = std::make_unique<AnimationSystem>(m_spriteAnimations);
 
     // Load player sprite if it exists
-    m_player = std::make_unique<Player>(mapWidth / 2, mapHeight / 2, tileSize, "assets/player.png");
+    m_systems = std::make_unique<WorldSystems>(m_world, *m_tilemap, tileSize);
+    m_player = m_systems->spawnPlayer(m_mapWidth / 2, m_mapHeight / 2, "assets/player.png", m_atlas);
+    m_world.getSprites().get(m_player).sprite.setAnimations(m_animations.get(), "player");
 
-    m_camera = std::make_unique<GameCamera>(screenWidth, screenHeight, mapWidth, mapHeight, tileSize);
+    m_camera = std::make_unique<GameCamera>(screenWidth, screenHeight, m_mapWidth, m_mapHeight, tileSize);
 
-    initializeMap();
+    if (!mapLoaded) {
+        initializeMap();
+        m_tilemap->compact();
+    }
     initializeNPCs();
+
+    // Load the chunks around the start position before the first frame
+    if (m_streamer) {
+        m_streamer->update(getPlayerPosition().tileX, getPlayerPosition().tileY, 0, 0);
+        m_streamer->flush();
+    }
+
+    m_overview = std::make_unique<MapOverview>(*m_tilemap);
+    m_pathQueries = std::make_unique<PathQueryQueue>(*m_tilemap);
+    m_flowFields = std::make_unique<FlowFieldCache>(*m_tilemap);
+
+    m_lastPlayerTileX = getPlayerPosition().tileX;
+    m_lastPlayerTileY = getPlayerPosition().tileY;
 }
 
 void ExplorationScene::onEnter() {
@@ -41,21 +104,62 @@ void ExplorationScene::onExit() {
 }
 
 void ExplorationScene::update(float deltaTime) {
-    // Handle input and update player
-    m_player->handleInput(*m_tilemap);
-    m_player->update(deltaTime);
+    // Routes solved during the last frame
+    m_pathQueries->beginFrame();
+
+    // The world map pauses exploration; TAB closes it again
+    if (m_showWorldMap) {
+        if (IsKeyPressed(KEY_TAB) || IsKeyPressed(KEY_ESCAPE)) {
+            m_showWorldMap = false;
+        }
+        if (IsKeyPressed(KEY_EQUAL)) {
+            m_worldMapZoom = std::min(m_worldMapZoom * 2.0f, MAX_WORLD_MAP_ZOOM);
+        }
+        if (IsKeyPressed(KEY_MINUS)) {
+            m_worldMapZoom = std::max(m_worldMapZoom * 0.5f, MIN_WORLD_MAP_ZOOM);
+        }
+        m_overview->update();
+        return;
+    }
+
+    // Handle input, then move everyone; followers head for where the player stands
+    updateClickToMove();
+    m_systems->updatePlayerControl();
+    m_systems->updateFollowers(*m_flowFields, {getPlayerPosition().tileX, getPlayerPosition().tileY}, m_gatherNPCs);
+    m_systems->updateMovement(deltaTime);
+    m_animations->update(deltaTime);
+    m_tilemap->updateAnimations(deltaTime);
+
+    // Stream chunks around the player, prefetching in the walking direction
+    const Position& player = getPlayerPosition();
+    if (m_streamer) {
+        m_streamer->update(player.tileX, player.tileY,
+                           m_systems->getMoveDirectionX(m_player), m_systems->getMoveDirectionY(m_player));
+    }
 
     // Update camera to follow player
     m_camera->followPlayer(
-        m_player->getPixelX(),
-        m_player->getPixelY(),
+        player.pixelX,
+        player.pixelY,
         m_tileSize,
         m_tileSize
     );
 
+    // Trigger objects fire when the player steps onto a new tile
+    if (player.tileX != m_lastPlayerTileX || player.tileY != m_lastPlayerTileY) {
+        m_lastPlayerTileX = player.tileX;
+        m_lastPlayerTileY = player.tileY;
+        if (checkTriggers()) {
+            return;
+        }
+    }
+
     // Check for NPC interaction
     checkNPCInteraction();
 
+    // Pick up tile edits (and streamed chunks) on the minimap
+    m_overview->update();
+
     // Press B to trigger a battle (for testing)
     if (IsKeyPressed(KEY_B)) {
         startBattle();
@@ -66,6 +170,21 @@ void ExplorationScene::update(float deltaTime) {
         startDialog();
     }
 
+    // Press G to have every NPC follow the player (for testing)
+    if (IsKeyPressed(KEY_G)) {
+        m_gatherNPCs = !m_gatherNPCs;
+    }
+
+    // Press TAB for the world map
+    if (IsKeyPressed(KEY_TAB)) {
+        m_showWorldMap = true;
+    }
+
+    // Press F3 to toggle map stats
+    if (IsKeyPressed(KEY_F3)) {
+        m_showDebugOverlay = !m_showDebugOverlay;
+    }
+
     // Press ESC or M to open menu
     if (IsKeyPressed(KEY_ESCAPE) || IsKeyPressed(KEY_M)) {
         m_sceneManager->changeState(GameState::MENU);
@@ -77,21 +196,140 @@ void ExplorationScene::draw() {
     int camX = m_camera->getOffsetX();
     int camY = m_camera->getOffsetY();
 
-    m_tilemap->render(camX, camY);
+    int viewWidth = m_camera->getViewWidth();
+    int viewHeight = m_camera->getViewHeight();
 
-    // Draw NPCs
-    for (const auto& npc : m_npcs) {
-        npc->render(camX, camY);
-    }
+    m_tilemap->render(camX, camY, viewWidth, viewHeight);
 
-    m_player->render(camX, camY);
+    // Entities on screen, padded by a tile for the ones stepping in or out and the labels
+    // above them
+    const std::vector<int>& visible = m_systems->query(camX / m_tileSize - 1, camY / m_tileSize - 1,
+                                                       viewWidth / m_tileSize + 3, viewHeight / m_tileSize + 3);
+
+    // All sprites go through one batch: drawn back to front by where their feet are,
+    // grouped by texture within a row. Then all name labels.
+    m_spriteBatch.begin();
+    m_systems->queueSprites(m_spriteBatch, visible, camX, camY);
+    m_spriteBatch.draw();
+    m_systems->drawLabels(visible, camX, camY);
+
+    // Roofs, tree tops etc. go over the player and NPCs
+    m_tilemap->renderOverlay(camX, camY, viewWidth, viewHeight);
+
+    drawMinimap();
 
     // Draw exploration UI
-    DrawText("Exploration Mode", 10, 10, 20, WHITE);
-    DrawText("WASD/Arrows to move", 10, 35, 16, LIGHTGRAY);
-    DrawText("Press SPACE near NPCs to talk", 10, 55, 16, LIGHTGRAY);
-    DrawText("Press B for battle (test)", 10, 75, 16, LIGHTGRAY);
-    DrawText("Press ESC/M for menu", 10, 95, 16, LIGHTGRAY);
+    UIFont::drawText("Exploration Mode", 10, 10, 20, WHITE);
+    UIFont::drawText("WASD/Arrows or click to move", 10, 35, 16, LIGHTGRAY);
+    UIFont::drawText("Press SPACE near NPCs to talk", 10, 55, 16, LIGHTGRAY);
+    UIFont::drawText("Press B for battle (test)", 10, 75, 16, LIGHTGRAY);
+    UIFont::drawText("Press ESC/M for menu", 10, 95, 16, LIGHTGRAY);
+    UIFont::drawText("Press TAB for the world map", 10, 115, 16, LIGHTGRAY);
+    UIFont::drawText("Press G to gather NPCs (test)", 10, 135, 16, LIGHTGRAY);
+
+    if (m_showWorldMap) {
+        drawWorldMap();
+    }
+
+    if (m_showDebugOverlay) {
+        drawDebugOverlay();
+    }
+}
+
+void ExplorationScene::updateClickToMove() {
+    if (m_playerPath != INVALID_PATH_HANDLE && m_pathQueries->getStatus(m_playerPath) != PathStatus::PENDING) {
+        std::vector<TilePoint> path;
+        if (m_pathQueries->takePath(m_playerPath, path)) {
+            m_systems->followPath(m_player, std::move(path));
+        }
+        m_playerPath = INVALID_PATH_HANDLE;
+    }
+
+    if (!IsMouseButtonPressed(MOUSE_BUTTON_LEFT)) {
+        return;
+    }
+    Vector2 mouse = GetMousePosition();
+    TilePoint goal = {
+        (static_cast<int>(mouse.x) + m_camera->getOffsetX()) / m_tileSize,
+        (static_cast<int>(mouse.y) + m_camera->getOffsetY()) / m_tileSize
+    };
+    // Route from where the current step ends; the old route stops when this one arrives
+    TilePoint start = {
+        getPlayerPosition().tileX + m_systems->getMoveDirectionX(m_player),
+        getPlayerPosition().tileY + m_systems->getMoveDirectionY(m_player)
+    };
+    m_pathQueries->cancel(m_playerPath);
+    m_playerPath = m_pathQueries->request(start, goal);
+}
+
+void ExplorationScene::drawMinimap() {
+    // Whole map in the bottom-right corner, keeping its aspect ratio
+    float scale = static_cast<float>(MINIMAP_SIZE) / std::max(m_mapWidth, m_mapHeight);
+    Rectangle dest = {0.0f, 0.0f, m_mapWidth * scale, m_mapHeight * scale};
+    dest.x = m_screenWidth - dest.width - 10.0f;
+    dest.y = m_screenHeight - dest.height - 10.0f;
+
+    DrawRectangleLinesEx({dest.x - 2.0f, dest.y - 2.0f, dest.width + 4.0f, dest.height + 4.0f}, 2.0f, Fade(BLACK, 0.8f));
+    m_overview->drawWholeMap(dest);
+
+    float markerSize = std::max(3.0f, scale);
+    DrawRectangleRec({dest.x + getPlayerPosition().tileX * scale, dest.y + getPlayerPosition().tileY * scale,
+                      markerSize, markerSize}, RED);
+}
+
+void ExplorationScene::drawWorldMap() {
+    // Centered on the player at the current zoom; the overview picks the matching level
+    float tilesWide = m_screenWidth / m_worldMapZoom;
+    float tilesHigh = m_screenHeight / m_worldMapZoom;
+    Rectangle tileRect = {
+        getPlayerPosition().tileX + 0.5f - tilesWide / 2.0f,
+        getPlayerPosition().tileY + 0.5f - tilesHigh / 2.0f,
+        tilesWide,
+        tilesHigh
+    };
+
+    DrawRectangle(0, 0, m_screenWidth, m_screenHeight, BLACK);
+    m_overview->draw(tileRect, {0.0f, 0.0f, static_cast<float>(m_screenWidth), static_cast<float>(m_screenHeight)});
+
+    float markerSize = std::max(4.0f, m_worldMapZoom);
+    DrawRectangleRec({(getPlayerPosition().tileX - tileRect.x) * m_worldMapZoom,
+                      (getPlayerPosition().tileY - tileRect.y) * m_worldMapZoom, markerSize, markerSize}, RED);
+
+    char caption[64];
+    snprintf(caption, sizeof(caption), "World map  %.2fx  (+/- zoom, TAB close)", m_worldMapZoom);
+    UIFont::drawText(caption, 10, m_screenHeight - 30, 20, WHITE);
+}
+
+void ExplorationScene::drawDebugOverlay() {
+    constexpr int LINE_COUNT = 8;
+    char lines[LINE_COUNT][64];
+    snprintf(lines[0], sizeof(lines[0]), "Map: %dx%d", m_tilemap->getWidth(), m_tilemap->getHeight());
+    snprintf(lines[1], sizeof(lines[1]), "Tiles: %.3f bytes/tile (%zu KB)",
+             m_tilemap->getBytesPerTile(), m_tilemap->getTileMemoryUsage() / 1024);
+    snprintf(lines[2], sizeof(lines[2]), "Resident chunks: %d", m_tilemap->getResidentChunkCount());
+    snprintf(lines[3], sizeof(lines[3]), "Draw calls: %d (map %d, %d sprites)",
+             DrawStats::getLastFrameDrawCalls(), m_tilemap->getLastDrawCallCount(), m_spriteBatch.getSpriteCount());
+    if (m_streamer) {
+        snprintf(lines[4], sizeof(lines[4]), "Streamed: %d chunks (%zu KB), %d pending",
+                 m_streamer->getResidentChunkCount(), m_streamer->getResidentBytes() / 1024,
+                 m_streamer->getPendingCount());
+    } else {
+        snprintf(lines[4], sizeof(lines[4]), "Streamed: off");
+    }
+
+    snprintf(lines[5], sizeof(lines[5]), "Paths: %d pending, %d delivered",
+             m_pathQueries->getPendingCount(), m_pathQueries->getLastDeliveredCount());
+    snprintf(lines[6], sizeof(lines[6]), "Textures: %d (%zu KB), %d hits, %d misses",
+             TextureCache::getResidentCount(), TextureCache::getResidentBytes() / 1024,
+             TextureCache::getHitCount(), TextureCache::getMissCount());
+    snprintf(lines[7], sizeof(lines[7]), "Glyphs: %d resident, %d rasterized, %d evicted",
+             UIFont::getResidentCount(), UIFont::getRasterizedCount(), UIFont::getEvictionCount());
+
+    int x = m_screenWidth - 260;
+    DrawRectangle(x - 10, 5, 265, 10 + LINE_COUNT * 20, Fade(BLACK, 0.6f));
+    for (int i = 0; i < LINE_COUNT; i++) {
+        UIFont::drawText(lines[i], x, 10 + i * 20, 16, GREEN);
+    }
 }
 
 void ExplorationScene::initializeMap() {
@@ -164,48 +402,86 @@ void ExplorationScene::startDialog() {
 }
 
 void ExplorationScene::initializeNPCs() {
+    // Maps authored in Tiled place NPCs as "npc" objects:
+    //   dialog (int) dialog ID, shop (bool) opens the shop, sprite (string) image path,
+    //   follow (string) "player" to walk after the player
+    for (const MapObject& object : m_tilemap->getObjects()) {
+        if (object.type != "npc") {
+            continue;
+        }
+        NPCType type = object.getProperty("shop") == "true" ? NPCType::SHOP : NPCType::DIALOG;
+        Entity npc = m_systems->spawnNPC(object.name, object.x, object.y, object.getIntProperty("dialog"),
+                                         type, object.getProperty("sprite"), m_atlas);
+        m_world.getFollowers().get(npc).followsPlayer = object.getProperty("follow") == "player";
+    }
+    if (m_world.getInteractions().size() > 0) {
+        return;
+    }
+
     // Create test NPCs at various locations on the map
     // NPCs use single 32x32 pixel sprites (not animated sprite sheets)
 
     // NPC 1: Friendly villager near the center
-    m_npcs.push_back(std::make_unique<NPC>("Villager", 10, 8, 1, m_tileSize, NPCType::DIALOG, "assets/villager.png"));
+    m_systems->spawnNPC("Villager", 10, 8, 1, NPCType::DIALOG, "assets/villager.png", m_atlas);
 
     // NPC 2: Guard near a wall
-    m_npcs.push_back(std::make_unique<NPC>("Guard", 18, 12, 2, m_tileSize, NPCType::DIALOG, "assets/guard.png"));
+    m_systems->spawnNPC("Guard", 18, 12, 2, NPCType::DIALOG, "assets/guard.png", m_atlas);
 
     // NPC 3: Merchant in another area (triggers shop)
-    m_npcs.push_back(std::make_unique<NPC>("Merchant", 7, 14, 3, m_tileSize, NPCType::SHOP, "assets/merchant.png"));
+    m_systems->spawnNPC("Merchant", 7, 14, 3, NPCType::SHOP, "assets/merchant.png", m_atlas);
+}
+
+bool ExplorationScene::checkTriggers() {
+    // "trigger" objects: dialog (int) starts that dialog, battle (bool) starts a test battle
+    for (const MapObject& object : m_tilemap->getObjects()) {
+        if (object.type != "trigger" || !object.contains(m_lastPlayerTileX, m_lastPlayerTileY)) {
+            continue;
+        }
+
+        if (object.getProperty("battle") == "true") {
+            startBattle();
+            return true;
+        }
+
+        int dialogId = object.getIntProperty("dialog", -1);
+        DialogScene* dialogScene = static_cast<DialogScene*>(
+            m_sceneManager->getScene(GameState::DIALOG));
+        if (dialogId >= 0 && dialogScene) {
+            dialogScene->startDialog(dialogId);
+            m_sceneManager->changeState(GameState::DIALOG);
+            return true;
+        }
+    }
+    return false;
 }
 
 void ExplorationScene::checkNPCInteraction() {
     // Check if player presses SPACE or ENTER to interact
-    if (IsKeyPressed(KEY_SPACE) || IsKeyPressed(KEY_ENTER)) {
-        int playerTileX = m_player->getTileX();
-        int playerTileY = m_player->getTileY();
-
-        // Check all NPCs to see if player is adjacent
-        for (const auto& npc : m_npcs) {
-            if (npc->isPlayerAdjacent(playerTileX, playerTileY)) {
-                if (npc->getType() == NPCType::SHOP) {
-                    // Transition to shop
-                    m_sceneManager->changeState(GameState::SHOP);
-                } else {
-                    // Get dialog scene
-                    DialogScene* dialogScene = static_cast<DialogScene*>(
-                        m_sceneManager->getScene(GameState::DIALOG));
-
-                    if (dialogScene) {
-                        // Start dialog with this NPC's dialog ID
-                        dialogScene->startDialog(npc->getDialogId());
-
-                        // Transition to dialog
-                        m_sceneManager->changeState(GameState::DIALOG);
-                    }
-                }
-
-                // Only interact with one NPC at a time
-                return;
-            }
-        }
+    if (!IsKeyPressed(KEY_SPACE) && !IsKeyPressed(KEY_ENTER)) {
+        return;
+    }
+
+    // Only interact with one NPC at a time
+    Entity npc = m_systems->findInteraction(getPlayerPosition().tileX, getPlayerPosition().tileY);
+    if (npc == INVALID_ENTITY) {
+        return;
+    }
+    const Interaction& interaction = m_world.getInteractions().get(npc);
+    if (interaction.type == NPCType::SHOP) {
+        // Transition to shop
+        m_sceneManager->changeState(GameState::SHOP);
+        return;
+    }
+
+    // Get dialog scene
+    DialogScene* dialogScene = static_cast<DialogScene*>(
+        m_sceneManager->getScene(GameState::DIALOG));
+
+    if (dialogScene) {
+        // Start dialog with this NPC's dialog ID
+        dialogScene->startDialog(interaction.dialogId);
+
+        // Transition to dialog
+        m_sceneManager->changeState(GameState::DIALOG);
     }
 }
@@ -2,18 +2,24 @@
 
 #include "scene.h"
 #include "tilemap.h"
-#include "player.h"
+#include "chunk_streamer.h"
+#include "flow_field.h"
+#include "map_overview.h"
+#include "path_query_queue.h"
 #include "camera.h"
 #include "scene_manager.h"
+#include "sprite_animation.h"
+#include "sprite_batch.h"
 #include "party.h"
-#include "npc.h"
+#include "entity_world.h"
+#include "world_systems.h"
 #include <memory>
 #include <vector>
 
 class ExplorationScene : public Scene {
 public:
     ExplorationScene(int screenWidth, int screenHeight, int tileSize, int mapWidth, int mapHeight,
-                     SceneManager* sceneManager, Party* party);
+                     SceneManager* sceneManager, Party* party, const TextureAtlas* atlas = nullptr);
     ~ExplorationScene() override = default;
 
     void onEnter() override;
@@ -23,7 +29,8 @@ public:
     const std::string& getName() const override { return m_name; }
 
     // Accessors for external systems that may need to interact with exploration
-    Player* getPlayer() { return m_player.get(); }
+    Entity getPlayer() const { return m_player; }
+    EntityWorld& getWorld() { return m_world; }
     Tilemap* getTilemap() { return m_tilemap.get(); }
 
 private:
@@ -32,12 +39,26 @@ private:
     void startBattle();
     void startDialog();
     void checkNPCInteraction();
+    const Position& getPlayerPosition() const { return m_world.getPositions().get(m_player); }
+    void updateClickToMove();
+    bool checkTriggers(); // Returns true if a trigger changed the scene
+    void drawDebugOverlay();
+    void drawMinimap();
+    void drawWorldMap();
 
     std::string m_name;
     std::unique_ptr<Tilemap> m_tilemap;
-    std::unique_ptr<Player> m_player;
+    std::unique_ptr<ChunkStreamer> m_streamer; // Null for the built-in map; declared after m_tilemap so it goes first
+    std::unique_ptr<MapOverview> m_overview;   // Minimap / world map picture of m_tilemap
+    std::unique_ptr<PathQueryQueue> m_pathQueries;
+    std::unique_ptr<FlowFieldCache> m_flowFields; // Crowds walking to a shared goal
+    AnimationLibrary m_spriteAnimations;
+    std::unique_ptr<AnimationSystem> m_animations; // Declared before the sprites that use it
+    EntityWorld m_world;                   // The player, NPCs and whatever else walks the map
+    std::unique_ptr<WorldSystems> m_systems;
+    Entity m_player;
     std::unique_ptr<GameCamera> m_camera;
-    std::vector<std::unique_ptr<NPC>> m_npcs;
+    SpriteBatch m_spriteBatch; // Player and NPC sprites, sorted by foot Y each frame
 
     int m_screenWidth;
     int m_screenHeight;
@@ -48,4 +69,25 @@ private:
     // Non-owning pointers to game systems
     SceneManager* m_sceneManager;
     Party* m_party;
+    const TextureAtlas* m_atlas; // Shared sprite/tileset atlas, may be null
+
+    // Player tile on the last update, triggers fire when it changes
+    int m_lastPlayerTileX;
+    int m_lastPlayerTileY;
+
+    PathHandle m_playerPath; // Click-to-move route being solved
+
+    bool m_showDebugOverlay; // F3: tile memory and render stats
+    bool m_showWorldMap;     // TAB: full-screen world map
+    bool m_gatherNPCs;       // G: every NPC follows the player (crowd test)
+    float m_worldMapZoom;    // Screen pixels per tile on the world map
+
+    static constexpr int MINIMAP_SIZE = 160; // Longer side in pixels
+    static constexpr float MIN_WORLD_MAP_ZOOM = 0.25f;
+    static constexpr float MAX_WORLD_MAP_ZOOM = 16.0f;
+
+    static constexpr const char* MAP_PATH = "assets/maps/town.jmap";
+    static constexpr const char* TILE_PROPERTIES_PATH = "assets/tile_properties.txt";
+    static constexpr const char* TILE_ANIMATIONS_PATH = "assets/tile_animations.txt";
+    static constexpr const char* SPRITE_ANIMATIONS_PATH = "assets/sprite_animations.txt";
 };
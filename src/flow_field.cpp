@@ -0,0 +1,129 @@
+#include "flow_field.h"
+#include "tilemap.h"
+#include <algorithm>
+
+FlowField::FlowField(const Tilemap& tilemap, TilePoint goal, int radius)
+    : m_tilemap(tilemap)
+    , m_goal(goal)
+    , m_radius(std::min(std::max(radius, 0), MAX_RADIUS))
+    , m_x0(std::clamp(goal.x - m_radius, 0, tilemap.getWidth()))
+    , m_y0(std::clamp(goal.y - m_radius, 0, tilemap.getHeight()))
+    , m_x1(std::min(tilemap.getWidth(), goal.x + m_radius + 1))
+    , m_y1(std::min(tilemap.getHeight(), goal.y + m_radius + 1))
+    , m_reachableCount(0) {
+    // A goal too far off the map gives an empty field that watches no chunks
+    m_x1 = std::max(m_x0, m_x1);
+    m_y1 = std::max(m_y0, m_y1);
+    if (m_x0 == m_x1 || m_y0 == m_y1) {
+        m_x1 = m_x0;
+        m_y1 = m_y0;
+    }
+    m_chunkX0 = m_x0 / TileChunk::SIZE;
+    m_chunkY0 = m_y0 / TileChunk::SIZE;
+    m_chunkX1 = m_x1 > m_x0 ? (m_x1 + TileChunk::SIZE - 1) / TileChunk::SIZE : m_chunkX0;
+    m_chunkY1 = m_y1 > m_y0 ? (m_y1 + TileChunk::SIZE - 1) / TileChunk::SIZE : m_chunkY0;
+    build();
+}
+
+void FlowField::build() {
+    size_t tileCount = static_cast<size_t>(m_x1 - m_x0) * (m_y1 - m_y0);
+    m_directions.assign(tileCount, NO_STEP);
+    m_distances.assign(tileCount, UNREACHABLE);
+    m_reachableCount = 0;
+
+    const std::vector<uint32_t>& revisions = m_tilemap.getCollisionRevisions();
+    m_chunkRevisions.clear();
+    for (int cy = m_chunkY0; cy < m_chunkY1; cy++) {
+        for (int cx = m_chunkX0; cx < m_chunkX1; cx++) {
+            m_chunkRevisions.push_back(revisions[static_cast<size_t>(cy) * m_tilemap.getChunksX() + cx]);
+        }
+    }
+
+    if (!contains(m_goal.x, m_goal.y) || !m_tilemap.isWalkable(m_goal.x, m_goal.y)) {
+        return;
+    }
+
+    // Unit costs, so breadth-first order is distance order. A tile's step points back
+    // at the tile it was reached from.
+    int width = m_x1 - m_x0;
+    m_queue.clear();
+    size_t goalIndex = getIndex(m_goal.x, m_goal.y);
+    m_directions[goalIndex] = AT_GOAL;
+    m_distances[goalIndex] = 0;
+    m_queue.push_back(static_cast<int>(goalIndex));
+
+    const CollisionBitmap& collision = m_tilemap.getCollision();
+    for (size_t head = 0; head < m_queue.size(); head++) {
+        int index = m_queue[head];
+        int x = m_x0 + index % width;
+        int y = m_y0 + index / width;
+        uint16_t nextDistance = static_cast<uint16_t>(m_distances[index] + 1);
+        for (int direction = 0; direction < 4; direction++) {
+            int nx = x + STEP_X[direction];
+            int ny = y + STEP_Y[direction];
+            if (!contains(nx, ny) || collision.test(nx, ny)) {
+                continue;
+            }
+            size_t next = getIndex(nx, ny);
+            if (m_distances[next] != UNREACHABLE) {
+                continue;
+            }
+            m_distances[next] = nextDistance;
+            // Reached by stepping this way from (x, y), so it steps back the other way
+            m_directions[next] = static_cast<uint8_t>(direction ^ 1);
+            m_queue.push_back(static_cast<int>(next));
+        }
+    }
+    m_reachableCount = static_cast<int>(m_queue.size());
+}
+
+bool FlowField::isCurrent() const {
+    const std::vector<uint32_t>& revisions = m_tilemap.getCollisionRevisions();
+    size_t i = 0;
+    for (int cy = m_chunkY0; cy < m_chunkY1; cy++) {
+        for (int cx = m_chunkX0; cx < m_chunkX1; cx++) {
+            if (revisions[static_cast<size_t>(cy) * m_tilemap.getChunksX() + cx] != m_chunkRevisions[i++]) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+FlowFieldCache::FlowFieldCache(const Tilemap& tilemap, int maxFields)
+    : m_tilemap(tilemap)
+    , m_maxFields(std::max(1, maxFields))
+    , m_useCounter(0)
+    , m_builds(0)
+    , m_hits(0) {
+}
+
+const FlowField& FlowFieldCache::get(TilePoint goal, int radius) {
+    m_useCounter++;
+    radius = std::min(std::max(radius, 0), FlowField::MAX_RADIUS);
+    for (Entry& entry : m_fields) {
+        if (entry.field->getGoal() == goal && entry.field->getRadius() == radius) {
+            entry.lastUse = m_useCounter;
+            if (entry.field->isCurrent()) {
+                m_hits++;
+            } else {
+                entry.field->build();
+                m_builds++;
+            }
+            return *entry.field;
+        }
+    }
+
+    if (static_cast<int>(m_fields.size()) >= m_maxFields) {
+        auto oldest = std::min_element(m_fields.begin(), m_fields.end(),
+                                       [](const Entry& a, const Entry& b) { return a.lastUse < b.lastUse; });
+        m_fields.erase(oldest);
+    }
+    m_fields.push_back({std::make_unique<FlowField>(m_tilemap, goal, radius), m_useCounter});
+    m_builds++;
+    return *m_fields.back().field;
+}
+
+void FlowFieldCache::clear() {
+    m_fields.clear();
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "pathfinder.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Every tile's next step toward one goal, for crowds heading to the same place.
+//
+// Built with one breadth-first search out from the goal, so an agent anywhere in the
+// field moves with a single lookup instead of its own A*. The field covers the square
+// of the given radius around the goal (routes that would leave it are not found), and
+// remembers the collision revisions of the chunks under it to tell when it went stale.
+class FlowField {
+public:
+    static constexpr int DEFAULT_RADIUS = 64;
+    static constexpr int MAX_RADIUS = 127; // Keeps every distance inside 16 bits
+
+    // The tilemap must outlive the field. The radius is clamped to MAX_RADIUS.
+    FlowField(const Tilemap& tilemap, TilePoint goal, int radius = DEFAULT_RADIUS);
+
+    // Redoes the search over the current collision
+    void build();
+
+    // Step (dx, dy) toward the goal. False at the goal, outside the field or where the
+    // goal can't be reached.
+    bool getStep(int x, int y, int& dx, int& dy) const {
+        if (!contains(x, y)) {
+            return false;
+        }
+        uint8_t direction = m_directions[getIndex(x, y)];
+        if (direction >= 4) {
+            return false;
+        }
+        dx = STEP_X[direction];
+        dy = STEP_Y[direction];
+        return true;
+    }
+
+    // Steps to the goal, or -1 outside the field / unreachable
+    int getDistance(int x, int y) const {
+        if (!contains(x, y)) {
+            return -1;
+        }
+        uint16_t distance = m_distances[getIndex(x, y)];
+        return distance == UNREACHABLE ? -1 : distance;
+    }
+
+    bool contains(int x, int y) const { return x >= m_x0 && y >= m_y0 && x < m_x1 && y < m_y1; }
+
+    // False once walkability changed anywhere under the field
+    bool isCurrent() const;
+
+    TilePoint getGoal() const { return m_goal; }
+    int getRadius() const { return m_radius; }
+    int getReachableCount() const { return m_reachableCount; }
+
+private:
+    static constexpr uint16_t UNREACHABLE = 0xFFFF;
+    static constexpr uint8_t AT_GOAL = 4;
+    static constexpr uint8_t NO_STEP = 5;
+    static constexpr int STEP_X[4] = {1, -1, 0, 0};
+    static constexpr int STEP_Y[4] = {0, 0, 1, -1};
+
+    size_t getIndex(int x, int y) const {
+        return static_cast<size_t>(y - m_y0) * (m_x1 - m_x0) + (x - m_x0);
+    }
+
+    const Tilemap& m_tilemap;
+    TilePoint m_goal;
+    int m_radius;
+    int m_x0, m_y0, m_x1, m_y1; // Covered tiles, clamped to the map
+
+    std::vector<uint8_t> m_directions; // STEP_X/Y index, AT_GOAL or NO_STEP
+    std::vector<uint16_t> m_distances;
+    std::vector<int> m_queue;
+    int m_reachableCount;
+
+    // Chunks under the field and their collision revisions at build time
+    int m_chunkX0, m_chunkY0, m_chunkX1, m_chunkY1;
+    std::vector<uint32_t> m_chunkRevisions;
+};
+
+// Flow fields by goal. get() hands back the cached field while the collision under it is
+// unchanged and rebuilds it otherwise; the least recently used field goes when full.
+class FlowFieldCache {
+public:
+    static constexpr int DEFAULT_MAX_FIELDS = 16;
+
+    // The tilemap must outlive the cache
+    explicit FlowFieldCache(const Tilemap& tilemap, int maxFields = DEFAULT_MAX_FIELDS);
+
+    // Valid until the next get() or clear()
+    const FlowField& get(TilePoint goal, int radius = FlowField::DEFAULT_RADIUS);
+    void clear();
+
+    int getFieldCount() const { return static_cast<int>(m_fields.size()); }
+    int getBuildCount() const { return m_builds; } // Since creation
+    int getHitCount() const { return m_hits; }
+
+private:
+    struct Entry {
+        std::unique_ptr<FlowField> field;
+        uint64_t lastUse;
+    };
+
+    const Tilemap& m_tilemap;
+    int m_maxFields;
+    std::vector<Entry> m_fields;
+    uint64_t m_useCounter;
+    int m_builds;
+    int m_hits;
+};
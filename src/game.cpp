@@ -10,6 +10,8 @@
 #include "equipment.h"
 #include "skill.h"
 #include "shop.h"
+#include "draw_stats.h"
+#include "ui_font.h"
 
 Game::Game() : m_running(true) {
     InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "JRPG Game");
@@ -18,6 +20,14 @@ Game::Game() : m_running(true) {
     // Disable ESC key to close window (we use ESC for menus)
     SetExitKey(KEY_NULL);
 
+    // Pack every image in assets/ into shared atlas pages (needs the GL context)
+    m_atlas = std::make_unique<TextureAtlas>();
+    m_atlas->addDirectory("assets");
+    m_atlas->build();
+
+    // Glyph atlas for all UI text; falls back to the default font without the file
+    UIFont::init(UI_FONT_PATH);
+
     // Initialize game systems
     m_sceneManager = std::make_unique<SceneManager>();
     m_party = std::make_unique<Party>();
@@ -31,6 +41,7 @@ Game::Game() : m_running(true) {
 }
 
 Game::~Game() {
+    UIFont::shutdown();
     CloseWindow();
 }
 
@@ -49,11 +60,14 @@ void Game::update() {
 void Game::draw() {
     BeginDrawing();
     ClearBackground(BLACK);
+    DrawStats::beginFrame();
 
     m_sceneManager->draw();
 
-    // Draw FPS counter
-    DrawFPS(SCREEN_WIDTH - 80, 10);
+    // Draw FPS counter, colored like DrawFPS but through the UI font's atlas
+    int fps = GetFPS();
+    Color fpsColor = fps < 15 ? RED : (fps < 30 ? ORANGE : LIME);
+    UIFont::drawText(TextFormat("%2i FPS", fps), SCREEN_WIDTH - 80, 10, 20, fpsColor);
 
     EndDrawing();
 }
@@ -63,7 +77,7 @@ void Game::initializeGame() {
     m_sceneManager->registerScene(GameState::EXPLORATION,
         std::make_unique<ExplorationScene>(
             SCREEN_WIDTH, SCREEN_HEIGHT, TILE_SIZE, MAP_WIDTH, MAP_HEIGHT,
-            m_sceneManager.get(), m_party.get()
+            m_sceneManager.get(), m_party.get(), m_atlas.get()
         )
     );
 
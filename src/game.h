@@ -5,6 +5,7 @@
 #include "scene_manager.h"
 #include "party.h"
 #include "inventory.h"
+#include "texture_atlas.h"
 
 class Game {
 public:
@@ -35,8 +36,10 @@ private:
     static constexpr int TILE_SIZE = 32;
     static constexpr int MAP_WIDTH = 30;
     static constexpr int MAP_HEIGHT = 20;
+    static constexpr const char* UI_FONT_PATH = "assets/fonts/ui.ttf";
 
-    // Game systems
+    // Game systems. The atlas is declared first so it outlives the scenes drawing from it.
+    std::unique_ptr<TextureAtlas> m_atlas;
     std::unique_ptr<SceneManager> m_sceneManager;
     std::unique_ptr<Party> m_party;
     std::unique_ptr<Inventory> m_inventory;
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "tile_layer.h"
+#include <cstdint>
+
+// On-disk layout of .jmap map files.
+// All values are little-endian and all offsets are relative to the start of the file.
+//
+//   Header
+//   Chunk index       layerCount * chunksX * chunksY entries (layer-major, then row-major)
+//   Chunk blocks      one ChunkBlock per chunk that isn't uniformly the layer's default tile
+//   Collision bitmap  height rows of collisionWordsPerRow uint64 words, bit set = blocked
+//   Tile flags        tileFlagCount uint8 TileFlag masks indexed by tile ID (optional)
+//   Objects           ObjectBlock, then its ObjectRecords, PropertyRecords and string pool (optional)
+//
+// Layers are stored in MapLayer order (ground, decoration, overlay). A chunk without a block
+// holds the layer's default tile: 0 for the ground layer, 0xFFFF (empty) for the others.
+// A chunk block is a ChunkBlock header followed by the data of its encoding:
+//   UNIFORM  nothing, the tile is in the header
+//   PALETTE  palette padded to (1 << indexBits) uint16 entries, rounded up to whole uint64
+//            words, then TileChunk::AREA * indexBits / 64 uint64 words of packed indices
+//   DENSE    TileChunk::AREA uint16 tile IDs
+// Object and property strings are offsets into the object block's string pool, a run of
+// NUL-terminated strings.
+//
+// Every block starts on a BLOCK_ALIGNMENT boundary so a loader can point its tile storage
+// straight at the mapped file instead of parsing or copying it.
+namespace jmap {
+
+constexpr uint32_t MAGIC = 0x50414D4A; // "JMAP"
+constexpr uint16_t VERSION = 3;
+constexpr uint64_t BLOCK_ALIGNMENT = 64;
+constexpr uint32_t MAX_MAP_SIZE = 65536;  // Tiles along either side
+constexpr uint16_t MAX_TILE_SIZE = 256; // Pixels; a baked chunk is TileChunk::SIZE tiles across
+
+struct Header {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t headerSize;
+    uint32_t width;
+    uint32_t height;
+    uint16_t tileSize;
+    uint16_t chunkSize;
+    uint16_t layerCount;
+    uint16_t reserved0;
+    uint32_t chunksX;
+    uint32_t chunksY;
+    uint64_t chunkIndexOffset;
+    uint64_t collisionOffset;
+    uint32_t collisionWordsPerRow;
+    uint32_t reserved1;
+    uint64_t fileSize;
+    uint64_t tileFlagsOffset;   // 0 = no tile flags
+    uint32_t tileFlagCount;
+    uint32_t reserved2;
+    uint64_t objectsOffset;     // 0 = no objects
+    uint64_t reserved3;
+};
+
+struct ChunkIndexEntry {
+    uint64_t offset; // 0 = chunk holds only the default tile and has no block
+};
+
+struct ChunkBlock {
+    uint16_t encoding;      // ChunkEncoding
+    uint16_t uniformTile;   // UNIFORM
+    uint16_t paletteSize;   // PALETTE: entries in use
+    uint16_t indexBits;     // PALETTE: 1, 2, 4 or 8
+};
+
+struct ObjectBlock {
+    uint32_t objectCount;
+    uint32_t propertyCount;
+    uint32_t stringBytes;
+    uint32_t reserved;
+};
+
+// Position and size in tiles
+struct ObjectRecord {
+    int32_t x;
+    int32_t y;
+    int32_t width;
+    int32_t height;
+    uint32_t type;
+    uint32_t name;
+    uint32_t firstProperty;
+    uint32_t propertyCount;
+};
+
+struct PropertyRecord {
+    uint32_t key;
+    uint32_t value;
+};
+
+static_assert(sizeof(Header) == 96, "jmap header layout changed");
+static_assert(sizeof(ChunkIndexEntry) == 8, "jmap chunk index layout changed");
+static_assert(sizeof(ChunkBlock) == 8, "jmap chunk block layout changed");
+static_assert(sizeof(ObjectBlock) == 16 && sizeof(ObjectRecord) == 32 && sizeof(PropertyRecord) == 8,
+              "jmap object layout changed");
+
+inline uint64_t alignBlock(uint64_t offset) {
+    return (offset + BLOCK_ALIGNMENT - 1) & ~(BLOCK_ALIGNMENT - 1);
+}
+
+// Bytes taken by a chunk block including its header, 0 if the header is invalid
+inline uint64_t getChunkBlockSize(const ChunkBlock& block) {
+    switch (static_cast<ChunkEncoding>(block.encoding)) {
+        case ChunkEncoding::UNIFORM:
+            return sizeof(ChunkBlock);
+        case ChunkEncoding::PALETTE: {
+            int bits = block.indexBits;
+            if ((bits != 1 && bits != 2 && bits != 4 && bits != 8) ||
+                block.paletteSize < 2 || block.paletteSize > (1 << bits)) {
+                return 0;
+            }
+            int words = TileLayer::paletteWordCount(1 << bits) + TileLayer::indexWordCount(bits);
+            return sizeof(ChunkBlock) + words * sizeof(uint64_t);
+        }
+        case ChunkEncoding::DENSE:
+            return sizeof(ChunkBlock) + TileChunk::AREA * sizeof(TileId);
+        default:
+            return 0;
+    }
+}
+
+} // namespace jmap
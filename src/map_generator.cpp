@@ -0,0 +1,495 @@
+#include "map_generator.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <string>
+#include <thread>
+
+namespace {
+
+// splitmix64 finalizer: cheap, well mixed and the same on every platform
+uint64_t mix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+float smoothstep(float t) {
+    return t * t * (3.0f - 2.0f * t);
+}
+
+// Salts keep the hash streams of different features apart
+constexpr uint64_t TERRAIN_SALT = 1;    // Plus the octave
+constexpr uint64_t ROCK_SALT = 100;
+
+uint64_t deriveKey(uint64_t seed, uint64_t salt) {
+    return mix64(seed ^ (salt * 0xD6E8FEB86659FD93ull));
+}
+
+// Chance in 1000 of a rock on grass, from the hills up to the mountains
+constexpr int MAX_ROCK_CHANCE = 40;
+
+struct TownResident {
+    const char* name;
+    int dialog;
+    bool shop;
+    const char* sprite;
+};
+
+const TownResident TOWN_RESIDENTS[] = {
+    {"Villager", 1, false, "assets/villager.png"},
+    {"Guard", 2, false, "assets/guard.png"},
+    {"Merchant", 3, true, "assets/merchant.png"}
+};
+
+} // namespace
+
+uint64_t MapGenerator::Random::next() {
+    m_state += 0x9E3779B97F4A7C15ull;
+    return mix64(m_state);
+}
+
+int MapGenerator::Random::range(int min, int max) {
+    return min + static_cast<int>(next() % static_cast<uint64_t>(max - min + 1));
+}
+
+float MapGenerator::Random::unit() {
+    return static_cast<float>(next() >> 40) / static_cast<float>(1 << 24);
+}
+
+MapGenerator::MapGenerator(const MapGeneratorSettings& settings)
+    : m_settings(settings)
+    , m_chunksX((settings.width + TileChunk::SIZE - 1) / TileChunk::SIZE)
+    , m_chunksY((settings.height + TileChunk::SIZE - 1) / TileChunk::SIZE)
+    , m_rockKey(deriveKey(settings.seed, ROCK_SALT))
+    , m_riverCount(0)
+    , m_roadCount(0) {
+    for (int octave = 0; octave < TERRAIN_OCTAVES; octave++) {
+        m_terrainKeys[octave] = deriveKey(settings.seed, TERRAIN_SALT + octave);
+    }
+}
+
+std::unique_ptr<Tilemap> MapGenerator::generate(const TileProperties& properties) {
+    m_segments.clear();
+    m_towns.clear();
+    m_riverCount = 0;
+    m_roadCount = 0;
+
+    // Planning is sequential so the random stream is consumed in a fixed order
+    Random random(m_settings.seed);
+    planTowns(random);
+    planRivers(random);
+    planRoads(random);
+    bucketFeatures();
+
+    size_t chunkCount = static_cast<size_t>(m_chunksX) * m_chunksY;
+    std::vector<LoadedChunk> ground(chunkCount);
+    std::vector<LoadedChunk> decoration(chunkCount);
+    generateChunks(ground, decoration);
+
+    auto map = std::make_unique<Tilemap>(m_settings.width, m_settings.height, m_settings.tileSize);
+    for (int cy = 0; cy < m_chunksY; cy++) {
+        for (int cx = 0; cx < m_chunksX; cx++) {
+            size_t index = static_cast<size_t>(cy) * m_chunksX + cx;
+            // Plain grass / empty chunks already match the layer defaults
+            if (ground[index].encoding != ChunkEncoding::UNIFORM || ground[index].uniformTile != GRASS) {
+                map->installChunk(cx, cy, MapLayer::GROUND, std::move(ground[index]));
+            }
+            if (decoration[index].encoding != ChunkEncoding::UNIFORM ||
+                decoration[index].uniformTile != Tilemap::EMPTY_TILE) {
+                map->installChunk(cx, cy, MapLayer::DECORATION, std::move(decoration[index]));
+            }
+        }
+    }
+    map->setTileProperties(properties);
+
+    // One resident per town, standing next to the square
+    for (size_t i = 0; i < m_towns.size(); i++) {
+        const Town& town = m_towns[i];
+        const TownResident& resident = TOWN_RESIDENTS[i % (sizeof(TOWN_RESIDENTS) / sizeof(TOWN_RESIDENTS[0]))];
+        MapObject npc;
+        npc.type = "npc";
+        npc.name = resident.name;
+        npc.x = std::min(town.centerX + 2, m_settings.width - 1);
+        npc.y = town.centerY;
+        npc.setProperty("dialog", std::to_string(resident.dialog));
+        npc.setProperty("sprite", resident.sprite);
+        if (resident.shop) {
+            npc.setProperty("shop", "true");
+        }
+        map->addObject(npc);
+    }
+
+    m_chunkSegments.clear();
+    m_chunkTowns.clear();
+    return map;
+}
+
+uint64_t MapGenerator::hashCell(int x, int y, uint64_t key) const {
+    uint64_t cell = (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+    return mix64(key ^ cell);
+}
+
+float MapGenerator::valueNoise(float x, float y, uint64_t key) const {
+    int ix = static_cast<int>(std::floor(x));
+    int iy = static_cast<int>(std::floor(y));
+    float fx = smoothstep(x - ix);
+    float fy = smoothstep(y - iy);
+
+    auto lattice = [&](int cx, int cy) {
+        return static_cast<float>(hashCell(cx, cy, key) >> 40) / static_cast<float>(1 << 24);
+    };
+    float topLeft = lattice(ix, iy);
+    float bottomLeft = lattice(ix, iy + 1);
+    float top = topLeft + (lattice(ix + 1, iy) - topLeft) * fx;
+    float bottom = bottomLeft + (lattice(ix + 1, iy + 1) - bottomLeft) * fx;
+    return top + (bottom - top) * fy;
+}
+
+float MapGenerator::getElevation(int x, int y) const {
+    float sum = 0.0f;
+    float amplitudeSum = 0.0f;
+    float amplitude = 1.0f;
+    float frequency = 1.0f / TERRAIN_SCALE;
+    for (int octave = 0; octave < TERRAIN_OCTAVES; octave++) {
+        sum += amplitude * valueNoise(x * frequency, y * frequency, m_terrainKeys[octave]);
+        amplitudeSum += amplitude;
+        amplitude *= 0.5f;
+        frequency *= 2.0f;
+    }
+
+    // Summed octaves bunch up around 0.5; stretch them so seas and ranges show up
+    float elevation = (sum / amplitudeSum - 0.5f) * 2.0f + 0.5f;
+    return std::clamp(elevation, 0.0f, 1.0f);
+}
+
+void MapGenerator::planTowns(Random& random) {
+    int cellsX = (m_settings.width + TOWN_CELL - 1) / TOWN_CELL;
+    int cellsY = (m_settings.height + TOWN_CELL - 1) / TOWN_CELL;
+    m_townCells.assign(static_cast<size_t>(cellsX) * cellsY, -1);
+
+    // The start town goes wherever the terrain is
+    int centerX = m_settings.width / 2;
+    int centerY = m_settings.height / 2;
+    placeTown(random, centerX, centerY);
+    m_townCells[(centerY / TOWN_CELL) * cellsX + centerX / TOWN_CELL] = 0;
+
+    constexpr int PLACEMENT_TRIES = 8;
+    for (int cy = 0; cy < cellsY; cy++) {
+        for (int cx = 0; cx < cellsX; cx++) {
+            if (m_townCells[cy * cellsX + cx] >= 0) {
+                continue;
+            }
+            // Keep a margin inside the cell so neighbouring towns never touch
+            int x0 = cx * TOWN_CELL + 24;
+            int y0 = cy * TOWN_CELL + 24;
+            int x1 = std::min((cx + 1) * TOWN_CELL, m_settings.width) - 24;
+            int y1 = std::min((cy + 1) * TOWN_CELL, m_settings.height) - 24;
+            if (x1 <= x0 || y1 <= y0) {
+                continue;
+            }
+            for (int attempt = 0; attempt < PLACEMENT_TRIES; attempt++) {
+                int x = random.range(x0, x1);
+                int y = random.range(y0, y1);
+                float elevation = getElevation(x, y);
+                if (elevation > WATER_LEVEL + 0.04f && elevation < HILL_LEVEL) {
+                    m_townCells[cy * cellsX + cx] = static_cast<int>(m_towns.size());
+                    placeTown(random, x, y);
+                    break;
+                }
+            }
+        }
+    }
+}
+
+void MapGenerator::placeTown(Random& random, int centerX, int centerY) {
+    constexpr int LOT_WIDTH = 8;
+    constexpr int LOT_HEIGHT = 7;
+    constexpr int STREET = 2;
+
+    Town town;
+    town.centerX = centerX;
+    town.centerY = centerY;
+    town.plot.width = std::min(random.range(20, 40), m_settings.width);
+    town.plot.height = std::min(random.range(18, 32), m_settings.height);
+    town.plot.x = std::clamp(centerX - town.plot.width / 2, 0, m_settings.width - town.plot.width);
+    town.plot.y = std::clamp(centerY - town.plot.height / 2, 0, m_settings.height - town.plot.height);
+
+    // Lots on a grid separated by streets; the ones touching the square stay empty
+    Rect square = {centerX - 2, centerY - 2, 5, 5};
+    for (int ly = town.plot.y + STREET; ly + LOT_HEIGHT <= town.plot.y + town.plot.height - STREET;
+         ly += LOT_HEIGHT + STREET) {
+        for (int lx = town.plot.x + STREET; lx + LOT_WIDTH <= town.plot.x + town.plot.width - STREET;
+             lx += LOT_WIDTH + STREET) {
+            bool nearSquare = lx < square.x + square.width && square.x < lx + LOT_WIDTH &&
+                              ly < square.y + square.height && square.y < ly + LOT_HEIGHT;
+            if (nearSquare || random.range(0, 3) == 0) {
+                continue;
+            }
+            Building building;
+            building.bounds.width = random.range(4, LOT_WIDTH - 1);
+            building.bounds.height = random.range(4, LOT_HEIGHT - 1);
+            building.bounds.x = lx + random.range(0, LOT_WIDTH - building.bounds.width);
+            building.bounds.y = ly + random.range(0, LOT_HEIGHT - building.bounds.height);
+            building.doorX = building.bounds.x + random.range(1, building.bounds.width - 2);
+            town.buildings.push_back(building);
+        }
+    }
+
+    m_towns.push_back(std::move(town));
+}
+
+void MapGenerator::planRivers(Random& random) {
+    // The eight compass directions, scaled to one river step
+    static const int DIRECTIONS[8][2] = {{1, 0}, {1, 1}, {0, 1}, {-1, 1}, {-1, 0}, {-1, -1}, {0, -1}, {1, -1}};
+    constexpr int SOURCE_TRIES = 16;
+
+    long long area = static_cast<long long>(m_settings.width) * m_settings.height;
+    int sources = static_cast<int>(std::max<long long>(1, area / RIVER_AREA));
+    for (int river = 0; river < sources; river++) {
+        int x = 0;
+        int y = 0;
+        bool found = false;
+        for (int attempt = 0; attempt < SOURCE_TRIES && !found; attempt++) {
+            x = random.range(0, m_settings.width - 1);
+            y = random.range(0, m_settings.height - 1);
+            found = getElevation(x, y) > HILL_LEVEL;
+        }
+        if (!found) {
+            continue;
+        }
+
+        // Walk downhill until the river reaches the sea or leaves the map, never turning back
+        float radius = 0.8f + random.unit() * 1.2f;
+        int lastDirection = -1;
+        int steps = 0;
+        for (; steps < MAX_RIVER_STEPS; steps++) {
+            int best = -1;
+            float bestScore = 0.0f;
+            for (int d = 0; d < 8; d++) {
+                if (lastDirection >= 0 && (d - lastDirection + 8) % 8 >= 3 && (d - lastDirection + 8) % 8 <= 5) {
+                    continue;
+                }
+                int nx = std::clamp(x + DIRECTIONS[d][0] * RIVER_STEP, 0, m_settings.width - 1);
+                int ny = std::clamp(y + DIRECTIONS[d][1] * RIVER_STEP, 0, m_settings.height - 1);
+                float score = getElevation(nx, ny) + random.unit() * 0.03f;
+                if (best < 0 || score < bestScore) {
+                    best = d;
+                    bestScore = score;
+                }
+            }
+
+            int nx = x + DIRECTIONS[best][0] * RIVER_STEP;
+            int ny = y + DIRECTIONS[best][1] * RIVER_STEP;
+            m_segments.push_back({static_cast<float>(x), static_cast<float>(y), static_cast<float>(nx), static_cast<float>(ny),
+                        radius, WATER});
+            x = nx;
+            y = ny;
+            lastDirection = best;
+            if (x < 0 || y < 0 || x >= m_settings.width || y >= m_settings.height || getElevation(x, y) < WATER_LEVEL) {
+                break;
+            }
+        }
+        m_riverCount++;
+    }
+}
+
+void MapGenerator::planRoads(Random& random) {
+    int cellsX = (m_settings.width + TOWN_CELL - 1) / TOWN_CELL;
+    int cellsY = (m_settings.height + TOWN_CELL - 1) / TOWN_CELL;
+
+    auto connect = [&](const Town& from, const Town& to) {
+        float dx = static_cast<float>(to.centerX - from.centerX);
+        float dy = static_cast<float>(to.centerY - from.centerY);
+        float length = std::sqrt(dx * dx + dy * dy);
+        int bends = std::max(1, static_cast<int>(length / ROAD_STEP));
+
+        // Bends wander sideways a little; the ends stay on the town squares
+        float px = static_cast<float>(from.centerX);
+        float py = static_cast<float>(from.centerY);
+        for (int i = 1; i <= bends; i++) {
+            float t = static_cast<float>(i) / bends;
+            float offset = (i < bends) ? static_cast<float>(random.range(-6, 6)) : 0.0f;
+            float x = from.centerX + dx * t - dy / length * offset;
+            float y = from.centerY + dy * t + dx / length * offset;
+            m_segments.push_back({px, py, x, y, 1.0f, PATH});
+            px = x;
+            py = y;
+        }
+        m_roadCount++;
+    };
+
+    // Link each town to the next town east and south, skipping one empty cell at most
+    for (int cy = 0; cy < cellsY; cy++) {
+        for (int cx = 0; cx < cellsX; cx++) {
+            int town = m_townCells[cy * cellsX + cx];
+            if (town < 0) {
+                continue;
+            }
+            for (int step = 1; step <= 2 && cx + step < cellsX; step++) {
+                int east = m_townCells[cy * cellsX + cx + step];
+                if (east >= 0) {
+                    connect(m_towns[town], m_towns[east]);
+                    break;
+                }
+            }
+            for (int step = 1; step <= 2 && cy + step < cellsY; step++) {
+                int south = m_townCells[(cy + step) * cellsX + cx];
+                if (south >= 0) {
+                    connect(m_towns[town], m_towns[south]);
+                    break;
+                }
+            }
+        }
+    }
+}
+
+void MapGenerator::bucketFeatures() {
+    size_t chunkCount = static_cast<size_t>(m_chunksX) * m_chunksY;
+    m_chunkSegments.assign(chunkCount, {});
+    m_chunkTowns.assign(chunkCount, {});
+
+    auto addToChunks = [&](std::vector<std::vector<uint32_t>>& buckets, uint32_t index,
+                           float minX, float minY, float maxX, float maxY) {
+        int cx0 = std::max(0, static_cast<int>(std::floor(minX)) / TileChunk::SIZE);
+        int cy0 = std::max(0, static_cast<int>(std::floor(minY)) / TileChunk::SIZE);
+        int cx1 = std::min(m_chunksX - 1, static_cast<int>(std::ceil(maxX)) / TileChunk::SIZE);
+        int cy1 = std::min(m_chunksY - 1, static_cast<int>(std::ceil(maxY)) / TileChunk::SIZE);
+        for (int cy = cy0; cy <= cy1; cy++) {
+            for (int cx = cx0; cx <= cx1; cx++) {
+                buckets[static_cast<size_t>(cy) * m_chunksX + cx].push_back(index);
+            }
+        }
+    };
+
+    for (size_t i = 0; i < m_segments.size(); i++) {
+        const Segment& s = m_segments[i];
+        addToChunks(m_chunkSegments, static_cast<uint32_t>(i),
+                    std::min(s.x0, s.x1) - s.radius, std::min(s.y0, s.y1) - s.radius,
+                    std::max(s.x0, s.x1) + s.radius, std::max(s.y0, s.y1) + s.radius);
+    }
+    for (size_t i = 0; i < m_towns.size(); i++) {
+        const Rect& plot = m_towns[i].plot;
+        addToChunks(m_chunkTowns, static_cast<uint32_t>(i), static_cast<float>(plot.x), static_cast<float>(plot.y),
+                    static_cast<float>(plot.x + plot.width - 1), static_cast<float>(plot.y + plot.height - 1));
+    }
+}
+
+void MapGenerator::fillChunk(int chunkX, int chunkY, TileId* ground, TileId* decoration) const {
+    int x0 = chunkX * TileChunk::SIZE;
+    int y0 = chunkY * TileChunk::SIZE;
+    size_t chunkIndex = static_cast<size_t>(chunkY) * m_chunksX + chunkX;
+    std::array<float, TileChunk::AREA> elevation;
+
+    // Terrain; cells past the map edge keep the layer defaults
+    for (int ly = 0; ly < TileChunk::SIZE; ly++) {
+        for (int lx = 0; lx < TileChunk::SIZE; lx++) {
+            int i = ly * TileChunk::SIZE + lx;
+            int x = x0 + lx;
+            int y = y0 + ly;
+            decoration[i] = Tilemap::EMPTY_TILE;
+            if (x >= m_settings.width || y >= m_settings.height) {
+                elevation[i] = 0.0f;
+                ground[i] = GRASS;
+                continue;
+            }
+            elevation[i] = getElevation(x, y);
+            ground[i] = elevation[i] < WATER_LEVEL ? WATER : elevation[i] > MOUNTAIN_LEVEL ? WALL : GRASS;
+        }
+    }
+
+    int xEnd = std::min(x0 + TileChunk::SIZE, m_settings.width);
+    int yEnd = std::min(y0 + TileChunk::SIZE, m_settings.height);
+
+    // Rivers, then roads (bridges) over them
+    for (uint32_t index : m_chunkSegments[chunkIndex]) {
+        const Segment& s = m_segments[index];
+        int sx0 = std::max(x0, static_cast<int>(std::floor(std::min(s.x0, s.x1) - s.radius)));
+        int sy0 = std::max(y0, static_cast<int>(std::floor(std::min(s.y0, s.y1) - s.radius)));
+        int sx1 = std::min(xEnd - 1, static_cast<int>(std::ceil(std::max(s.x0, s.x1) + s.radius)));
+        int sy1 = std::min(yEnd - 1, static_cast<int>(std::ceil(std::max(s.y0, s.y1) + s.radius)));
+        float dx = s.x1 - s.x0;
+        float dy = s.y1 - s.y0;
+        float lengthSquared = dx * dx + dy * dy;
+        for (int y = sy0; y <= sy1; y++) {
+            for (int x = sx0; x <= sx1; x++) {
+                float t = lengthSquared > 0.0f ? std::clamp(((x - s.x0) * dx + (y - s.y0) * dy) / lengthSquared, 0.0f, 1.0f)
+                                               : 0.0f;
+                float ex = x - (s.x0 + dx * t);
+                float ey = y - (s.y0 + dy * t);
+                if (ex * ex + ey * ey <= s.radius * s.radius) {
+                    ground[(y - y0) * TileChunk::SIZE + (x - x0)] = s.tile;
+                }
+            }
+        }
+    }
+
+    // Towns pave over everything, then put up their walls
+    for (uint32_t index : m_chunkTowns[chunkIndex]) {
+        const Town& town = m_towns[index];
+        for (int y = std::max(y0, town.plot.y); y < std::min(yEnd, town.plot.y + town.plot.height); y++) {
+            for (int x = std::max(x0, town.plot.x); x < std::min(xEnd, town.plot.x + town.plot.width); x++) {
+                ground[(y - y0) * TileChunk::SIZE + (x - x0)] = PATH;
+            }
+        }
+        for (const Building& building : town.buildings) {
+            const Rect& b = building.bounds;
+            for (int y = std::max(y0, b.y); y < std::min(yEnd, b.y + b.height); y++) {
+                for (int x = std::max(x0, b.x); x < std::min(xEnd, b.x + b.width); x++) {
+                    bool edge = x == b.x || y == b.y || x == b.x + b.width - 1 || y == b.y + b.height - 1;
+                    bool door = y == b.y + b.height - 1 && x == building.doorX;
+                    if (edge && !door) {
+                        ground[(y - y0) * TileChunk::SIZE + (x - x0)] = WALL;
+                    }
+                }
+            }
+        }
+    }
+
+    // Rocks on open grass, more of them higher up
+    for (int y = y0; y < yEnd; y++) {
+        for (int x = x0; x < xEnd; x++) {
+            int i = (y - y0) * TileChunk::SIZE + (x - x0);
+            if (ground[i] != GRASS || elevation[i] < HILL_LEVEL) {
+                continue;
+            }
+            float height = (elevation[i] - HILL_LEVEL) / (MOUNTAIN_LEVEL - HILL_LEVEL);
+            if (static_cast<int>(hashCell(x, y, m_rockKey) % 1000) < static_cast<int>(height * MAX_ROCK_CHANCE)) {
+                decoration[i] = WALL;
+            }
+        }
+    }
+}
+
+void MapGenerator::generateChunks(std::vector<LoadedChunk>& ground, std::vector<LoadedChunk>& decoration) {
+    int threadCount = m_settings.threadCount > 0 ? m_settings.threadCount
+                                                 : static_cast<int>(std::thread::hardware_concurrency());
+    threadCount = std::clamp(threadCount, 1, m_chunksY);
+
+    // Workers take whole chunk rows; every chunk lands in its own slot, so the result
+    // does not depend on which worker got which row
+    std::atomic<int> nextRow(0);
+    auto worker = [&]() {
+        std::array<TileId, TileChunk::AREA> groundTiles;
+        std::array<TileId, TileChunk::AREA> decorationTiles;
+        for (int cy = nextRow++; cy < m_chunksY; cy = nextRow++) {
+            for (int cx = 0; cx < m_chunksX; cx++) {
+                size_t index = static_cast<size_t>(cy) * m_chunksX + cx;
+                fillChunk(cx, cy, groundTiles.data(), decorationTiles.data());
+                ground[index] = TileLayer::encodeLoadedChunk(groundTiles.data());
+                decoration[index] = TileLayer::encodeLoadedChunk(decorationTiles.data());
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 1; i < threadCount; i++) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
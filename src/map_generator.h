@@ -0,0 +1,122 @@
+#pragma once
+
+#include "tilemap.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+struct MapGeneratorSettings {
+    int width = 1024;
+    int height = 1024;
+    int tileSize = 32;
+    uint64_t seed = 1;
+    int threadCount = 0;    // 0 = one per hardware thread
+};
+
+// Seeded procedural world for stress testing: noise terrain (grass, water, mountain
+// walls, rocks on DECORATION), rivers running downhill, towns with walled buildings and
+// roads linking neighbouring towns. The first town is always at the map center, where
+// ExplorationScene puts the player.
+//
+// generate() plans rivers, roads and towns on the calling thread, then fills chunks on
+// a pool of worker threads. Every chunk only depends on the seed and the plan, so a
+// seed always produces the same map whatever the thread count.
+class MapGenerator {
+public:
+    explicit MapGenerator(const MapGeneratorSettings& settings);
+
+    // Builds the whole map; collision comes from the given tile properties
+    std::unique_ptr<Tilemap> generate(const TileProperties& properties = TileProperties());
+
+    // Plan of the last generate() call
+    int getRiverCount() const { return m_riverCount; }
+    int getRoadCount() const { return m_roadCount; }
+    int getTownCount() const { return static_cast<int>(m_towns.size()); }
+
+private:
+    // River or road piece, drawn as a thick line
+    struct Segment {
+        float x0, y0, x1, y1;
+        float radius;
+        TileId tile;
+    };
+
+    struct Rect {
+        int x, y, width, height;
+
+        bool contains(int px, int py) const { return px >= x && px < x + width && py >= y && py < y + height; }
+    };
+
+    struct Building {
+        Rect bounds;
+        int doorX;  // Door in the bottom wall
+    };
+
+    struct Town {
+        Rect plot;
+        int centerX;    // Open square in the middle, kept free of buildings
+        int centerY;
+        std::vector<Building> buildings;
+    };
+
+    // Deterministic generator for the planning steps (std distributions vary between
+    // standard libraries, so the seed would not reproduce across compilers)
+    class Random {
+    public:
+        explicit Random(uint64_t seed) : m_state(seed) {}
+        uint64_t next();
+        int range(int min, int max); // Inclusive
+        float unit();                // [0, 1)
+
+    private:
+        uint64_t m_state;
+    };
+
+    static constexpr TileId GRASS = 0;
+    static constexpr TileId WALL = 1;
+    static constexpr TileId WATER = 2;
+    static constexpr TileId PATH = 3;
+
+    static constexpr float WATER_LEVEL = 0.36f;
+    static constexpr float MOUNTAIN_LEVEL = 0.70f;
+    static constexpr float HILL_LEVEL = 0.58f;      // Rocks start appearing here
+    static constexpr float TERRAIN_SCALE = 128.0f;  // Tiles per lattice cell of the first octave
+    static constexpr int TERRAIN_OCTAVES = 5;
+
+    static constexpr int RIVER_AREA = 160 * 160;    // Map area per river source
+    static constexpr int RIVER_STEP = 6;
+    static constexpr int MAX_RIVER_STEPS = 300;
+    static constexpr int TOWN_CELL = 192;           // At most one town per cell
+    static constexpr int ROAD_STEP = 24;            // Tiles between road bends
+
+    float getElevation(int x, int y) const;
+    float valueNoise(float x, float y, uint64_t key) const;
+    uint64_t hashCell(int x, int y, uint64_t key) const;
+
+    void planTowns(Random& random);
+    void placeTown(Random& random, int centerX, int centerY);
+    void planRivers(Random& random);
+    void planRoads(Random& random);
+    void bucketFeatures();
+
+    void fillChunk(int chunkX, int chunkY, TileId* ground, TileId* decoration) const;
+    void generateChunks(std::vector<LoadedChunk>& ground, std::vector<LoadedChunk>& decoration);
+
+    MapGeneratorSettings m_settings;
+    int m_chunksX;
+    int m_chunksY;
+
+    // Hash keys derived from the seed, one per noise octave plus one for rocks
+    uint64_t m_terrainKeys[TERRAIN_OCTAVES];
+    uint64_t m_rockKey;
+
+    std::vector<Segment> m_segments;    // Rivers first, then roads (later ones win)
+    std::vector<Town> m_towns;
+    std::vector<int> m_townCells;       // Town index per TOWN_CELL cell, -1 if none
+    int m_riverCount;
+    int m_roadCount;
+
+    // Features overlapping each chunk, in drawing order
+    std::vector<std::vector<uint32_t>> m_chunkSegments;
+    std::vector<std::vector<uint32_t>> m_chunkTowns;
+};
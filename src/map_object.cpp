@@ -0,0 +1,41 @@
+#include "map_object.h"
+#include <cstdlib>
+
+bool MapObject::hasProperty(const std::string& key) const {
+    for (const auto& property : properties) {
+        if (property.first == key) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string MapObject::getProperty(const std::string& key, const std::string& fallback) const {
+    for (const auto& property : properties) {
+        if (property.first == key) {
+            return property.second;
+        }
+    }
+    return fallback;
+}
+
+int MapObject::getIntProperty(const std::string& key, int fallback) const {
+    for (const auto& property : properties) {
+        if (property.first == key) {
+            char* end = nullptr;
+            long value = std::strtol(property.second.c_str(), &end, 10);
+            return (end != property.second.c_str() && *end == '\0') ? static_cast<int>(value) : fallback;
+        }
+    }
+    return fallback;
+}
+
+void MapObject::setProperty(const std::string& key, const std::string& value) {
+    for (auto& property : properties) {
+        if (property.first == key) {
+            property.second = value;
+            return;
+        }
+    }
+    properties.emplace_back(key, value);
+}
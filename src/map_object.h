@@ -0,0 +1,26 @@
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+// Placed object from a map's object layers (NPC spawns, triggers, ...).
+// Positions and sizes are in tiles; properties are kept as strings.
+struct MapObject {
+    std::string type;   // e.g. "npc", "trigger"
+    std::string name;
+    int x = 0;
+    int y = 0;
+    int width = 1;
+    int height = 1;
+    std::vector<std::pair<std::string, std::string>> properties;
+
+    bool contains(int tileX, int tileY) const {
+        return tileX >= x && tileX < x + width && tileY >= y && tileY < y + height;
+    }
+
+    bool hasProperty(const std::string& key) const;
+    std::string getProperty(const std::string& key, const std::string& fallback = "") const;
+    int getIntProperty(const std::string& key, int fallback = 0) const;
+    void setProperty(const std::string& key, const std::string& value);
+};
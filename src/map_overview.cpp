@@ -0,0 +1,257 @@
+#include "map_overview.h"
+#include "draw_stats.h"
+#include <algorithm>
+#include <cmath>
+
+static_assert((1 << MapOverview::MAX_BASE_SHIFT) <= TileChunk::SIZE, "overview texels must not span chunks");
+
+MapOverview::MapOverview(const Tilemap& tilemap)
+    : m_tilemap(tilemap), m_baseShift(0), m_mapRevision(tilemap.getRevision()), m_lastPatchedChunks(0) {
+    int width = tilemap.getWidth();
+    int height = tilemap.getHeight();
+    // Past MAX_BASE_SHIFT level 0 grows beyond MAX_BASE_SIZE instead (maps over 131072 tiles)
+    while (((std::max(width, height) - 1) >> m_baseShift) + 1 > MAX_BASE_SIZE && m_baseShift < MAX_BASE_SHIFT) {
+        m_baseShift++;
+    }
+
+    // Level sizes round up so edge tiles always have a texel
+    int levelWidth = ((width - 1) >> m_baseShift) + 1;
+    int levelHeight = ((height - 1) >> m_baseShift) + 1;
+    while (true) {
+        Level level;
+        level.width = levelWidth;
+        level.height = levelHeight;
+        level.texels.resize(static_cast<size_t>(levelWidth) * levelHeight);
+        level.texture = {0};
+        m_levels.push_back(std::move(level));
+        if (levelWidth == 1 && levelHeight == 1) {
+            break;
+        }
+        levelWidth = (levelWidth + 1) / 2;
+        levelHeight = (levelHeight + 1) / 2;
+    }
+
+    int chunksX = tilemap.getChunksX();
+    int chunksY = tilemap.getChunksY();
+    m_chunkRevisions.resize(static_cast<size_t>(chunksX) * chunksY);
+    m_chunkColored.assign(m_chunkRevisions.size(), 0);
+    for (int cy = 0; cy < chunksY; cy++) {
+        for (int cx = 0; cx < chunksX; cx++) {
+            if (!tilemap.isChunkLoaded(cx, cy)) {
+                continue; // Transparent until streamed in
+            }
+            colorChunk(cx, cy);
+            m_chunkRevisions[cy * chunksX + cx] = getCombinedRevision(cx, cy);
+            m_chunkColored[cy * chunksX + cx] = 1;
+        }
+    }
+
+    for (size_t i = 0; i < m_levels.size(); i++) {
+        Level& level = m_levels[i];
+        if (i > 0) {
+            downsample(static_cast<int>(i), 0, 0, level.width - 1, level.height - 1);
+        }
+        Image image = {level.texels.data(), level.width, level.height, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8};
+        level.texture = LoadTextureFromImage(image);
+        SetTextureFilter(level.texture, TEXTURE_FILTER_POINT);
+    }
+}
+
+MapOverview::~MapOverview() {
+    for (const Level& level : m_levels) {
+        if (level.texture.id > 0) {
+            UnloadTexture(level.texture);
+        }
+    }
+}
+
+void MapOverview::update() {
+    m_lastPatchedChunks = 0;
+    if (m_tilemap.getRevision() == m_mapRevision) {
+        return;
+    }
+    m_mapRevision = m_tilemap.getRevision();
+
+    int chunksX = m_tilemap.getChunksX();
+    int chunksY = m_tilemap.getChunksY();
+    for (int cy = 0; cy < chunksY; cy++) {
+        for (int cx = 0; cx < chunksX; cx++) {
+            // A chunk that isn't loaded only holds the default tile, so it keeps its last
+            // colors; the revision check catches up once it is back
+            if (!m_tilemap.isChunkLoaded(cx, cy)) {
+                continue;
+            }
+            int index = cy * chunksX + cx;
+            uint32_t revision = getCombinedRevision(cx, cy);
+            if (!m_chunkColored[index] || revision != m_chunkRevisions[index]) {
+                m_chunkRevisions[index] = revision;
+                m_chunkColored[index] = 1;
+                patchChunk(cx, cy);
+                m_lastPatchedChunks++;
+            }
+        }
+    }
+}
+
+void MapOverview::draw(Rectangle tileRect, Rectangle dest) const {
+    if (tileRect.width <= 0.0f || dest.width <= 0.0f) {
+        return;
+    }
+
+    int levelIndex = selectLevel(dest.width / tileRect.width);
+    const Level& level = m_levels[levelIndex];
+    float tilesPerTexel = static_cast<float>(1 << (m_baseShift + levelIndex));
+    Rectangle source = {
+        tileRect.x / tilesPerTexel,
+        tileRect.y / tilesPerTexel,
+        tileRect.width / tilesPerTexel,
+        tileRect.height / tilesPerTexel
+    };
+    DrawStats::useTexture(level.texture.id);
+    DrawTexturePro(level.texture, source, dest, {0, 0}, 0.0f, WHITE);
+}
+
+void MapOverview::drawWholeMap(Rectangle dest) const {
+    Rectangle tileRect = {0.0f, 0.0f, static_cast<float>(m_tilemap.getWidth()), static_cast<float>(m_tilemap.getHeight())};
+    draw(tileRect, dest);
+}
+
+int MapOverview::selectLevel(float pixelsPerTile) const {
+    if (pixelsPerTile <= 0.0f) {
+        return getLevelCount() - 1;
+    }
+    // Texels of level k cover 2^(baseShift + k) tiles; keep that at or below one pixel's worth
+    int shift = static_cast<int>(std::floor(std::log2(1.0f / pixelsPerTile)));
+    return std::clamp(shift - m_baseShift, 0, getLevelCount() - 1);
+}
+
+uint32_t MapOverview::getCombinedRevision(int chunkX, int chunkY) const {
+    uint32_t revision = 0;
+    for (int layer = 0; layer < Tilemap::LAYER_COUNT; layer++) {
+        revision += m_tilemap.getChunkRevision(chunkX, chunkY, static_cast<MapLayer>(layer));
+    }
+    return revision;
+}
+
+Color MapOverview::getCellColor(int x, int y) const {
+    // Topmost tile wins, so roofs and props show up on the map
+    for (int layer = Tilemap::LAYER_COUNT - 1; layer > 0; layer--) {
+        int tile = m_tilemap.getTile(x, y, static_cast<MapLayer>(layer));
+        if (tile >= 0) {
+            return m_tilemap.getTileColor(tile);
+        }
+    }
+    return m_tilemap.getTileColor(m_tilemap.getTile(x, y));
+}
+
+void MapOverview::colorChunk(int chunkX, int chunkY) {
+    Level& base = m_levels[0];
+    int tileX0 = chunkX * TileChunk::SIZE;
+    int tileY0 = chunkY * TileChunk::SIZE;
+    int tileX1 = std::min(m_tilemap.getWidth(), tileX0 + TileChunk::SIZE);
+    int tileY1 = std::min(m_tilemap.getHeight(), tileY0 + TileChunk::SIZE);
+
+    // Uniform chunks on every layer (open sea, plains) need no tile reads at all
+    bool uniform = true;
+    Color uniformColor = BLANK;
+    for (int layer = Tilemap::LAYER_COUNT - 1; layer >= 0 && uniform; layer--) {
+        TileId tile;
+        uniform = m_tilemap.getChunkUniformTile(chunkX, chunkY, static_cast<MapLayer>(layer), tile);
+        if (uniform && uniformColor.a == 0 && (tile != Tilemap::EMPTY_TILE || layer == 0)) {
+            uniformColor = m_tilemap.getTileColor(tile);
+        }
+    }
+
+    // Texels are at most a chunk wide (MAX_BASE_SHIFT), so chunks never share a texel
+    int step = 1 << m_baseShift;
+    for (int texelY = tileY0 >> m_baseShift; texelY <= (tileY1 - 1) >> m_baseShift; texelY++) {
+        for (int texelX = tileX0 >> m_baseShift; texelX <= (tileX1 - 1) >> m_baseShift; texelX++) {
+            Color& texel = base.texels[texelY * base.width + texelX];
+            if (uniform) {
+                texel = uniformColor;
+                continue;
+            }
+
+            int r = 0, g = 0, b = 0, count = 0;
+            for (int y = texelY * step; y < std::min(tileY1, (texelY + 1) * step); y++) {
+                for (int x = texelX * step; x < std::min(tileX1, (texelX + 1) * step); x++) {
+                    Color color = getCellColor(x, y);
+                    r += color.r;
+                    g += color.g;
+                    b += color.b;
+                    count++;
+                }
+            }
+            texel = {static_cast<unsigned char>(r / count), static_cast<unsigned char>(g / count),
+                     static_cast<unsigned char>(b / count), 255};
+        }
+    }
+}
+
+void MapOverview::downsample(int levelIndex, int x0, int y0, int x1, int y1) {
+    const Level& source = m_levels[levelIndex - 1];
+    Level& target = m_levels[levelIndex];
+
+    for (int y = y0; y <= y1; y++) {
+        for (int x = x0; x <= x1; x++) {
+            // Alpha-weighted, so areas not streamed in yet fade out on coarser levels
+            // without darkening the colors next to them
+            int r = 0, g = 0, b = 0, a = 0, count = 0;
+            for (int sy = y * 2; sy < std::min(source.height, y * 2 + 2); sy++) {
+                for (int sx = x * 2; sx < std::min(source.width, x * 2 + 2); sx++) {
+                    const Color& color = source.texels[sy * source.width + sx];
+                    r += color.r * color.a;
+                    g += color.g * color.a;
+                    b += color.b * color.a;
+                    a += color.a;
+                    count++;
+                }
+            }
+            Color& texel = target.texels[y * target.width + x];
+            if (a == 0) {
+                texel = BLANK;
+                continue;
+            }
+            texel = {static_cast<unsigned char>(r / a), static_cast<unsigned char>(g / a),
+                     static_cast<unsigned char>(b / a), static_cast<unsigned char>(a / count)};
+        }
+    }
+}
+
+void MapOverview::upload(int levelIndex, int x0, int y0, int x1, int y1) {
+    const Level& level = m_levels[levelIndex];
+    int width = x1 - x0 + 1;
+    int height = y1 - y0 + 1;
+
+    // UpdateTextureRec wants the rectangle's texels packed row after row
+    m_uploadBuffer.resize(static_cast<size_t>(width) * height);
+    for (int y = 0; y < height; y++) {
+        const Color* row = &level.texels[(y0 + y) * level.width + x0];
+        std::copy(row, row + width, m_uploadBuffer.begin() + y * width);
+    }
+
+    Rectangle rect = {static_cast<float>(x0), static_cast<float>(y0), static_cast<float>(width), static_cast<float>(height)};
+    UpdateTextureRec(level.texture, rect, m_uploadBuffer.data());
+}
+
+void MapOverview::patchChunk(int chunkX, int chunkY) {
+    colorChunk(chunkX, chunkY);
+
+    int tileX1 = std::min(m_tilemap.getWidth(), (chunkX + 1) * TileChunk::SIZE) - 1;
+    int tileY1 = std::min(m_tilemap.getHeight(), (chunkY + 1) * TileChunk::SIZE) - 1;
+    int x0 = (chunkX * TileChunk::SIZE) >> m_baseShift;
+    int y0 = (chunkY * TileChunk::SIZE) >> m_baseShift;
+    int x1 = tileX1 >> m_baseShift;
+    int y1 = tileY1 >> m_baseShift;
+    upload(0, x0, y0, x1, y1);
+
+    // The chunk's footprint halves on every level above
+    for (int level = 1; level < getLevelCount(); level++) {
+        x0 >>= 1;
+        y0 >>= 1;
+        x1 >>= 1;
+        y1 >>= 1;
+        downsample(level, x0, y0, x1, y1);
+        upload(level, x0, y0, x1, y1);
+    }
+}
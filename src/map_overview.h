@@ -0,0 +1,69 @@
+#pragma once
+
+#include "tilemap.h"
+#include <raylib.h>
+#include <cstdint>
+#include <vector>
+
+// Downsampled picture of a whole Tilemap for the minimap and the world map.
+//
+// Level 0 has one texel per tile (or per 2x2, 4x4... tiles on maps wider than
+// MAX_BASE_SIZE), colored with the topmost non-empty layer's Tilemap::getTileColor.
+// Every further level halves the previous one with a 2x2 box filter, down to 1x1.
+// Each level is its own texture, so drawing the map at any size is a single quad from
+// the level whose texels are closest to one screen pixel.
+//
+// update() follows edits the same way the chunk render caches do: chunks whose revision
+// changed are re-colored and only their texels are re-filtered and re-uploaded on
+// each level. On a streamed map only loaded chunks are colored; the rest stay transparent
+// until they first stream in and keep their last colors after being evicted.
+class MapOverview {
+public:
+    static constexpr int MAX_BASE_SIZE = 4096; // Texels along the longer side of level 0
+    static constexpr int MAX_BASE_SHIFT = 5;   // Level 0 texels cover at most a chunk
+
+    // Needs a GL context; the tilemap must outlive the overview
+    explicit MapOverview(const Tilemap& tilemap);
+    ~MapOverview();
+
+    MapOverview(const MapOverview&) = delete;
+    MapOverview& operator=(const MapOverview&) = delete;
+
+    // Call once per frame; cheap when nothing changed
+    void update();
+
+    // Draws the part of the map inside tileRect (in tiles) scaled to dest. One quad.
+    void draw(Rectangle tileRect, Rectangle dest) const;
+    void drawWholeMap(Rectangle dest) const;
+
+    // Coarsest level whose texels still cover at least one screen pixel
+    int selectLevel(float pixelsPerTile) const;
+
+    int getLevelCount() const { return static_cast<int>(m_levels.size()); }
+    int getLastPatchedChunks() const { return m_lastPatchedChunks; }
+
+private:
+    struct Level {
+        int width;
+        int height;
+        std::vector<Color> texels;
+        Texture2D texture;
+    };
+
+    uint32_t getCombinedRevision(int chunkX, int chunkY) const;
+    Color getCellColor(int x, int y) const;
+    void colorChunk(int chunkX, int chunkY); // Level 0 texels covered by the chunk
+    void downsample(int level, int x0, int y0, int x1, int y1);
+    void upload(int level, int x0, int y0, int x1, int y1);
+    void patchChunk(int chunkX, int chunkY);
+
+    const Tilemap& m_tilemap;
+    int m_baseShift; // Level 0 texel = (1 << m_baseShift) tiles on each side
+    std::vector<Level> m_levels;
+
+    uint32_t m_mapRevision;
+    std::vector<uint32_t> m_chunkRevisions; // Sum over layers when last colored
+    std::vector<uint8_t> m_chunkColored;    // Colored from loaded tiles at least once
+    std::vector<Color> m_uploadBuffer;
+    int m_lastPatchedChunks;
+};
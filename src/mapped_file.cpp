@@ -0,0 +1,90 @@
+#include "mapped_file.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::string& path)
+    : m_data(nullptr), m_size(0), m_fileHandle(nullptr), m_mappingHandle(nullptr) {
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        CloseHandle(file);
+        return;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+    if (!mapping) {
+        CloseHandle(file);
+        return;
+    }
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+    if (!view) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return;
+    }
+
+    m_data = static_cast<unsigned char*>(view);
+    m_size = static_cast<size_t>(size.QuadPart);
+    m_fileHandle = file;
+    m_mappingHandle = mapping;
+}
+
+MappedFile::~MappedFile() {
+    if (m_data) {
+        UnmapViewOfFile(m_data);
+        CloseHandle(m_mappingHandle);
+        CloseHandle(m_fileHandle);
+    }
+}
+
+#else
+
+MappedFile::MappedFile(const std::string& path)
+    : m_data(nullptr), m_size(0) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        close(fd);
+        return;
+    }
+
+    // MAP_PRIVATE + PROT_WRITE gives copy-on-write pages; the file itself is never modified
+    void* mapped = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (mapped == MAP_FAILED) {
+        return;
+    }
+
+    m_data = static_cast<unsigned char*>(mapped);
+    m_size = static_cast<size_t>(info.st_size);
+}
+
+MappedFile::~MappedFile() {
+    if (m_data) {
+        munmap(m_data, m_size);
+    }
+}
+
+#endif
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// Read-only file mapped into memory with copy-on-write pages.
+// Writes through getData() only touch a private copy of the affected page,
+// so callers can patch mapped data in place without modifying the file.
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool isOpen() const { return m_data != nullptr; }
+
+    unsigned char* getData() { return m_data; }
+    const unsigned char* getData() const { return m_data; }
+    size_t getSize() const { return m_size; }
+
+private:
+    unsigned char* m_data;
+    size_t m_size;
+
+#ifdef _WIN32
+    void* m_fileHandle;
+    void* m_mappingHandle;
+#endif
+};
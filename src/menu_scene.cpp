@@ -1,4 +1,5 @@
 #include "menu_scene.h"
+#include "ui_font.h"
 #include <raylib.h>
 #include <sstream>
 
@@ -301,26 +302,26 @@ void MenuScene::handleEquipmentInput() {
 }
 
 void MenuScene::drawMainMenu() {
-    DrawText("MENU", MENU_X, MENU_Y, 40, WHITE);
+    UIFont::drawText("MENU", MENU_X, MENU_Y, 40, WHITE);
 
     const char* menuItems[] = {"Status", "Items", "Equipment", "Save"};
 
     for (int i = 0; i < 4; i++) {
         Color color = (i == m_mainMenuSelection) ? YELLOW : WHITE;
         const char* prefix = (i == m_mainMenuSelection) ? "> " : "  ";
-        DrawText(TextFormat("%s%s", prefix, menuItems[i]), MENU_X, MENU_Y + 80 + i * LINE_HEIGHT, 24, color);
+        UIFont::drawText(TextFormat("%s%s", prefix, menuItems[i]), MENU_X, MENU_Y + 80 + i * LINE_HEIGHT, 24, color);
     }
 
-    DrawText("ESC: Close Menu", MENU_X, 550, 16, GRAY);
+    UIFont::drawText("ESC: Close Menu", MENU_X, 550, 16, GRAY);
 }
 
 void MenuScene::drawStatus() {
-    DrawText("STATUS", MENU_X, MENU_Y, 40, WHITE);
+    UIFont::drawText("STATUS", MENU_X, MENU_Y, 40, WHITE);
 
     const auto& activeParty = m_party->getActiveMembers();
     if (activeParty.empty()) {
-        DrawText("No party members!", MENU_X, MENU_Y + 80, 20, RED);
-        DrawText("ESC: Back", MENU_X, 550, 16, GRAY);
+        UIFont::drawText("No party members!", MENU_X, MENU_Y + 80, 20, RED);
+        UIFont::drawText("ESC: Back", MENU_X, 550, 16, GRAY);
         return;
     }
 
@@ -330,50 +331,50 @@ void MenuScene::drawStatus() {
     int yPos = MENU_Y + 80;
 
     // Name and class
-    DrawText(TextFormat("%s - %s", member->getName().c_str(), member->getClassName().c_str()), MENU_X, yPos, 24, YELLOW);
+    UIFont::drawText(TextFormat("%s - %s", member->getName().c_str(), member->getClassName().c_str()), MENU_X, yPos, 24, YELLOW);
     yPos += LINE_HEIGHT + 10;
 
     // Level and EXP
-    DrawText(TextFormat("Level: %d", stats.getLevel()), MENU_X, yPos, 20, WHITE);
+    UIFont::drawText(TextFormat("Level: %d", stats.getLevel()), MENU_X, yPos, 20, WHITE);
     yPos += LINE_HEIGHT;
-    DrawText(TextFormat("EXP: %d / %d", stats.getExperience(), stats.getExperienceToNextLevel()), MENU_X, yPos, 20, WHITE);
+    UIFont::drawText(TextFormat("EXP: %d / %d", stats.getExperience(), stats.getExperienceToNextLevel()), MENU_X, yPos, 20, WHITE);
     yPos += LINE_HEIGHT + 10;
 
     // HP and MP
-    DrawText(TextFormat("HP: %d / %d", stats.getHP(), stats.getMaxHP()), MENU_X, yPos, 20, GREEN);
+    UIFont::drawText(TextFormat("HP: %d / %d", stats.getHP(), stats.getMaxHP()), MENU_X, yPos, 20, GREEN);
     yPos += LINE_HEIGHT;
-    DrawText(TextFormat("MP: %d / %d", stats.getMP(), stats.getMaxMP()), MENU_X, yPos, 20, BLUE);
+    UIFont::drawText(TextFormat("MP: %d / %d", stats.getMP(), stats.getMaxMP()), MENU_X, yPos, 20, BLUE);
     yPos += LINE_HEIGHT + 10;
 
     // Stats
-    DrawText(TextFormat("Attack: %d", stats.getAttack()), MENU_X, yPos, 20, WHITE);
+    UIFont::drawText(TextFormat("Attack: %d", stats.getAttack()), MENU_X, yPos, 20, WHITE);
     yPos += LINE_HEIGHT;
-    DrawText(TextFormat("Defense: %d", stats.getDefense()), MENU_X, yPos, 20, WHITE);
+    UIFont::drawText(TextFormat("Defense: %d", stats.getDefense()), MENU_X, yPos, 20, WHITE);
     yPos += LINE_HEIGHT + 10;
 
     // Equipment
-    DrawText("Equipment:", MENU_X, yPos, 20, YELLOW);
+    UIFont::drawText("Equipment:", MENU_X, yPos, 20, YELLOW);
     yPos += LINE_HEIGHT;
 
     const Equipment* weapon = member->getWeapon();
     const Equipment* armor = member->getArmor();
     const Equipment* accessory = member->getAccessory();
 
-    DrawText(TextFormat("Weapon: %s", weapon ? weapon->getName().c_str() : "None"), MENU_X + 20, yPos, 18, WHITE);
+    UIFont::drawText(TextFormat("Weapon: %s", weapon ? weapon->getName().c_str() : "None"), MENU_X + 20, yPos, 18, WHITE);
     yPos += LINE_HEIGHT;
-    DrawText(TextFormat("Armor: %s", armor ? armor->getName().c_str() : "None"), MENU_X + 20, yPos, 18, WHITE);
+    UIFont::drawText(TextFormat("Armor: %s", armor ? armor->getName().c_str() : "None"), MENU_X + 20, yPos, 18, WHITE);
     yPos += LINE_HEIGHT;
-    DrawText(TextFormat("Accessory: %s", accessory ? accessory->getName().c_str() : "None"), MENU_X + 20, yPos, 18, WHITE);
+    UIFont::drawText(TextFormat("Accessory: %s", accessory ? accessory->getName().c_str() : "None"), MENU_X + 20, yPos, 18, WHITE);
 
     // Navigation hints
     if (activeParty.size() > 1) {
-        DrawText(TextFormat("< Member %d/%d >", m_statusPageIndex + 1, (int)activeParty.size()), MENU_X, 520, 18, GRAY);
+        UIFont::drawText(TextFormat("< Member %d/%d >", m_statusPageIndex + 1, (int)activeParty.size()), MENU_X, 520, 18, GRAY);
     }
-    DrawText("ESC: Back", MENU_X, 550, 16, GRAY);
+    UIFont::drawText("ESC: Back", MENU_X, 550, 16, GRAY);
 }
 
 void MenuScene::drawItems() {
-    DrawText("ITEMS", MENU_X, MENU_Y, 40, WHITE);
+    UIFont::drawText("ITEMS", MENU_X, MENU_Y, 40, WHITE);
 
     auto& slots = m_inventory->getItems();
     std::vector<int> validIndices;
@@ -386,8 +387,8 @@ void MenuScene::drawItems() {
     }
 
     if (validIndices.empty()) {
-        DrawText("No items in inventory!", MENU_X, MENU_Y + 80, 20, RED);
-        DrawText("ESC: Back", MENU_X, 550, 16, GRAY);
+        UIFont::drawText("No items in inventory!", MENU_X, MENU_Y + 80, 20, RED);
+        UIFont::drawText("ESC: Back", MENU_X, 550, 16, GRAY);
         return;
     }
 
@@ -405,7 +406,7 @@ void MenuScene::drawItems() {
         const Item* item = slots[slotIndex].item;
         const char* usable = item->isUsableInField() ? "" : " [Battle only]";
 
-        DrawText(TextFormat("%s%s x%d%s", prefix, item->getName().c_str(), slots[slotIndex].quantity, usable),
+        UIFont::drawText(TextFormat("%s%s x%d%s", prefix, item->getName().c_str(), slots[slotIndex].quantity, usable),
                  MENU_X, yPos, 20, color);
         yPos += LINE_HEIGHT;
     }
@@ -420,7 +421,7 @@ void MenuScene::drawItems() {
         DrawRectangle(overlayX, overlayY, overlayW, overlayH, Fade(BLACK, 0.9f));
         DrawRectangleLines(overlayX, overlayY, overlayW, overlayH, WHITE);
 
-        DrawText("Select Target:", overlayX + 10, overlayY + 10, 24, YELLOW);
+        UIFont::drawText("Select Target:", overlayX + 10, overlayY + 10, 24, YELLOW);
 
         const auto& activeParty = m_party->getActiveMembers();
         int targetY = overlayY + 50;
@@ -432,7 +433,7 @@ void MenuScene::drawItems() {
             PartyMember* member = activeParty[i];
             const CharacterStats& stats = member->getStats();
 
-            DrawText(TextFormat("%s%s - HP:%d/%d MP:%d/%d",
+            UIFont::drawText(TextFormat("%s%s - HP:%d/%d MP:%d/%d",
                      prefix, member->getName().c_str(),
                      stats.getHP(), stats.getMaxHP(),
                      stats.getMP(), stats.getMaxMP()),
@@ -440,24 +441,24 @@ void MenuScene::drawItems() {
             targetY += LINE_HEIGHT;
         }
 
-        DrawText("ENTER: Use  ESC: Cancel", overlayX + 10, overlayY + overlayH - 30, 14, GRAY);
+        UIFont::drawText("ENTER: Use  ESC: Cancel", overlayX + 10, overlayY + overlayH - 30, 14, GRAY);
     }
 
-    DrawText("ESC: Back", MENU_X, 550, 16, GRAY);
+    UIFont::drawText("ESC: Back", MENU_X, 550, 16, GRAY);
 }
 
 void MenuScene::drawEquipment() {
-    DrawText("EQUIPMENT", MENU_X, MENU_Y, 40, WHITE);
+    UIFont::drawText("EQUIPMENT", MENU_X, MENU_Y, 40, WHITE);
 
     const auto& activeParty = m_party->getActiveMembers();
     if (activeParty.empty()) {
-        DrawText("No party members!", MENU_X, MENU_Y + 80, 20, RED);
-        DrawText("ESC: Back", MENU_X, 550, 16, GRAY);
+        UIFont::drawText("No party members!", MENU_X, MENU_Y + 80, 20, RED);
+        UIFont::drawText("ESC: Back", MENU_X, 550, 16, GRAY);
         return;
     }
 
     if (m_equipmentMenuMode == EquipmentMenuMode::SELECT_MEMBER) {
-        DrawText("Select party member:", MENU_X, MENU_Y + 80, 24, YELLOW);
+        UIFont::drawText("Select party member:", MENU_X, MENU_Y + 80, 24, YELLOW);
 
         int yPos = MENU_Y + 120;
         for (size_t i = 0; i < activeParty.size(); i++) {
@@ -466,15 +467,15 @@ void MenuScene::drawEquipment() {
             const char* prefix = isSelected ? "> " : "  ";
 
             PartyMember* member = activeParty[i];
-            DrawText(TextFormat("%s%s - %s", prefix, member->getName().c_str(), member->getClassName().c_str()),
+            UIFont::drawText(TextFormat("%s%s - %s", prefix, member->getName().c_str(), member->getClassName().c_str()),
                      MENU_X, yPos, 20, color);
             yPos += LINE_HEIGHT;
         }
 
-        DrawText("ESC: Back", MENU_X, 550, 16, GRAY);
+        UIFont::drawText("ESC: Back", MENU_X, 550, 16, GRAY);
     } else if (m_equipmentMenuMode == EquipmentMenuMode::SELECT_SLOT) {
         PartyMember* member = activeParty[m_equipmentMemberSelection];
-        DrawText(TextFormat("%s - Select slot:", member->getName().c_str()), MENU_X, MENU_Y + 80, 24, YELLOW);
+        UIFont::drawText(TextFormat("%s - Select slot:", member->getName().c_str()), MENU_X, MENU_Y + 80, 24, YELLOW);
 
         const char* slotNames[] = {"Weapon", "Armor", "Accessory"};
         const Equipment* equipped[] = {member->getWeapon(), member->getArmor(), member->getAccessory()};
@@ -486,12 +487,12 @@ void MenuScene::drawEquipment() {
             const char* prefix = isSelected ? "> " : "  ";
 
             const char* equipName = equipped[i] ? equipped[i]->getName().c_str() : "None";
-            DrawText(TextFormat("%s%s: %s", prefix, slotNames[i], equipName),
+            UIFont::drawText(TextFormat("%s%s: %s", prefix, slotNames[i], equipName),
                      MENU_X, yPos, 20, color);
             yPos += LINE_HEIGHT;
         }
 
-        DrawText("ENTER: Change  X: Unequip  ESC: Back", MENU_X, 550, 16, GRAY);
+        UIFont::drawText("ENTER: Change  X: Unequip  ESC: Back", MENU_X, 550, 16, GRAY);
     } else if (m_equipmentMenuMode == EquipmentMenuMode::SELECT_EQUIPMENT) {
         PartyMember* member = activeParty[m_equipmentMemberSelection];
 
@@ -512,7 +513,7 @@ void MenuScene::drawEquipment() {
                 break;
         }
 
-        DrawText(TextFormat("%s - Select %s:", member->getName().c_str(), slotName), MENU_X, MENU_Y + 80, 24, YELLOW);
+        UIFont::drawText(TextFormat("%s - Select %s:", member->getName().c_str(), slotName), MENU_X, MENU_Y + 80, 24, YELLOW);
 
         // Build compatible equipment list
         auto& slots = m_inventory->getItems();
@@ -528,7 +529,7 @@ void MenuScene::drawEquipment() {
         }
 
         if (compatibleEquipment.empty()) {
-            DrawText("No compatible equipment!", MENU_X, MENU_Y + 120, 20, RED);
+            UIFont::drawText("No compatible equipment!", MENU_X, MENU_Y + 120, 20, RED);
         } else {
             int yPos = MENU_Y + 120;
             int displayCount = std::min(ITEMS_PER_PAGE, static_cast<int>(compatibleEquipment.size()) - m_equipmentScrollOffset);
@@ -547,21 +548,21 @@ void MenuScene::drawEquipment() {
                 if (equip->getHPBonus() > 0) statBonus << " HP+" << equip->getHPBonus();
                 if (equip->getMPBonus() > 0) statBonus << " MP+" << equip->getMPBonus();
 
-                DrawText(TextFormat("%s%s%s", prefix, equip->getName().c_str(), statBonus.str().c_str()),
+                UIFont::drawText(TextFormat("%s%s%s", prefix, equip->getName().c_str(), statBonus.str().c_str()),
                          MENU_X, yPos, 20, color);
                 yPos += LINE_HEIGHT;
             }
         }
 
-        DrawText("ESC: Back", MENU_X, 550, 16, GRAY);
+        UIFont::drawText("ESC: Back", MENU_X, 550, 16, GRAY);
     }
 }
 
 void MenuScene::drawSave() {
-    DrawText("SAVE", MENU_X, MENU_Y, 40, WHITE);
-    DrawText("Save system not yet implemented.", MENU_X, MENU_Y + 80, 24, YELLOW);
-    DrawText("This will be added in Phase 6: Persistence & Polish", MENU_X, MENU_Y + 120, 20, GRAY);
-    DrawText("ESC: Back", MENU_X, 550, 16, GRAY);
+    UIFont::drawText("SAVE", MENU_X, MENU_Y, 40, WHITE);
+    UIFont::drawText("Save system not yet implemented.", MENU_X, MENU_Y + 80, 24, YELLOW);
+    UIFont::drawText("This will be added in Phase 6: Persistence & Polish", MENU_X, MENU_Y + 120, 20, GRAY);
+    UIFont::drawText("ESC: Back", MENU_X, 550, 16, GRAY);
 }
 
 void MenuScene::returnToPreviousScene() {
@@ -0,0 +1,43 @@
+#include "occupancy_grid.h"
+#include <algorithm>
+
+OccupancyGrid::OccupancyGrid(int width, int height)
+    : m_width(std::max(0, width))
+    , m_height(std::max(0, height))
+    , m_chunksX((m_width + TileChunk::SIZE - 1) / TileChunk::SIZE)
+    , m_chunkBlocks(static_cast<size_t>(m_chunksX) * ((m_height + TileChunk::SIZE - 1) / TileChunk::SIZE), NO_BLOCK)
+    , m_occupiedCount(0) {
+}
+
+void OccupancyGrid::setOccupied(int x, int y, bool occupied) {
+    if (x < 0 || y < 0 || x >= m_width || y >= m_height) {
+        return;
+    }
+    uint32_t& block = m_chunkBlocks[static_cast<size_t>(y / TileChunk::SIZE) * m_chunksX + x / TileChunk::SIZE];
+    if (block == NO_BLOCK) {
+        if (!occupied) {
+            return;
+        }
+        // Blocks are kept once allocated; the chunks entities visit are few
+        block = static_cast<uint32_t>(m_blocks.size());
+        m_blocks.emplace_back();
+    }
+
+    uint32_t& row = m_blocks[block].rows[y % TileChunk::SIZE];
+    uint32_t bit = 1u << (x % TileChunk::SIZE);
+    if (((row & bit) != 0) == occupied) {
+        return;
+    }
+    row ^= bit;
+    m_occupiedCount += occupied ? 1 : -1;
+}
+
+void OccupancyGrid::clear() {
+    std::fill(m_chunkBlocks.begin(), m_chunkBlocks.end(), NO_BLOCK);
+    m_blocks.clear();
+    m_occupiedCount = 0;
+}
+
+size_t OccupancyGrid::getMemoryUsage() const {
+    return m_chunkBlocks.capacity() * sizeof(uint32_t) + m_blocks.capacity() * sizeof(Block);
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "tile_layer.h"
+#include <cstdint>
+#include <vector>
+
+// Which tiles an entity (the player, an NPC) stands on or is stepping to, so movement
+// and pathfinding can treat them as blocked with one lookup.
+//
+// Kept next to the Tilemap's collision instead of in it: entities move every frame, and
+// bumping collision revisions that often would keep rebuilding pathfinder clusters and
+// collision snapshots. Bits live in 32x32 blocks, one per TileChunk, allocated the first
+// time something stands in that chunk, so a huge map with a few crowds stays small.
+class OccupancyGrid {
+public:
+    OccupancyGrid(int width, int height);
+
+    bool isOccupied(int x, int y) const {
+        if (x < 0 || y < 0 || x >= m_width || y >= m_height) {
+            return false;
+        }
+        uint32_t block = m_chunkBlocks[static_cast<size_t>(y / TileChunk::SIZE) * m_chunksX + x / TileChunk::SIZE];
+        return block != NO_BLOCK && ((m_blocks[block].rows[y % TileChunk::SIZE] >> (x % TileChunk::SIZE)) & 1);
+    }
+
+    // Coordinates outside the map are ignored
+    void setOccupied(int x, int y, bool occupied);
+    void clear();
+
+    int getOccupiedCount() const { return m_occupiedCount; }
+    size_t getMemoryUsage() const;
+
+private:
+    static constexpr uint32_t NO_BLOCK = 0xFFFFFFFF;
+    static_assert(TileChunk::SIZE == 32, "a block row is one 32-bit word");
+
+    struct Block {
+        uint32_t rows[TileChunk::SIZE] = {};
+    };
+
+    int m_width;
+    int m_height;
+    int m_chunksX;
+    std::vector<uint32_t> m_chunkBlocks; // Per chunk, index into m_blocks or NO_BLOCK
+    std::vector<Block> m_blocks;
+    int m_occupiedCount;
+};
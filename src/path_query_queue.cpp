@@ -0,0 +1,197 @@
+#include "path_query_queue.h"
+#include "tilemap.h"
+#include <algorithm>
+#include <cstring>
+
+PathQueryQueue::Snapshot::Snapshot(const Tilemap& tilemap)
+    : collision(tilemap.getCollision().getWidth(), tilemap.getCollision().getHeight())
+    , revisions(tilemap.getCollisionRevisions()) {
+    std::memcpy(collision.getWords(), tilemap.getCollision().getWords(), collision.getWordCount() * sizeof(uint64_t));
+}
+
+PathQueryQueue::PathQueryQueue(const Tilemap& tilemap, int workerCount)
+    : m_tilemap(tilemap)
+    , m_snapshot(std::make_shared<Snapshot>(tilemap))
+    , m_snapshotMapRevision(tilemap.getRevision())
+    , m_nextHandle(INVALID_PATH_HANDLE + 1)
+    , m_resultBudget(DEFAULT_RESULT_BUDGET)
+    , m_pendingCount(0)
+    , m_lastDelivered(0)
+    , m_snapshotCopies(1)
+    , m_stopping(false) {
+    for (int i = 0; i < std::max(1, workerCount); i++) {
+        m_workers.emplace_back(&PathQueryQueue::workerLoop, this);
+    }
+}
+
+PathQueryQueue::~PathQueryQueue() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+    for (std::thread& worker : m_workers) {
+        worker.join();
+    }
+}
+
+PathHandle PathQueryQueue::request(TilePoint start, TilePoint goal) {
+    PathHandle handle = m_nextHandle++;
+    if (m_nextHandle == INVALID_PATH_HANDLE) {
+        m_nextHandle++;
+    }
+    m_requests[handle] = Request();
+    m_pendingCount++;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_jobs.push_back({handle, start, goal, m_snapshot});
+    }
+    m_wake.notify_one();
+    return handle;
+}
+
+void PathQueryQueue::cancel(PathHandle handle) {
+    auto it = m_requests.find(handle);
+    if (it == m_requests.end()) {
+        return;
+    }
+    if (it->second.status == PathStatus::PENDING) {
+        m_pendingCount--;
+        // Not started yet: no worker needs to see it at all
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto job = std::find_if(m_jobs.begin(), m_jobs.end(), [handle](const Job& j) { return j.handle == handle; });
+        if (job != m_jobs.end()) {
+            m_jobs.erase(job);
+        }
+    }
+    m_requests.erase(it);
+}
+
+void PathQueryQueue::beginFrame() {
+    refreshSnapshot();
+
+    m_lastDelivered = 0;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    while (!m_results.empty() && m_lastDelivered < m_resultBudget) {
+        Result& result = m_results.front();
+        auto it = m_requests.find(result.handle);
+        // Cancelled while a worker was on it
+        if (it != m_requests.end()) {
+            it->second.status = result.found ? PathStatus::FOUND : PathStatus::NOT_FOUND;
+            it->second.path = std::move(result.path);
+            m_pendingCount--;
+            m_lastDelivered++;
+        }
+        m_results.pop_front();
+    }
+}
+
+PathStatus PathQueryQueue::getStatus(PathHandle handle) const {
+    auto it = m_requests.find(handle);
+    return it != m_requests.end() ? it->second.status : PathStatus::UNKNOWN;
+}
+
+bool PathQueryQueue::takePath(PathHandle handle, std::vector<TilePoint>& path) {
+    auto it = m_requests.find(handle);
+    if (it == m_requests.end() || it->second.status == PathStatus::PENDING) {
+        return false;
+    }
+    bool found = it->second.status == PathStatus::FOUND;
+    path = std::move(it->second.path);
+    m_requests.erase(it);
+    return found;
+}
+
+void PathQueryQueue::refreshSnapshot() {
+    // Tile edits and streamed chunks bump the map revision; most leave collision alone
+    if (m_tilemap.getRevision() == m_snapshotMapRevision) {
+        return;
+    }
+    m_snapshotMapRevision = m_tilemap.getRevision();
+    if (m_tilemap.getCollisionRevisions() == m_snapshot->revisions) {
+        return;
+    }
+
+    // Workers drop their references under the mutex, so once only the queue holds the
+    // spare, every read of it has finished and no job can pick it up again
+    bool spareIdle = false;
+    if (m_spare) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        spareIdle = m_spare.use_count() == 1;
+    }
+    if (spareIdle) {
+        patchSnapshot(*m_spare);
+        std::swap(m_snapshot, m_spare);
+    } else {
+        m_spare = std::move(m_snapshot);
+        m_snapshot = std::make_shared<Snapshot>(m_tilemap);
+        m_snapshotCopies++;
+    }
+}
+
+void PathQueryQueue::patchSnapshot(Snapshot& snapshot) const {
+    const CollisionBitmap& live = m_tilemap.getCollision();
+    const std::vector<uint32_t>& liveRevisions = m_tilemap.getCollisionRevisions();
+    int chunksX = m_tilemap.getChunksX();
+    int chunksY = m_tilemap.getChunksY();
+    int wordsPerRow = live.getWordsPerRow();
+    uint64_t* words = snapshot.collision.getWords();
+
+    // A 64-bit word spans two chunk columns, so chunks are copied in pairs and both
+    // take the live revision. That keeps every revision true to the bits it covers.
+    static_assert(TileChunk::SIZE * 2 == 64, "collision words must cover two chunk columns");
+    for (int cy = 0; cy < chunksY; cy++) {
+        for (int word = 0; word < wordsPerRow; word++) {
+            int first = cy * chunksX + word * 2;
+            int count = std::min(2, chunksX - word * 2);
+            bool changed = false;
+            for (int i = 0; i < count; i++) {
+                changed |= snapshot.revisions[first + i] != liveRevisions[first + i];
+            }
+            if (!changed) {
+                continue;
+            }
+            int y1 = std::min((cy + 1) * TileChunk::SIZE, live.getHeight());
+            for (int y = cy * TileChunk::SIZE; y < y1; y++) {
+                words[static_cast<size_t>(y) * wordsPerRow + word] = live.getRow(y)[word];
+            }
+            for (int i = 0; i < count; i++) {
+                snapshot.revisions[first + i] = liveRevisions[first + i];
+            }
+        }
+    }
+}
+
+void PathQueryQueue::workerLoop() {
+    // Created with the first job; the snapshot it points at changes per job
+    std::unique_ptr<Pathfinder> pathfinder;
+
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [this] { return m_stopping || !m_jobs.empty(); });
+            if (m_stopping) {
+                return;
+            }
+            job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+        }
+
+        if (!pathfinder) {
+            pathfinder = std::make_unique<Pathfinder>(job.snapshot->collision, job.snapshot->revisions);
+        } else {
+            pathfinder->setCollision(job.snapshot->collision, job.snapshot->revisions);
+        }
+
+        Result result;
+        result.handle = job.handle;
+        result.found = pathfinder->findPath(job.start, job.goal, result.path);
+
+        // Let go of the snapshot under the lock; refreshSnapshot() relies on it
+        std::lock_guard<std::mutex> lock(m_mutex);
+        job.snapshot.reset();
+        m_results.push_back(std::move(result));
+    }
+}
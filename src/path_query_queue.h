@@ -0,0 +1,123 @@
+#pragma once
+
+#include "pathfinder.h"
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using PathHandle = uint32_t;
+constexpr PathHandle INVALID_PATH_HANDLE = 0;
+
+enum class PathStatus {
+    UNKNOWN,    // Never requested, cancelled or already taken
+    PENDING,    // Queued or being solved
+    FOUND,
+    NOT_FOUND
+};
+
+// Solves path requests on worker threads so many routes per frame don't stall the game.
+//
+// Workers never look at the Tilemap. They route over a snapshot of its collision that
+// beginFrame() refreshes on the main thread when walkability changed; requests made
+// during a frame see the collision as of that frame's start. A snapshot no worker holds
+// any more is patched chunk by chunk and reused, so a setTile does not copy the whole map.
+// Each worker keeps its own Pathfinder, whose clusters survive snapshot switches as long
+// as their chunks' collision revisions match.
+// Entities (OccupancyGrid) are not part of the snapshot: they will have moved by the time
+// a route arrives, so movers check occupancy step by step instead.
+//
+// Finished routes become visible in beginFrame(), at most getResultBudget() per frame;
+// the rest wait for the next frame. All methods are for the main thread.
+class PathQueryQueue {
+public:
+    static constexpr int DEFAULT_WORKER_COUNT = 2;
+    static constexpr int DEFAULT_RESULT_BUDGET = 32;
+
+    // The tilemap must outlive the queue
+    explicit PathQueryQueue(const Tilemap& tilemap, int workerCount = DEFAULT_WORKER_COUNT);
+    ~PathQueryQueue();
+
+    PathQueryQueue(const PathQueryQueue&) = delete;
+    PathQueryQueue& operator=(const PathQueryQueue&) = delete;
+
+    PathHandle request(TilePoint start, TilePoint goal);
+
+    // Forgets the request; a route still being solved is dropped when it arrives
+    void cancel(PathHandle handle);
+
+    // Call at the start of each frame: picks up collision changes and delivers routes
+    // finished since the last call, up to the result budget
+    void beginFrame();
+
+    PathStatus getStatus(PathHandle handle) const;
+
+    // Moves a delivered route (same format as Pathfinder::findPath) into path and
+    // forgets the handle. Returns false unless the status was FOUND.
+    bool takePath(PathHandle handle, std::vector<TilePoint>& path);
+
+    void setResultBudget(int resultsPerFrame) { m_resultBudget = resultsPerFrame; }
+    int getResultBudget() const { return m_resultBudget; }
+
+    int getWorkerCount() const { return static_cast<int>(m_workers.size()); }
+    int getPendingCount() const { return m_pendingCount; }       // Requested, not delivered yet
+    int getLastDeliveredCount() const { return m_lastDelivered; } // In the last beginFrame()
+    int getSnapshotCopyCount() const { return m_snapshotCopies; }   // Full copies since creation
+
+private:
+    struct Snapshot {
+        explicit Snapshot(const Tilemap& tilemap);
+
+        CollisionBitmap collision;
+        std::vector<uint32_t> revisions;
+    };
+
+    struct Job {
+        PathHandle handle;
+        TilePoint start;
+        TilePoint goal;
+        std::shared_ptr<const Snapshot> snapshot;
+    };
+
+    struct Result {
+        PathHandle handle;
+        bool found;
+        std::vector<TilePoint> path;
+    };
+
+    struct Request {
+        PathStatus status = PathStatus::PENDING;
+        std::vector<TilePoint> path;
+    };
+
+    void workerLoop();
+    void refreshSnapshot();
+    // Brings a snapshot no worker holds up to date with the tilemap
+    void patchSnapshot(Snapshot& snapshot) const;
+
+    const Tilemap& m_tilemap;
+
+    // Main thread only
+    std::shared_ptr<Snapshot> m_snapshot;    // Given to new requests
+    std::shared_ptr<Snapshot> m_spare;       // The previous one, reused once workers let go
+    uint32_t m_snapshotMapRevision;          // Tilemap::getRevision() at the last refresh
+    std::unordered_map<PathHandle, Request> m_requests;
+    PathHandle m_nextHandle;
+    int m_resultBudget;
+    int m_pendingCount;
+    int m_lastDelivered;
+    int m_snapshotCopies;
+
+    // Shared with the workers, guarded by m_mutex
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::deque<Job> m_jobs;
+    std::deque<Result> m_results;
+    bool m_stopping;
+
+    std::vector<std::thread> m_workers;
+};
@@ -0,0 +1,491 @@
+#include "pathfinder.h"
+#include "tilemap.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+
+constexpr int UNVISITED_COST = 0x7FFFFFFF;
+const int DIRECTION_X[4] = {1, -1, 0, 0};
+const int DIRECTION_Y[4] = {0, 0, 1, -1};
+constexpr uint8_t NO_DIRECTION = 4;
+
+int heuristic(TilePoint from, TilePoint to) {
+    return std::abs(from.x - to.x) + std::abs(from.y - to.y);
+}
+
+// Min-heap on the estimate; among equal estimates the entry furthest along goes first
+struct OpenEntryOrder {
+    template <typename Entry>
+    bool operator()(const Entry& a, const Entry& b) const {
+        return a.estimate != b.estimate ? a.estimate > b.estimate : a.cost < b.cost;
+    }
+};
+
+} // namespace
+
+Pathfinder::Pathfinder(const CollisionBitmap& collision, const std::vector<uint32_t>& collisionRevisions)
+    : m_collision(&collision)
+    , m_collisionRevisions(&collisionRevisions)
+    , m_occupancy(nullptr)
+    , m_width(collision.getWidth())
+    , m_height(collision.getHeight())
+    , m_clustersX((collision.getWidth() + CLUSTER_SIZE - 1) / CLUSTER_SIZE)
+    , m_clustersY((collision.getHeight() + CLUSTER_SIZE - 1) / CLUSTER_SIZE)
+    , m_searchStamp(0)
+    , m_clusterDistances(CLUSTER_SIZE * CLUSTER_SIZE, UNREACHABLE)
+    , m_floodOrigin{0, 0}
+    , m_abstractStamp(0)
+    , m_lastExpandedNodes(0) {
+    size_t clusterCount = static_cast<size_t>(m_clustersX) * m_clustersY;
+    m_clusters.resize(clusterCount);
+    m_clusterRecordStamps.resize(clusterCount, 0);
+    m_clusterRecordBases.resize(clusterCount, 0);
+}
+
+Pathfinder::Pathfinder(const Tilemap& tilemap)
+    : Pathfinder(tilemap.getCollision(), tilemap.getCollisionRevisions()) {
+}
+
+void Pathfinder::setCollision(const CollisionBitmap& collision, const std::vector<uint32_t>& collisionRevisions) {
+    m_collision = &collision;
+    m_collisionRevisions = &collisionRevisions;
+}
+
+void Pathfinder::clear() {
+    m_clusters.assign(m_clusters.size(), Cluster());
+}
+
+int Pathfinder::getBuiltClusterCount() const {
+    int count = 0;
+    for (const Cluster& cluster : m_clusters) {
+        count += cluster.built ? 1 : 0;
+    }
+    return count;
+}
+
+bool Pathfinder::findPath(TilePoint start, TilePoint goal, std::vector<TilePoint>& path) {
+    path.clear();
+    m_lastExpandedNodes = 0;
+    if (start.x < 0 || start.y < 0 || start.x >= m_width || start.y >= m_height ||
+        goal.x < 0 || goal.y < 0 || goal.x >= m_width || goal.y >= m_height ||
+        !isWalkable(start.x, start.y) || !isWalkable(goal.x, goal.y)) {
+        return false;
+    }
+    if (start == goal) {
+        return true;
+    }
+
+    // Short hops: A* in a window around both ends is exact and cheap. If the only route
+    // leaves the window, fall through to the cluster graph.
+    if (heuristic(start, goal) <= DIRECT_SEARCH_DISTANCE) {
+        constexpr int MARGIN = CLUSTER_SIZE / 2;
+        int x0 = std::max(0, std::min(start.x, goal.x) - MARGIN);
+        int y0 = std::max(0, std::min(start.y, goal.y) - MARGIN);
+        int x1 = std::min(m_width, std::max(start.x, goal.x) + MARGIN + 1);
+        int y1 = std::min(m_height, std::max(start.y, goal.y) + MARGIN + 1);
+        if (searchArea(start, goal, x0, y0, x1, y1, true, path)) {
+            return true;
+        }
+        path.clear();
+    }
+
+    std::vector<uint32_t> nodes;
+    if (!findAbstractPath(start, goal, nodes)) {
+        return false;
+    }
+    if (!refineAbstractPath(start, goal, nodes, path)) {
+        path.clear();
+        return false;
+    }
+    return true;
+}
+
+bool Pathfinder::findPathInArea(TilePoint start, TilePoint goal, int areaX, int areaY, int areaWidth, int areaHeight,
+                                std::vector<TilePoint>& path) {
+    path.clear();
+    m_lastExpandedNodes = 0;
+    int x0 = std::max(0, areaX);
+    int y0 = std::max(0, areaY);
+    int x1 = std::min(m_width, areaX + areaWidth);
+    int y1 = std::min(m_height, areaY + areaHeight);
+    return searchArea(start, goal, x0, y0, x1, y1, true, path);
+}
+
+bool Pathfinder::searchArea(TilePoint start, TilePoint goal, int x0, int y0, int x1, int y1, bool avoidOccupied,
+                            std::vector<TilePoint>& path) {
+    auto inArea = [&](TilePoint tile) { return tile.x >= x0 && tile.x < x1 && tile.y >= y0 && tile.y < y1; };
+    if (!inArea(start) || !inArea(goal) || !isWalkable(start.x, start.y) || !isWalkable(goal.x, goal.y)) {
+        return false;
+    }
+    if (start == goal) {
+        return true;
+    }
+
+    int areaWidth = x1 - x0;
+    size_t areaSize = static_cast<size_t>(areaWidth) * (y1 - y0);
+    if (m_searchStamps.size() < areaSize) {
+        m_searchStamps.assign(areaSize, 0);
+        m_searchCosts.resize(areaSize);
+        m_searchParents.resize(areaSize);
+        m_searchStamp = 0;
+    }
+    if (++m_searchStamp == 0) {
+        std::fill(m_searchStamps.begin(), m_searchStamps.end(), 0);
+        m_searchStamp = 1;
+    }
+
+    auto indexOf = [&](int x, int y) { return static_cast<uint32_t>((y - y0) * areaWidth + (x - x0)); };
+    const OccupancyGrid* occupancy = avoidOccupied ? m_occupancy : nullptr;
+    uint32_t startIndex = indexOf(start.x, start.y);
+    uint32_t goalIndex = indexOf(goal.x, goal.y);
+    m_searchStamps[startIndex] = m_searchStamp;
+    m_searchCosts[startIndex] = 0;
+    m_searchParents[startIndex] = NO_DIRECTION;
+
+    m_open.clear();
+    m_open.push_back({heuristic(start, goal), 0, startIndex});
+    bool found = false;
+    while (!m_open.empty()) {
+        std::pop_heap(m_open.begin(), m_open.end(), OpenEntryOrder());
+        OpenEntry entry = m_open.back();
+        m_open.pop_back();
+        if (entry.cost > m_searchCosts[entry.node]) {
+            continue; // Superseded by a cheaper entry
+        }
+        m_lastExpandedNodes++;
+        if (entry.node == goalIndex) {
+            found = true;
+            break;
+        }
+
+        int x = x0 + static_cast<int>(entry.node) % areaWidth;
+        int y = y0 + static_cast<int>(entry.node) / areaWidth;
+        for (int d = 0; d < 4; d++) {
+            int nx = x + DIRECTION_X[d];
+            int ny = y + DIRECTION_Y[d];
+            if (nx < x0 || nx >= x1 || ny < y0 || ny >= y1 || !isWalkable(nx, ny)) {
+                continue;
+            }
+            uint32_t next = indexOf(nx, ny);
+            if (occupancy && next != goalIndex && occupancy->isOccupied(nx, ny)) {
+                continue;
+            }
+            int cost = entry.cost + 1;
+            if (m_searchStamps[next] != m_searchStamp || cost < m_searchCosts[next]) {
+                m_searchStamps[next] = m_searchStamp;
+                m_searchCosts[next] = cost;
+                m_searchParents[next] = static_cast<uint8_t>(d);
+                m_open.push_back({cost + heuristic({nx, ny}, goal), cost, next});
+                std::push_heap(m_open.begin(), m_open.end(), OpenEntryOrder());
+            }
+        }
+    }
+    if (!found) {
+        return false;
+    }
+
+    // Walk the parent directions back from the goal, then flip the steps into place
+    size_t first = path.size();
+    TilePoint tile = goal;
+    while (tile != start) {
+        path.push_back(tile);
+        uint8_t d = m_searchParents[indexOf(tile.x, tile.y)];
+        tile.x -= DIRECTION_X[d];
+        tile.y -= DIRECTION_Y[d];
+    }
+    std::reverse(path.begin() + first, path.end());
+    return true;
+}
+
+void Pathfinder::getClusterRevisions(int clusterX, int clusterY, uint32_t* revisions) const {
+    auto revisionAt = [&](int cx, int cy) {
+        if (cx < 0 || cy < 0 || cx >= m_clustersX || cy >= m_clustersY) {
+            return uint32_t(0);
+        }
+        return (*m_collisionRevisions)[static_cast<size_t>(cy) * m_clustersX + cx];
+    };
+    revisions[0] = revisionAt(clusterX, clusterY);
+    revisions[1] = revisionAt(clusterX - 1, clusterY);
+    revisions[2] = revisionAt(clusterX + 1, clusterY);
+    revisions[3] = revisionAt(clusterX, clusterY - 1);
+    revisions[4] = revisionAt(clusterX, clusterY + 1);
+}
+
+Pathfinder::Cluster& Pathfinder::ensureCluster(int clusterIndex) {
+    Cluster& cluster = m_clusters[clusterIndex];
+    uint32_t revisions[5];
+    getClusterRevisions(clusterIndex % m_clustersX, clusterIndex / m_clustersX, revisions);
+    if (!cluster.built || !std::equal(revisions, revisions + 5, cluster.revisions)) {
+        buildCluster(clusterIndex, cluster);
+        std::copy(revisions, revisions + 5, cluster.revisions);
+    }
+    return cluster;
+}
+
+void Pathfinder::buildCluster(int clusterIndex, Cluster& cluster) {
+    int x0 = (clusterIndex % m_clustersX) * CLUSTER_SIZE;
+    int y0 = (clusterIndex / m_clustersX) * CLUSTER_SIZE;
+    int x1 = std::min(x0 + CLUSTER_SIZE, m_width) - 1;
+    int y1 = std::min(y0 + CLUSTER_SIZE, m_height) - 1;
+    int width = x1 - x0 + 1;
+    int height = y1 - y0 + 1;
+
+    // Neighbouring clusters scan the same tile pairs, so both sides agree on the transitions
+    cluster.entrances.clear();
+    if (x0 > 0) {
+        addBorderEntrances(cluster, {x0, y0}, 0, 1, height, -1, 0);
+    }
+    if (x1 + 1 < m_width) {
+        addBorderEntrances(cluster, {x1, y0}, 0, 1, height, 1, 0);
+    }
+    if (y0 > 0) {
+        addBorderEntrances(cluster, {x0, y0}, 1, 0, width, 0, -1);
+    }
+    if (y1 + 1 < m_height) {
+        addBorderEntrances(cluster, {x0, y1}, 1, 0, width, 0, 1);
+    }
+
+    size_t count = cluster.entrances.size();
+    m_entranceDistances.resize(count * count);
+    for (size_t i = 0; i < count; i++) {
+        floodCluster(cluster.entrances[i].inside);
+        for (size_t j = 0; j < count; j++) {
+            m_entranceDistances[i * count + j] = getFloodDistance(cluster.entrances[j].inside);
+        }
+    }
+
+    // Keep i -> j unless a third entrance m lies on a shortest route between them.
+    // Both halves are strictly shorter, so the edges they stand for are kept or again
+    // covered by shorter ones, and every distance survives. Zero-length pairs (a corner
+    // tile that is an entrance on two borders) always stay.
+    cluster.edgeStarts.assign(1, 0);
+    cluster.edges.clear();
+    for (size_t i = 0; i < count; i++) {
+        for (size_t j = 0; j < count; j++) {
+            uint16_t distance = m_entranceDistances[i * count + j];
+            if (i == j || distance == UNREACHABLE) {
+                continue;
+            }
+            bool redundant = false;
+            for (size_t m = 0; m < count && !redundant; m++) {
+                uint16_t first = m_entranceDistances[i * count + m];
+                uint16_t second = m_entranceDistances[m * count + j];
+                redundant = m != i && m != j && first != UNREACHABLE && second != UNREACHABLE &&
+                            first > 0 && second > 0 && first + second == distance;
+            }
+            if (!redundant) {
+                cluster.edges.push_back({static_cast<uint8_t>(j), distance});
+            }
+        }
+        cluster.edgeStarts.push_back(static_cast<uint16_t>(cluster.edges.size()));
+    }
+    cluster.built = true;
+}
+
+void Pathfinder::addBorderEntrances(Cluster& cluster, TilePoint first, int stepX, int stepY, int length,
+                                    int outsideX, int outsideY) {
+    auto addEntrance = [&](int i) {
+        TilePoint inside = {first.x + stepX * i, first.y + stepY * i};
+        cluster.entrances.push_back({inside, {inside.x + outsideX, inside.y + outsideY}});
+    };
+
+    int runStart = -1;
+    for (int i = 0; i <= length; i++) {
+        int x = first.x + stepX * i;
+        int y = first.y + stepY * i;
+        bool open = i < length && isWalkable(x, y) && isWalkable(x + outsideX, y + outsideY);
+        if (open && runStart < 0) {
+            runStart = i;
+        } else if (!open && runStart >= 0) {
+            int runLength = i - runStart;
+            if (runLength <= MAX_SINGLE_ENTRANCE_WIDTH) {
+                addEntrance(runStart + (runLength - 1) / 2);
+            } else {
+                addEntrance(runStart);
+                addEntrance(i - 1);
+            }
+            runStart = -1;
+        }
+    }
+}
+
+void Pathfinder::floodCluster(TilePoint from) {
+    m_floodOrigin = {from.x / CLUSTER_SIZE * CLUSTER_SIZE, from.y / CLUSTER_SIZE * CLUSTER_SIZE};
+    int width = std::min(CLUSTER_SIZE, m_width - m_floodOrigin.x);
+    int height = std::min(CLUSTER_SIZE, m_height - m_floodOrigin.y);
+    std::fill(m_clusterDistances.begin(), m_clusterDistances.end(), UNREACHABLE);
+
+    // Breadth-first: every step costs the same
+    m_floodQueue.clear();
+    int origin = (from.y - m_floodOrigin.y) * CLUSTER_SIZE + (from.x - m_floodOrigin.x);
+    m_clusterDistances[origin] = 0;
+    m_floodQueue.push_back(origin);
+    for (size_t head = 0; head < m_floodQueue.size(); head++) {
+        int local = m_floodQueue[head];
+        int lx = local % CLUSTER_SIZE;
+        int ly = local / CLUSTER_SIZE;
+        for (int d = 0; d < 4; d++) {
+            int nx = lx + DIRECTION_X[d];
+            int ny = ly + DIRECTION_Y[d];
+            if (nx < 0 || nx >= width || ny < 0 || ny >= height) {
+                continue;
+            }
+            int next = ny * CLUSTER_SIZE + nx;
+            if (m_clusterDistances[next] == UNREACHABLE && isWalkable(m_floodOrigin.x + nx, m_floodOrigin.y + ny)) {
+                m_clusterDistances[next] = static_cast<uint16_t>(m_clusterDistances[local] + 1);
+                m_floodQueue.push_back(next);
+            }
+        }
+    }
+}
+
+uint16_t Pathfinder::getFloodDistance(TilePoint tile) const {
+    return m_clusterDistances[(tile.y - m_floodOrigin.y) * CLUSTER_SIZE + (tile.x - m_floodOrigin.x)];
+}
+
+TilePoint Pathfinder::getNodeTile(uint32_t node, TilePoint goal) const {
+    if (node == GOAL_NODE) {
+        return goal;
+    }
+    return m_clusters[node / MAX_CLUSTER_ENTRANCES].entrances[node % MAX_CLUSTER_ENTRANCES].inside;
+}
+
+Pathfinder::AbstractRecord& Pathfinder::getAbstractRecord(uint32_t node) {
+    if (node == START_NODE || node == GOAL_NODE) {
+        return m_abstractRecords[node == START_NODE ? 0 : 1];
+    }
+    uint32_t clusterIndex = node / MAX_CLUSTER_ENTRANCES;
+    if (m_clusterRecordStamps[clusterIndex] != m_abstractStamp) {
+        m_clusterRecordStamps[clusterIndex] = m_abstractStamp;
+        m_clusterRecordBases[clusterIndex] = static_cast<uint32_t>(m_abstractRecords.size());
+        m_abstractRecords.resize(m_abstractRecords.size() + m_clusters[clusterIndex].entrances.size(),
+                                 {UNVISITED_COST, 0, false});
+    }
+    return m_abstractRecords[m_clusterRecordBases[clusterIndex] + node % MAX_CLUSTER_ENTRANCES];
+}
+
+bool Pathfinder::findAbstractPath(TilePoint start, TilePoint goal, std::vector<uint32_t>& nodes) {
+    int startIndex = getClusterIndex(start);
+    int goalIndex = getClusterIndex(goal);
+
+    // Hook start and goal into the graph: their distances to the entrances of their clusters
+    const Cluster& startCluster = ensureCluster(startIndex);
+    floodCluster(start);
+    m_startDistances.clear();
+    for (const Entrance& entrance : startCluster.entrances) {
+        m_startDistances.push_back(getFloodDistance(entrance.inside));
+    }
+    uint16_t directDistance = startIndex == goalIndex ? getFloodDistance(goal) : UNREACHABLE;
+
+    const Cluster& goalCluster = ensureCluster(goalIndex);
+    floodCluster(goal);
+    m_goalDistances.clear();
+    for (const Entrance& entrance : goalCluster.entrances) {
+        m_goalDistances.push_back(getFloodDistance(entrance.inside));
+    }
+
+    if (++m_abstractStamp == 0) {
+        std::fill(m_clusterRecordStamps.begin(), m_clusterRecordStamps.end(), 0);
+        m_abstractStamp = 1;
+    }
+    m_abstractRecords.assign(2, {UNVISITED_COST, 0, false});
+    m_open.clear();
+    auto relax = [&](uint32_t node, int cost, uint32_t parent, TilePoint tile) {
+        AbstractRecord& record = getAbstractRecord(node);
+        if (record.closed || record.cost <= cost) {
+            return;
+        }
+        record = {cost, parent, false};
+        m_open.push_back({cost + heuristic(tile, goal), cost, node});
+        std::push_heap(m_open.begin(), m_open.end(), OpenEntryOrder());
+    };
+
+    relax(START_NODE, 0, START_NODE, start);
+    while (!m_open.empty()) {
+        std::pop_heap(m_open.begin(), m_open.end(), OpenEntryOrder());
+        OpenEntry entry = m_open.back();
+        m_open.pop_back();
+        AbstractRecord& record = getAbstractRecord(entry.node);
+        if (record.closed || entry.cost > record.cost) {
+            continue;
+        }
+        record.closed = true;
+        m_lastExpandedNodes++;
+
+        if (entry.node == GOAL_NODE) {
+            for (uint32_t node = GOAL_NODE; node != START_NODE; node = getAbstractRecord(node).parent) {
+                nodes.push_back(node);
+            }
+            nodes.push_back(START_NODE);
+            std::reverse(nodes.begin(), nodes.end());
+            return true;
+        }
+
+        if (entry.node == START_NODE) {
+            for (size_t i = 0; i < m_startDistances.size(); i++) {
+                if (m_startDistances[i] != UNREACHABLE) {
+                    relax(static_cast<uint32_t>(startIndex * MAX_CLUSTER_ENTRANCES + i), m_startDistances[i],
+                          START_NODE, startCluster.entrances[i].inside);
+                }
+            }
+            if (directDistance != UNREACHABLE) {
+                relax(GOAL_NODE, directDistance, START_NODE, goal);
+            }
+            continue;
+        }
+
+        int clusterIndex = static_cast<int>(entry.node / MAX_CLUSTER_ENTRANCES);
+        size_t i = entry.node % MAX_CLUSTER_ENTRANCES;
+        const Cluster& cluster = m_clusters[clusterIndex];
+
+        // Other entrances of the same cluster
+        for (int e = cluster.edgeStarts[i]; e < cluster.edgeStarts[i + 1]; e++) {
+            const ClusterEdge& edge = cluster.edges[e];
+            relax(static_cast<uint32_t>(clusterIndex * MAX_CLUSTER_ENTRANCES + edge.to), entry.cost + edge.cost,
+                  entry.node, cluster.entrances[edge.to].inside);
+        }
+
+        // Step across the border into the neighbouring cluster
+        const Entrance& entrance = cluster.entrances[i];
+        int neighborIndex = getClusterIndex(entrance.outside);
+        const Cluster& neighbor = ensureCluster(neighborIndex);
+        for (size_t k = 0; k < neighbor.entrances.size(); k++) {
+            if (neighbor.entrances[k].inside == entrance.outside && neighbor.entrances[k].outside == entrance.inside) {
+                relax(static_cast<uint32_t>(neighborIndex * MAX_CLUSTER_ENTRANCES + k), entry.cost + 1,
+                      entry.node, entrance.outside);
+                break;
+            }
+        }
+
+        if (clusterIndex == goalIndex && m_goalDistances[i] != UNREACHABLE) {
+            relax(GOAL_NODE, entry.cost + m_goalDistances[i], entry.node, goal);
+        }
+    }
+    return false;
+}
+
+bool Pathfinder::refineAbstractPath(TilePoint start, TilePoint goal, const std::vector<uint32_t>& nodes,
+                                    std::vector<TilePoint>& path) {
+    TilePoint current = start;
+    for (size_t i = 1; i < nodes.size(); i++) {
+        TilePoint target = getNodeTile(nodes[i], goal);
+        if (target == current) {
+            continue; // Corner tile that is an entrance on two borders
+        }
+
+        int clusterIndex = getClusterIndex(current);
+        if (clusterIndex != getClusterIndex(target)) {
+            path.push_back(target); // Border crossing, always a single step
+        } else {
+            int x0 = (clusterIndex % m_clustersX) * CLUSTER_SIZE;
+            int y0 = (clusterIndex / m_clustersX) * CLUSTER_SIZE;
+            if (!searchArea(current, target, x0, y0, std::min(x0 + CLUSTER_SIZE, m_width),
+                            std::min(y0 + CLUSTER_SIZE, m_height), false, path)) {
+                return false;
+            }
+        }
+        current = target;
+    }
+    return true;
+}
@@ -0,0 +1,163 @@
+#pragma once
+
+#include "collision_bitmap.h"
+#include "occupancy_grid.h"
+#include "tile_layer.h"
+#include <cstdint>
+#include <vector>
+
+class Tilemap;
+
+struct TilePoint {
+    int x;
+    int y;
+
+    bool operator==(const TilePoint& other) const { return x == other.x && y == other.y; }
+    bool operator!=(const TilePoint& other) const { return !(*this == other); }
+};
+
+// Routes across a CollisionBitmap. Movement is 4-connected and every step costs 1,
+// like the player's.
+//
+// findPath() runs plain A* when both ends are close and HPA* otherwise: the map is cut
+// into chunk-sized clusters, and the walkable crossings on their borders ("entrances")
+// plus the distances between entrances of the same cluster form a small abstract graph.
+// Long routes search that graph, then run A* only inside the clusters the route crosses.
+//
+// Clusters are built the first time a search reaches them and remember the collision
+// revisions of their chunk and its four neighbours. A setTile that changes walkability
+// bumps one chunk's revision, so only the clusters around it rebuild on their next use.
+class Pathfinder {
+public:
+    // Revisions are per TileChunk, row-major. Both must outlive the pathfinder.
+    Pathfinder(const CollisionBitmap& collision, const std::vector<uint32_t>& collisionRevisions);
+    explicit Pathfinder(const Tilemap& tilemap);
+
+    // Switches to another copy of the same map's collision (e.g. a newer snapshot).
+    // Clusters whose revisions still match it are kept.
+    void setCollision(const CollisionBitmap& collision, const std::vector<uint32_t>& collisionRevisions);
+
+    // Fills path with the tiles after start, up to and including goal. Returns false if
+    // either end is blocked or no route exists. Routes are close to (not always) shortest.
+    bool findPath(TilePoint start, TilePoint goal, std::vector<TilePoint>& path);
+
+    // Shortest route that stays inside the area (clamped to the map), same path format
+    bool findPathInArea(TilePoint start, TilePoint goal, int areaX, int areaY, int areaWidth, int areaHeight,
+                        std::vector<TilePoint>& path);
+
+    // Entities to route around (may be null; must outlive its use). Occupied tiles other
+    // than the goal block the plain A* searches: short routes and findPathInArea. The
+    // cluster graph ignores them, since entities have moved on long before a long route
+    // gets there, so a short route that only exists through an entity falls back to it.
+    void setOccupancy(const OccupancyGrid* occupancy) { m_occupancy = occupancy; }
+
+    // Drops every cluster (they rebuild on demand)
+    void clear();
+
+    int getBuiltClusterCount() const;
+    int getLastExpandedNodes() const { return m_lastExpandedNodes; } // Tiles + abstract nodes, last query
+
+    static constexpr int CLUSTER_SIZE = TileChunk::SIZE;
+
+private:
+    // Openings up to this wide get one transition in the middle, wider ones one at each end
+    static constexpr int MAX_SINGLE_ENTRANCE_WIDTH = 6;
+    // At most 16 transitions per border of 32 tiles, so 64 per cluster
+    static constexpr int MAX_CLUSTER_ENTRANCES = 4 * CLUSTER_SIZE / 2;
+    // Routes shorter than this (Manhattan) try plain A* first
+    static constexpr int DIRECT_SEARCH_DISTANCE = 2 * CLUSTER_SIZE;
+    static constexpr uint16_t UNREACHABLE = 0xFFFF;
+    static constexpr uint32_t START_NODE = 0xFFFFFFFE;
+    static constexpr uint32_t GOAL_NODE = 0xFFFFFFFF;
+
+    struct Entrance {
+        TilePoint inside;   // Tile in this cluster
+        TilePoint outside;  // Walkable tile across the border
+    };
+
+    struct ClusterEdge {
+        uint8_t to;     // Entrance index
+        uint16_t cost;  // Walking inside the cluster
+    };
+
+    struct Cluster {
+        bool built = false;
+        uint32_t revisions[5] = {};         // Own chunk, then west, east, north and south
+        std::vector<Entrance> entrances;
+        // Edges of entrance i are edges[edgeStarts[i] .. edgeStarts[i + 1]). Edges that
+        // are as long as a detour through a third entrance are left out; the search
+        // finds the same distances through the detour.
+        std::vector<uint16_t> edgeStarts;
+        std::vector<ClusterEdge> edges;
+    };
+
+    struct AbstractRecord {
+        int cost;
+        uint32_t parent;
+        bool closed;
+    };
+
+    struct OpenEntry {
+        int estimate;   // Cost so far plus heuristic
+        int cost;
+        uint32_t node;
+    };
+
+    bool isWalkable(int x, int y) const { return !m_collision->test(x, y); }
+    int getClusterIndex(TilePoint tile) const {
+        return (tile.y / CLUSTER_SIZE) * m_clustersX + tile.x / CLUSTER_SIZE;
+    }
+    void getClusterRevisions(int clusterX, int clusterY, uint32_t* revisions) const;
+
+    Cluster& ensureCluster(int clusterIndex);
+    void buildCluster(int clusterIndex, Cluster& cluster);
+    // Walks one border of the cluster; outsideX/Y is the offset to the tile across it
+    void addBorderEntrances(Cluster& cluster, TilePoint first, int stepX, int stepY, int length,
+                            int outsideX, int outsideY);
+    // Distances from a tile to every tile of its cluster, in m_clusterDistances
+    void floodCluster(TilePoint from);
+    uint16_t getFloodDistance(TilePoint tile) const;
+
+    // A* limited to [x0, x1) x [y0, y1); appends the route after start to path
+    bool searchArea(TilePoint start, TilePoint goal, int x0, int y0, int x1, int y1, bool avoidOccupied,
+                    std::vector<TilePoint>& path);
+
+    TilePoint getNodeTile(uint32_t node, TilePoint goal) const;
+    // Record of an abstract node in the current search, created on first use
+    AbstractRecord& getAbstractRecord(uint32_t node);
+    bool findAbstractPath(TilePoint start, TilePoint goal, std::vector<uint32_t>& nodes);
+    bool refineAbstractPath(TilePoint start, TilePoint goal, const std::vector<uint32_t>& nodes,
+                            std::vector<TilePoint>& path);
+
+    const CollisionBitmap* m_collision;
+    const std::vector<uint32_t>* m_collisionRevisions;
+    const OccupancyGrid* m_occupancy;
+    int m_width;
+    int m_height;
+    int m_clustersX;
+    int m_clustersY;
+    std::vector<Cluster> m_clusters;
+
+    // Scratch space reused across queries. Tile search entries carry a stamp so they
+    // never need clearing.
+    std::vector<uint32_t> m_searchStamps;
+    std::vector<int> m_searchCosts;
+    std::vector<uint8_t> m_searchParents; // Direction taken into the tile
+    uint32_t m_searchStamp;
+    std::vector<OpenEntry> m_open;
+
+    std::vector<uint16_t> m_clusterDistances; // CLUSTER_SIZE^2, see floodCluster
+    std::vector<uint16_t> m_entranceDistances; // All pairs while building a cluster
+    TilePoint m_floodOrigin;                  // Top-left of the flooded cluster
+    std::vector<int> m_floodQueue;
+    std::vector<uint16_t> m_startDistances;   // Per entrance of the start / goal cluster
+    std::vector<uint16_t> m_goalDistances;
+
+    // Abstract search records: start, goal, then one block per cluster the search touched.
+    // m_clusterRecordBases[c] is valid while m_clusterRecordStamps[c] == m_abstractStamp.
+    std::vector<AbstractRecord> m_abstractRecords;
+    std::vector<uint32_t> m_clusterRecordStamps;
+    std::vector<uint32_t> m_clusterRecordBases;
+    uint32_t m_abstractStamp;
+    int m_lastExpandedNodes;
+};
@@ -1,6 +1,6 @@
 #include "shop_scene.h"
+#include "ui_font.h"
 #include "raylib.h"
-#include <sstream>
 
 ShopScene::ShopScene(Party* party, Inventory* inventory)
     : m_shop(nullptr)
@@ -57,8 +57,8 @@ void ShopScene::draw() {
 
     // Draw shop name and greeting
     if (m_shop) {
-        DrawText(m_shop->getName().c_str(), 20, 20, 24, YELLOW);
-        DrawText(m_shop->getGreeting().c_str(), 20, 50, 18, LIGHTGRAY);
+        UIFont::drawText(m_shop->getName().c_str(), 20, 20, 24, YELLOW);
+        UIFont::drawText(m_shop->getGreeting().c_str(), 20, 50, 18, LIGHTGRAY);
     }
 
     drawGoldDisplay();
@@ -310,26 +310,26 @@ void ShopScene::handleSellConfirmInput() {
 }
 
 void ShopScene::drawMainMenu() {
-    DrawText("What would you like to do?", MENU_X, MENU_Y - 40, 20, WHITE);
+    UIFont::drawText("What would you like to do?", MENU_X, MENU_Y - 40, 20, WHITE);
 
     const char* options[] = {"Buy", "Sell", "Leave"};
     for (int i = 0; i < 3; i++) {
         Color color = (i == m_mainMenuSelection) ? YELLOW : WHITE;
         const char* arrow = (i == m_mainMenuSelection) ? ">" : " ";
 
-        DrawText(arrow, MENU_X, MENU_Y + i * LINE_HEIGHT, 20, color);
-        DrawText(options[i], MENU_X + 30, MENU_Y + i * LINE_HEIGHT, 20, color);
+        UIFont::drawText(arrow, MENU_X, MENU_Y + i * LINE_HEIGHT, 20, color);
+        UIFont::drawText(options[i], MENU_X + 30, MENU_Y + i * LINE_HEIGHT, 20, color);
     }
 
-    DrawText("[ENTER/SPACE] Select  [ESC] Leave", 20, 560, 16, GRAY);
+    UIFont::drawText("[ENTER/SPACE] Select  [ESC] Leave", 20, 560, 16, GRAY);
 }
 
 void ShopScene::drawBuyingScreen() {
     if (!m_shop) return;
 
     const auto& items = m_shop->getItems();
-    DrawText("Buy Items", 20, 90, 20, YELLOW);
-    DrawText("[UP/DOWN] Navigate  [ENTER] Buy  [ESC] Back", 20, 560, 16, GRAY);
+    UIFont::drawText("Buy Items", 20, 90, 20, YELLOW);
+    UIFont::drawText("[UP/DOWN] Navigate  [ENTER] Buy  [ESC] Back", 20, 560, 16, GRAY);
 
     int y = 120;
     int endIndex = std::min(m_buyScrollOffset + ITEMS_PER_PAGE, static_cast<int>(items.size()));
@@ -339,21 +339,21 @@ void ShopScene::drawBuyingScreen() {
         Color color = (i == m_buySelection) ? YELLOW : WHITE;
         const char* arrow = (i == m_buySelection) ? ">" : " ";
 
-        DrawText(arrow, 20, y, 18, color);
-        DrawText(shopItem.item->getName().c_str(), 50, y, 18, color);
+        UIFont::drawText(arrow, 20, y, 18, color);
+        UIFont::drawText(shopItem.item->getName().c_str(), 50, y, 18, color);
 
         // Draw price
         char priceText[32];
         snprintf(priceText, sizeof(priceText), "%dG", shopItem.item->getBuyPrice());
-        DrawText(priceText, 400, y, 18, color);
+        UIFont::drawText(priceText, 400, y, 18, color);
 
         // Draw stock
         if (shopItem.quantity == -1) {
-            DrawText("∞", 500, y, 18, LIGHTGRAY);
+            UIFont::drawText("∞", 500, y, 18, LIGHTGRAY);
         } else {
             char stockText[32];
             snprintf(stockText, sizeof(stockText), "x%d", shopItem.quantity);
-            DrawText(stockText, 500, y, 18, LIGHTGRAY);
+            UIFont::drawText(stockText, 500, y, 18, LIGHTGRAY);
         }
 
         y += 25;
@@ -362,7 +362,7 @@ void ShopScene::drawBuyingScreen() {
     // Draw description of selected item
     if (m_buySelection < items.size()) {
         const Item* item = items[m_buySelection].item;
-        DrawText(item->getDescription().c_str(), 20, 480, 16, LIGHTGRAY);
+        m_textLayouts.get(item->getDescription(), 16, DESCRIPTION_WIDTH).draw(20, 480, DESCRIPTION_LINE_HEIGHT, LIGHTGRAY);
     }
 }
 
@@ -375,30 +375,31 @@ void ShopScene::drawBuyConfirmScreen() {
     const ShopItem& shopItem = items[m_buySelection];
     int totalCost = shopItem.item->getBuyPrice() * m_quantity;
 
-    DrawText("Confirm Purchase", MENU_X - 50, MENU_Y - 60, 24, YELLOW);
+    UIFont::drawText("Confirm Purchase", MENU_X - 50, MENU_Y - 60, 24, YELLOW);
 
-    DrawText(shopItem.item->getName().c_str(), MENU_X - 50, MENU_Y, 20, WHITE);
-    DrawText(shopItem.item->getDescription().c_str(), MENU_X - 50, MENU_Y + 30, 16, LIGHTGRAY);
+    UIFont::drawText(shopItem.item->getName().c_str(), MENU_X - 50, MENU_Y, 20, WHITE);
+    m_textLayouts.get(shopItem.item->getDescription(), 16, CONFIRM_DESCRIPTION_WIDTH)
+        .draw(MENU_X - 50, MENU_Y + 30, DESCRIPTION_LINE_HEIGHT, LIGHTGRAY);
 
     char quantityText[64];
     snprintf(quantityText, sizeof(quantityText), "Quantity: %d", m_quantity);
-    DrawText(quantityText, MENU_X - 50, MENU_Y + 70, 18, WHITE);
+    UIFont::drawText(quantityText, MENU_X - 50, MENU_Y + 70, 18, WHITE);
 
     char totalText[64];
     snprintf(totalText, sizeof(totalText), "Total: %dG", totalCost);
-    DrawText(totalText, MENU_X - 50, MENU_Y + 100, 18, WHITE);
+    UIFont::drawText(totalText, MENU_X - 50, MENU_Y + 100, 18, WHITE);
 
     Color priceColor = (m_party->getGold() >= totalCost) ? GREEN : RED;
-    DrawText(totalCost <= m_party->getGold() ? "Can afford" : "Not enough gold!",
+    UIFont::drawText(totalCost <= m_party->getGold() ? "Can afford" : "Not enough gold!",
              MENU_X - 50, MENU_Y + 130, 18, priceColor);
 
-    DrawText("[LEFT/RIGHT] Adjust Quantity  [ENTER] Confirm  [ESC] Cancel", 20, 560, 16, GRAY);
+    UIFont::drawText("[LEFT/RIGHT] Adjust Quantity  [ENTER] Confirm  [ESC] Cancel", 20, 560, 16, GRAY);
 }
 
 void ShopScene::drawSellingScreen() {
     const auto& items = m_inventory->getItems();
-    DrawText("Sell Items", 20, 90, 20, YELLOW);
-    DrawText("[UP/DOWN] Navigate  [ENTER] Sell  [ESC] Back", 20, 560, 16, GRAY);
+    UIFont::drawText("Sell Items", 20, 90, 20, YELLOW);
+    UIFont::drawText("[UP/DOWN] Navigate  [ENTER] Sell  [ESC] Back", 20, 560, 16, GRAY);
 
     int y = 120;
     int endIndex = std::min(m_sellScrollOffset + ITEMS_PER_PAGE, static_cast<int>(items.size()));
@@ -408,18 +409,18 @@ void ShopScene::drawSellingScreen() {
         Color color = (i == m_sellSelection) ? YELLOW : WHITE;
         const char* arrow = (i == m_sellSelection) ? ">" : " ";
 
-        DrawText(arrow, 20, y, 18, color);
-        DrawText(slot.item->getName().c_str(), 50, y, 18, color);
+        UIFont::drawText(arrow, 20, y, 18, color);
+        UIFont::drawText(slot.item->getName().c_str(), 50, y, 18, color);
 
         // Draw sell price
         char priceText[32];
         snprintf(priceText, sizeof(priceText), "%dG", slot.item->getSellPrice());
-        DrawText(priceText, 400, y, 18, color);
+        UIFont::drawText(priceText, 400, y, 18, color);
 
         // Draw quantity
         char qtyText[32];
         snprintf(qtyText, sizeof(qtyText), "x%d", slot.quantity);
-        DrawText(qtyText, 500, y, 18, LIGHTGRAY);
+        UIFont::drawText(qtyText, 500, y, 18, LIGHTGRAY);
 
         y += 25;
     }
@@ -427,7 +428,7 @@ void ShopScene::drawSellingScreen() {
     // Draw description of selected item
     if (m_sellSelection < items.size()) {
         const Item* item = items[m_sellSelection].item;
-        DrawText(item->getDescription().c_str(), 20, 480, 16, LIGHTGRAY);
+        m_textLayouts.get(item->getDescription(), 16, DESCRIPTION_WIDTH).draw(20, 480, DESCRIPTION_LINE_HEIGHT, LIGHTGRAY);
     }
 }
 
@@ -438,49 +439,25 @@ void ShopScene::drawSellConfirmScreen() {
     const ItemSlot& slot = items[m_sellSelection];
     int totalValue = slot.item->getSellPrice() * m_quantity;
 
-    DrawText("Confirm Sale", MENU_X - 50, MENU_Y - 60, 24, YELLOW);
+    UIFont::drawText("Confirm Sale", MENU_X - 50, MENU_Y - 60, 24, YELLOW);
 
-    DrawText(slot.item->getName().c_str(), MENU_X - 50, MENU_Y, 20, WHITE);
-    DrawText(slot.item->getDescription().c_str(), MENU_X - 50, MENU_Y + 30, 16, LIGHTGRAY);
+    UIFont::drawText(slot.item->getName().c_str(), MENU_X - 50, MENU_Y, 20, WHITE);
+    m_textLayouts.get(slot.item->getDescription(), 16, CONFIRM_DESCRIPTION_WIDTH)
+        .draw(MENU_X - 50, MENU_Y + 30, DESCRIPTION_LINE_HEIGHT, LIGHTGRAY);
 
     char quantityText[64];
     snprintf(quantityText, sizeof(quantityText), "Quantity: %d", m_quantity);
-    DrawText(quantityText, MENU_X - 50, MENU_Y + 70, 18, WHITE);
+    UIFont::drawText(quantityText, MENU_X - 50, MENU_Y + 70, 18, WHITE);
 
     char totalText[64];
     snprintf(totalText, sizeof(totalText), "You'll receive: %dG", totalValue);
-    DrawText(totalText, MENU_X - 50, MENU_Y + 100, 18, GREEN);
+    UIFont::drawText(totalText, MENU_X - 50, MENU_Y + 100, 18, GREEN);
 
-    DrawText("[LEFT/RIGHT] Adjust Quantity  [ENTER] Confirm  [ESC] Cancel", 20, 560, 16, GRAY);
+    UIFont::drawText("[LEFT/RIGHT] Adjust Quantity  [ENTER] Confirm  [ESC] Cancel", 20, 560, 16, GRAY);
 }
 
 void ShopScene::drawGoldDisplay() {
     char goldText[64];
     snprintf(goldText, sizeof(goldText), "Gold: %d", m_party->getGold());
-    DrawText(goldText, 600, 20, 20, GOLD);
-}
-
-std::vector<std::string> ShopScene::wrapText(const std::string& text, int maxWidth) {
-    std::vector<std::string> lines;
-    std::istringstream words(text);
-    std::string word;
-    std::string currentLine;
-
-    while (words >> word) {
-        std::string testLine = currentLine.empty() ? word : currentLine + " " + word;
-        int textWidth = MeasureText(testLine.c_str(), 18);
-
-        if (textWidth > maxWidth && !currentLine.empty()) {
-            lines.push_back(currentLine);
-            currentLine = word;
-        } else {
-            currentLine = testLine;
-        }
-    }
-
-    if (!currentLine.empty()) {
-        lines.push_back(currentLine);
-    }
-
-    return lines;
+    UIFont::drawText(goldText, 600, 20, 20, GOLD);
 }
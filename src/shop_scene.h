@@ -4,6 +4,7 @@
 #include "shop.h"
 #include "party.h"
 #include "inventory.h"
+#include "text_layout.h"
 #include <functional>
 #include <memory>
 
@@ -45,9 +46,6 @@ private:
     void drawSellConfirmScreen();
     void drawGoldDisplay();
 
-    // Helper for text wrapping
-    std::vector<std::string> wrapText(const std::string& text, int maxWidth);
-
     // State
     Shop* m_shop;
     Party* m_party;
@@ -65,6 +63,9 @@ private:
     // Callback
     std::function<void()> m_returnCallback;
 
+    // Wrapped item descriptions
+    TextLayoutCache m_textLayouts;
+
     // Name
     std::string m_name = "shop";
 
@@ -73,4 +74,7 @@ private:
     static constexpr int MENU_X = 250;
     static constexpr int MENU_Y = 200;
     static constexpr int LINE_HEIGHT = 30;
+    static constexpr int DESCRIPTION_LINE_HEIGHT = 20;
+    static constexpr int DESCRIPTION_WIDTH = 760;          // Item lists, from x = 20
+    static constexpr int CONFIRM_DESCRIPTION_WIDTH = 580;  // Confirm screens, from MENU_X - 50
 };
@@ -0,0 +1,118 @@
+#include "spatial_grid.h"
+#include <algorithm>
+
+SpatialGrid::SpatialGrid(int mapWidth, int mapHeight, int cellSize)
+    : m_width(std::max(1, mapWidth))
+    , m_height(std::max(1, mapHeight))
+    , m_cellSize(std::max(1, cellSize))
+    , m_cellsX((m_width + m_cellSize - 1) / m_cellSize)
+    , m_cellsY((m_height + m_cellSize - 1) / m_cellSize)
+    , m_cellHeads(static_cast<size_t>(m_cellsX) * m_cellsY, -1)
+    , m_count(0) {
+}
+
+void SpatialGrid::insert(int id, int tileX, int tileY) {
+    if (id < 0) {
+        return;
+    }
+    if (id >= static_cast<int>(m_entries.size())) {
+        m_entries.resize(id + 1);
+    }
+    if (m_entries[id].cell >= 0) {
+        move(id, tileX, tileY);
+        return;
+    }
+
+    Entry& entry = m_entries[id];
+    entry.tileX = std::min(std::max(tileX, 0), m_width - 1);
+    entry.tileY = std::min(std::max(tileY, 0), m_height - 1);
+    link(id, getCell(entry.tileX, entry.tileY));
+    m_count++;
+}
+
+void SpatialGrid::remove(int id) {
+    if (!contains(id)) {
+        return;
+    }
+    unlink(id);
+    m_count--;
+}
+
+void SpatialGrid::move(int id, int tileX, int tileY) {
+    if (!contains(id)) {
+        return;
+    }
+    Entry& entry = m_entries[id];
+    entry.tileX = std::min(std::max(tileX, 0), m_width - 1);
+    entry.tileY = std::min(std::max(tileY, 0), m_height - 1);
+    int cell = getCell(entry.tileX, entry.tileY);
+    if (cell != entry.cell) {
+        unlink(id);
+        link(id, cell);
+    }
+}
+
+void SpatialGrid::clear() {
+    std::fill(m_cellHeads.begin(), m_cellHeads.end(), -1);
+    m_entries.clear();
+    m_count = 0;
+}
+
+void SpatialGrid::query(int x, int y, int w, int h, std::vector<int>& ids) const {
+    int x0 = std::max(x, 0);
+    int y0 = std::max(y, 0);
+    int x1 = std::min(x + w, m_width);
+    int y1 = std::min(y + h, m_height);
+    if (x0 >= x1 || y0 >= y1) {
+        return;
+    }
+
+    for (int cy = y0 / m_cellSize; cy <= (y1 - 1) / m_cellSize; cy++) {
+        for (int cx = x0 / m_cellSize; cx <= (x1 - 1) / m_cellSize; cx++) {
+            for (int id = m_cellHeads[static_cast<size_t>(cy) * m_cellsX + cx]; id >= 0; id = m_entries[id].next) {
+                const Entry& entry = m_entries[id];
+                if (entry.tileX >= x0 && entry.tileX < x1 && entry.tileY >= y0 && entry.tileY < y1) {
+                    ids.push_back(id);
+                }
+            }
+        }
+    }
+}
+
+int SpatialGrid::findAt(int tileX, int tileY) const {
+    if (tileX < 0 || tileY < 0 || tileX >= m_width || tileY >= m_height) {
+        return -1;
+    }
+    for (int id = m_cellHeads[getCell(tileX, tileY)]; id >= 0; id = m_entries[id].next) {
+        if (m_entries[id].tileX == tileX && m_entries[id].tileY == tileY) {
+            return id;
+        }
+    }
+    return -1;
+}
+
+void SpatialGrid::link(int id, int cell) {
+    Entry& entry = m_entries[id];
+    entry.cell = cell;
+    entry.prev = -1;
+    entry.next = m_cellHeads[cell];
+    if (entry.next >= 0) {
+        m_entries[entry.next].prev = id;
+    }
+    m_cellHeads[cell] = id;
+}
+
+void SpatialGrid::unlink(int id) {
+    Entry& entry = m_entries[id];
+    if (entry.prev >= 0) {
+        m_entries[entry.prev].next = entry.next;
+    } else {
+        m_cellHeads[entry.cell] = entry.next;
+    }
+    if (entry.next >= 0) {
+        m_entries[entry.next].prev = entry.prev;
+    }
+    entry.cell = -1;
+    entry.prev = -1;
+    entry.next = -1;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Uniform grid over a tile map for finding entities by position.
+//
+// Entities are small dense ids (e.g. EntityWorld ids) standing on one tile
+// each. Every cell of CELL_SIZE x CELL_SIZE tiles heads an intrusive doubly linked list
+// of the ids in it, so inserting, moving and removing are O(1) and the grid costs one
+// int per cell plus a few per entity, even on the largest maps.
+class SpatialGrid {
+public:
+    static constexpr int DEFAULT_CELL_SIZE = 16;
+
+    SpatialGrid(int mapWidth, int mapHeight, int cellSize = DEFAULT_CELL_SIZE);
+
+    // Ids must be >= 0; the grid grows to the largest one. Tiles are clamped to the map.
+    void insert(int id, int tileX, int tileY);
+    void remove(int id);
+    void move(int id, int tileX, int tileY);
+    void clear();
+
+    bool contains(int id) const { return id >= 0 && id < static_cast<int>(m_entries.size()) && m_entries[id].cell >= 0; }
+
+    // Appends the ids standing inside the w x h tile rectangle at (x, y)
+    void query(int x, int y, int w, int h, std::vector<int>& ids) const;
+
+    // An id standing on the tile, or -1
+    int findAt(int tileX, int tileY) const;
+
+    int getCount() const { return m_count; }
+    int getCellSize() const { return m_cellSize; }
+
+private:
+    struct Entry {
+        int tileX = 0;
+        int tileY = 0;
+        int cell = -1;  // -1 while not in the grid
+        int prev = -1;
+        int next = -1;
+    };
+
+    int getCell(int tileX, int tileY) const {
+        return (tileY / m_cellSize) * m_cellsX + tileX / m_cellSize;
+    }
+    void link(int id, int cell);
+    void unlink(int id);
+
+    int m_width;
+    int m_height;
+    int m_cellSize;
+    int m_cellsX;
+    int m_cellsY;
+    std::vector<int> m_cellHeads; // First id in each cell, or -1
+    std::vector<Entry> m_entries; // By id
+    int m_count;
+};
@@ -1,22 +1,38 @@
 #include "sprite.h"
+#include "texture_atlas.h"
+#include "draw_stats.h"
+#include "sprite_batch.h"
 #include <iostream>
+#include <utility>
 
 Sprite::Sprite(int width, int height, Color color)
     : m_frameWidth(width), m_frameHeight(height), m_color(color),
-      m_hasTexture(false), m_currentDirection(Direction::DOWN),
-      m_isAnimating(false), m_currentFrame(0), m_frameTimer(0.0f) {
+      m_hasTexture(false), m_sheetOrigin{0.0f, 0.0f},
+      m_currentDirection(Direction::DOWN),
+      m_isAnimating(false), m_animations(nullptr), m_animator(INVALID_ANIMATOR) {
     m_texture = {0}; // Initialize empty texture
 }
 
-Sprite::Sprite(const std::string& texturePath, int frameWidth, int frameHeight)
+Sprite::Sprite(const std::string& texturePath, int frameWidth, int frameHeight, const TextureAtlas* atlas)
     : m_frameWidth(frameWidth), m_frameHeight(frameHeight), m_color(WHITE),
-      m_hasTexture(false), m_currentDirection(Direction::DOWN),
-      m_isAnimating(false), m_currentFrame(0), m_frameTimer(0.0f) {
+      m_hasTexture(false), m_sheetOrigin{0.0f, 0.0f},
+      m_currentDirection(Direction::DOWN),
+      m_isAnimating(false), m_animations(nullptr), m_animator(INVALID_ANIMATOR) {
+
+    // Prefer the shared atlas page so sprites batch with each other
+    const AtlasRegion* region = atlas ? atlas->find(TextureAtlas::nameFromPath(texturePath)) : nullptr;
+    if (region) {
+        m_texture = atlas->getPage(region->page);
+        m_sheetOrigin = {region->rect.x, region->rect.y};
+        m_hasTexture = true;
+        return;
+    }
 
     // Try to load texture
-    m_texture = LoadTexture(texturePath.c_str());
+    m_sharedTexture = TextureCache::load(texturePath);
 
-    if (m_texture.id > 0) {
+    if (m_sharedTexture) {
+        m_texture = *m_sharedTexture;
         m_hasTexture = true;
     } else {
         std::cerr << "Failed to load sprite texture: " << texturePath << std::endl;
@@ -25,39 +41,73 @@ Sprite::Sprite(const std::string& texturePath, int frameWidth, int frameHeight)
 }
 
 Sprite::~Sprite() {
-    if (m_hasTexture && m_texture.id > 0) {
-        UnloadTexture(m_texture);
+    if (m_animations) {
+        m_animations->destroy(m_animator);
     }
 }
 
-void Sprite::update(float deltaTime) {
-    if (m_isAnimating) {
-        m_frameTimer += deltaTime;
+Sprite::Sprite(Sprite&& other) noexcept
+    : m_animations(nullptr), m_animator(INVALID_ANIMATOR) {
+    *this = std::move(other);
+}
 
-        if (m_frameTimer >= FRAME_TIME) {
-            m_frameTimer = 0.0f;
-            m_currentFrame = (m_currentFrame + 1) % FRAMES_PER_ANIMATION;
-        }
-    } else {
-        m_currentFrame = 0;
-        m_frameTimer = 0.0f;
+Sprite& Sprite::operator=(Sprite&& other) noexcept {
+    if (this == &other) {
+        return *this;
+    }
+    if (m_animations) {
+        m_animations->destroy(m_animator);
+    }
+    m_frameWidth = other.m_frameWidth;
+    m_frameHeight = other.m_frameHeight;
+    m_color = other.m_color;
+    m_texture = other.m_texture;
+    m_hasTexture = other.m_hasTexture;
+    m_sharedTexture = std::move(other.m_sharedTexture);
+    m_sheetOrigin = other.m_sheetOrigin;
+    m_currentDirection = other.m_currentDirection;
+    m_isAnimating = other.m_isAnimating;
+    m_animations = other.m_animations;
+    m_animator = other.m_animator;
+    for (int i = 0; i < 4; i++) {
+        m_walkClips[i] = other.m_walkClips[i];
+        m_idleClips[i] = other.m_idleClips[i];
+    }
+    other.m_animations = nullptr;
+    other.m_animator = INVALID_ANIMATOR;
+    return *this;
+}
+
+void Sprite::setAnimations(AnimationSystem* animations, const std::string& clipSet) {
+    if (m_animations) {
+        m_animations->destroy(m_animator);
+    }
+    m_animations = animations;
+    m_animator = animations ? animations->create() : INVALID_ANIMATOR;
+    if (!animations) {
+        return;
+    }
+
+    static const char* DIRECTION_NAMES[4] = {"down", "left", "right", "up"};
+    const AnimationLibrary& library = animations->getLibrary();
+    for (int i = 0; i < 4; i++) {
+        m_walkClips[i] = library.findClip(clipSet + ".walk_" + DIRECTION_NAMES[i]);
+        m_idleClips[i] = library.findClip(clipSet + ".idle_" + DIRECTION_NAMES[i]);
+    }
+    playClip();
+}
+
+void Sprite::playClip() {
+    if (!m_animations) {
+        return;
     }
+    int direction = static_cast<int>(m_currentDirection);
+    m_animations->play(m_animator, m_isAnimating ? m_walkClips[direction] : m_idleClips[direction]);
 }
 
 void Sprite::render(int x, int y) const {
     if (m_hasTexture) {
-        // Render from sprite sheet
-        // Sprite sheet layout: 2 columns (frames) x 4 rows (directions)
-        int row = static_cast<int>(m_currentDirection);
-        int col = m_currentFrame;
-
-        Rectangle sourceRect = {
-            static_cast<float>(col * m_frameWidth),
-            static_cast<float>(row * m_frameHeight),
-            static_cast<float>(m_frameWidth),
-            static_cast<float>(m_frameHeight)
-        };
-
+        Rectangle sourceRect = getSourceRect();
         Rectangle destRect = {
             static_cast<float>(x),
             static_cast<float>(y),
@@ -65,8 +115,11 @@ void Sprite::render(int x, int y) const {
             static_cast<float>(m_frameHeight)
         };
 
+        DrawStats::useTexture(m_texture.id);
         DrawTexturePro(m_texture, sourceRect, destRect, {0, 0}, 0.0f, WHITE);
     } else {
+        DrawStats::useShapes();
+
         // Fallback: render as a simple colored rectangle
         DrawRectangle(x, y, m_frameWidth, m_frameHeight, m_color);
 
@@ -114,10 +167,48 @@ void Sprite::render(int x, int y) const {
     }
 }
 
+void Sprite::submit(SpriteBatch& batch, int x, int y, int sortY) const {
+    if (!m_hasTexture) {
+        batch.addPlaceholder(*this, x, y, sortY);
+        return;
+    }
+    Rectangle destRect = {
+        static_cast<float>(x),
+        static_cast<float>(y),
+        static_cast<float>(m_frameWidth),
+        static_cast<float>(m_frameHeight)
+    };
+    batch.add(m_texture, getSourceRect(), destRect, sortY);
+}
+
+Rectangle Sprite::getSourceRect() const {
+    // Without a clip: column 0 of the direction's row (sheets are laid out a row per direction)
+    int row = static_cast<int>(m_currentDirection);
+    int col = 0;
+    if (m_animations && m_animations->getClip(m_animator) >= 0) {
+        const AnimationFrame& frame = m_animations->getFrame(m_animator);
+        col = frame.column;
+        row = frame.row;
+    }
+
+    return {
+        m_sheetOrigin.x + static_cast<float>(col * m_frameWidth),
+        m_sheetOrigin.y + static_cast<float>(row * m_frameHeight),
+        static_cast<float>(m_frameWidth),
+        static_cast<float>(m_frameHeight)
+    };
+}
+
 void Sprite::setDirection(Direction direction) {
-    m_currentDirection = direction;
+    if (direction != m_currentDirection) {
+        m_currentDirection = direction;
+        playClip();
+    }
 }
 
 void Sprite::setAnimating(bool animating) {
-    m_isAnimating = animating;
+    if (animating != m_isAnimating) {
+        m_isAnimating = animating;
+        playClip();
+    }
 }
@@ -1,9 +1,14 @@
 #pragma once
 
+#include "sprite_animation.h"
+#include "texture_cache.h"
 #include <raylib.h>
 #include <vector>
 #include <string>
 
+class TextureAtlas;
+class SpriteBatch;
+
 enum class Direction {
     DOWN = 0,
     LEFT = 1,
@@ -16,13 +21,27 @@ public:
     // Constructor for color-based placeholder sprites
     Sprite(int width, int height, Color color);
 
-    // Constructor for texture-based sprites
-    Sprite(const std::string& texturePath, int frameWidth, int frameHeight);
-
+    // Constructor for texture-based sprites. If the atlas holds the image (looked up by
+    // file name) the sprite draws from its atlas region; otherwise the texture comes from
+    // TextureCache, so sprites with the same image (and copies) share one upload.
+    Sprite(const std::string& texturePath, int frameWidth, int frameHeight, const TextureAtlas* atlas = nullptr);
     ~Sprite();
 
-    void update(float deltaTime);
+    // Each sprite owns its animator, so copies are not allowed
+    Sprite(const Sprite&) = delete;
+    Sprite& operator=(const Sprite&) = delete;
+    Sprite(Sprite&& other) noexcept;
+    Sprite& operator=(Sprite&& other) noexcept;
+
+    // Plays "<clipSet>.walk_<direction>" while animating and "<clipSet>.idle_<direction>"
+    // otherwise (direction is down, left, right or up) from the system's library. The
+    // system must outlive the sprite. Without a matching clip the sprite shows column 0
+    // of the direction's row.
+    void setAnimations(AnimationSystem* animations, const std::string& clipSet);
+
     void render(int x, int y) const;
+    // Queues the sprite at (x, y) into a batch that sorts by sortY
+    void submit(SpriteBatch& batch, int x, int y, int sortY) const;
 
     void setDirection(Direction direction);
     void setAnimating(bool animating);
@@ -31,6 +50,9 @@ public:
     int getHeight() const { return m_frameHeight; }
 
 private:
+    Rectangle getSourceRect() const; // Current frame on the sheet
+    void playClip(); // The clip for the current direction and state
+
     int m_frameWidth;
     int m_frameHeight;
     Color m_color;
@@ -38,12 +60,14 @@ private:
     // Texture support
     Texture2D m_texture;
     bool m_hasTexture;
+    TextureCache::Handle m_sharedTexture; // Keeps m_texture loaded; null for atlas pages
+    Vector2 m_sheetOrigin;  // Top-left of the sprite sheet inside m_texture
 
     Direction m_currentDirection;
     bool m_isAnimating;
 
-    int m_currentFrame;
-    float m_frameTimer;
-    static constexpr float FRAME_TIME = 0.15f;
-    static constexpr int FRAMES_PER_ANIMATION = 2;
+    AnimationSystem* m_animations;
+    AnimatorId m_animator;
+    int m_walkClips[4] = {-1, -1, -1, -1}; // Per Direction, -1 if missing
+    int m_idleClips[4] = {-1, -1, -1, -1};
 };
@@ -0,0 +1,292 @@
+#include "sprite_animation.h"
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <sstream>
+
+namespace {
+
+constexpr float NEVER = std::numeric_limits<float>::infinity();
+
+// "<column>,<row>[:<seconds>][!<event>]"
+bool parseFrame(const std::string& text, AnimationFrame& frame, std::string& event) {
+    std::string cell = text;
+    event.clear();
+    size_t bang = cell.find('!');
+    if (bang != std::string::npos) {
+        event = cell.substr(bang + 1);
+        cell = cell.substr(0, bang);
+        if (event.empty()) {
+            return false;
+        }
+    }
+
+    frame.duration = AnimationLibrary::DEFAULT_FRAME_DURATION;
+    size_t colon = cell.find(':');
+    if (colon != std::string::npos) {
+        std::istringstream duration(cell.substr(colon + 1));
+        if (!(duration >> frame.duration) || !duration.eof()) {
+            return false;
+        }
+        cell = cell.substr(0, colon);
+    }
+
+    std::istringstream position(cell);
+    int column, row;
+    char comma;
+    if (!(position >> column >> comma >> row) || comma != ',' || !position.eof() ||
+        column < 0 || row < 0 || column > 0xFFFF || row > 0xFFFF) {
+        return false;
+    }
+    frame.column = static_cast<uint16_t>(column);
+    frame.row = static_cast<uint16_t>(row);
+    frame.event = -1;
+    return true;
+}
+
+} // namespace
+
+bool AnimationLibrary::loadFromFile(const std::string& path) {
+    std::ifstream input(path);
+    if (!input) {
+        std::cerr << "Failed to open sprite animations: " << path << std::endl;
+        return false;
+    }
+
+    AnimationLibrary loaded;
+
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(input, line)) {
+        lineNumber++;
+        line = line.substr(0, line.find('#'));
+
+        std::istringstream fields(line);
+        std::string name;
+        if (!(fields >> name)) {
+            continue; // Blank or comment-only line
+        }
+
+        std::string mode;
+        AnimationLoop loop;
+        fields >> mode;
+        if (mode == "loop") {
+            loop = AnimationLoop::LOOP;
+        } else if (mode == "once") {
+            loop = AnimationLoop::ONCE;
+        } else if (mode == "pingpong") {
+            loop = AnimationLoop::PING_PONG;
+        } else {
+            std::cerr << path << ":" << lineNumber << ": expected loop, once or pingpong" << std::endl;
+            return false;
+        }
+
+        std::vector<AnimationFrame> frames;
+        std::string text;
+        while (fields >> text) {
+            AnimationFrame frame;
+            std::string event;
+            if (!parseFrame(text, frame, event)) {
+                std::cerr << path << ":" << lineNumber << ": bad frame '" << text
+                          << "' (expected column,row[:seconds][!event])" << std::endl;
+                return false;
+            }
+            if (!event.empty()) {
+                frame.event = loaded.getEventId(event);
+            }
+            frames.push_back(frame);
+        }
+
+        if (loaded.addClip(name, loop, frames) < 0) {
+            std::cerr << path << ":" << lineNumber << ": invalid clip (needs at least one frame and "
+                      << "positive durations)" << std::endl;
+            return false;
+        }
+    }
+
+    *this = std::move(loaded);
+    return true;
+}
+
+int AnimationLibrary::addClip(const std::string& name, AnimationLoop loop, const std::vector<AnimationFrame>& frames) {
+    if (frames.empty()) {
+        return -1;
+    }
+    for (const AnimationFrame& frame : frames) {
+        if (!(frame.duration > 0.0f)) {
+            return -1;
+        }
+    }
+
+    // A replaced clip's frames stay in the array unused; libraries are loaded once
+    AnimationClip clip = {name, loop, static_cast<int>(m_frames.size()), static_cast<int>(frames.size())};
+    m_frames.insert(m_frames.end(), frames.begin(), frames.end());
+
+    auto it = m_clipLookup.find(name);
+    if (it != m_clipLookup.end()) {
+        m_clips[it->second] = clip;
+        return it->second;
+    }
+    m_clipLookup[name] = static_cast<int>(m_clips.size());
+    m_clips.push_back(clip);
+    return static_cast<int>(m_clips.size()) - 1;
+}
+
+void AnimationLibrary::clear() {
+    m_clips.clear();
+    m_frames.clear();
+    m_clipLookup.clear();
+    m_eventNames.clear();
+}
+
+int AnimationLibrary::findClip(const std::string& name) const {
+    auto it = m_clipLookup.find(name);
+    return it != m_clipLookup.end() ? it->second : -1;
+}
+
+int AnimationLibrary::getEventId(const std::string& name) {
+    int event = findEvent(name);
+    if (event < 0) {
+        event = static_cast<int>(m_eventNames.size());
+        m_eventNames.push_back(name);
+    }
+    return event;
+}
+
+int AnimationLibrary::findEvent(const std::string& name) const {
+    for (size_t i = 0; i < m_eventNames.size(); i++) {
+        if (m_eventNames[i] == name) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+AnimationSystem::AnimationSystem(const AnimationLibrary& library)
+    : m_library(library) {
+}
+
+AnimatorId AnimationSystem::create() {
+    AnimatorId id;
+    if (!m_freeIds.empty()) {
+        id = m_freeIds.back();
+        m_freeIds.pop_back();
+    } else {
+        id = static_cast<AnimatorId>(m_slots.size());
+        m_slots.push_back(0);
+    }
+
+    m_slots[id] = static_cast<uint32_t>(m_ids.size());
+    m_ids.push_back(id);
+    m_clips.push_back(-1);
+    m_frames.push_back(-1);
+    m_remaining.push_back(NEVER);
+    m_speeds.push_back(1.0f);
+    m_steps.push_back(1);
+    return id;
+}
+
+void AnimationSystem::destroy(AnimatorId animator) {
+    // Move the last slot into the hole to keep the arrays packed
+    uint32_t slot = m_slots[animator];
+    uint32_t last = static_cast<uint32_t>(m_ids.size()) - 1;
+    m_ids[slot] = m_ids[last];
+    m_clips[slot] = m_clips[last];
+    m_frames[slot] = m_frames[last];
+    m_remaining[slot] = m_remaining[last];
+    m_speeds[slot] = m_speeds[last];
+    m_steps[slot] = m_steps[last];
+    m_slots[m_ids[slot]] = slot;
+
+    m_ids.pop_back();
+    m_clips.pop_back();
+    m_frames.pop_back();
+    m_remaining.pop_back();
+    m_speeds.pop_back();
+    m_steps.pop_back();
+    m_freeIds.push_back(animator);
+}
+
+void AnimationSystem::play(AnimatorId animator, int clip, bool restart) {
+    uint32_t slot = m_slots[animator];
+    if (clip == m_clips[slot] && !restart) {
+        return;
+    }
+    m_clips[slot] = clip;
+    if (clip < 0) {
+        m_remaining[slot] = NEVER;
+        return;
+    }
+    m_steps[slot] = 1;
+    enterFrame(slot, m_library.getClip(clip).firstFrame);
+}
+
+void AnimationSystem::setSpeed(AnimatorId animator, float speed) {
+    m_speeds[m_slots[animator]] = speed;
+}
+
+bool AnimationSystem::isFinished(AnimatorId animator) const {
+    return std::isinf(m_remaining[m_slots[animator]]);
+}
+
+void AnimationSystem::update(float deltaTime) {
+    m_events.clear();
+
+    // Stopped and finished animators wait on an infinite frame, so the loop needs no
+    // other test
+    size_t count = m_ids.size();
+    float* remaining = m_remaining.data();
+    const float* speeds = m_speeds.data();
+    for (size_t slot = 0; slot < count; slot++) {
+        remaining[slot] -= deltaTime * speeds[slot];
+        if (remaining[slot] <= 0.0f) {
+            advance(static_cast<uint32_t>(slot));
+        }
+    }
+}
+
+void AnimationSystem::advance(uint32_t slot) {
+    const AnimationClip& clip = m_library.getClip(m_clips[slot]);
+    while (m_remaining[slot] <= 0.0f) {
+        int index = m_frames[slot] - clip.firstFrame;
+        int next;
+        switch (clip.loop) {
+            case AnimationLoop::LOOP:
+                next = (index + 1) % clip.frameCount;
+                break;
+            case AnimationLoop::ONCE:
+                if (index + 1 >= clip.frameCount) {
+                    m_remaining[slot] = NEVER;
+                    return;
+                }
+                next = index + 1;
+                break;
+            case AnimationLoop::PING_PONG:
+            default:
+                if (clip.frameCount == 1) {
+                    next = 0;
+                    break;
+                }
+                if (index + m_steps[slot] < 0 || index + m_steps[slot] >= clip.frameCount) {
+                    m_steps[slot] = static_cast<int8_t>(-m_steps[slot]);
+                }
+                next = index + m_steps[slot];
+                break;
+        }
+
+        // Carry the overshoot into the next frame so timing doesn't drift
+        float overshoot = m_remaining[slot];
+        enterFrame(slot, clip.firstFrame + next);
+        m_remaining[slot] += overshoot;
+    }
+}
+
+void AnimationSystem::enterFrame(uint32_t slot, int frame) {
+    const AnimationFrame& data = m_library.getFrames()[frame];
+    m_frames[slot] = frame;
+    m_remaining[slot] = data.duration;
+    if (data.event >= 0) {
+        m_events.push_back({m_ids[slot], data.event});
+    }
+}
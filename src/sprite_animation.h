@@ -0,0 +1,127 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+enum class AnimationLoop : uint8_t {
+    LOOP,       // Back to the first frame after the last
+    ONCE,       // Stops on the last frame
+    PING_PONG   // Forwards, then backwards, and again
+};
+
+// One cell of a sprite sheet, shown for `duration` seconds
+struct AnimationFrame {
+    uint16_t column;
+    uint16_t row;
+    float duration;
+    int event;  // Fired when the frame comes up, -1 for none
+};
+
+struct AnimationClip {
+    std::string name;
+    AnimationLoop loop;
+    int firstFrame;  // Into AnimationLibrary::getFrames()
+    int frameCount;
+};
+
+// Sprite sheet animations loaded from data. Frames of every clip sit in one array so
+// AnimationSystem can advance any animator with flat lookups.
+class AnimationLibrary {
+public:
+    static constexpr float DEFAULT_FRAME_DURATION = 0.15f;
+
+    // Text format, one clip per line:
+    //   <name> <loop|once|pingpong> <frame> [frame...]
+    // where a frame is <column>,<row>[:<seconds>][!<event>], e.g. "1,0:0.2!step".
+    // Durations default to DEFAULT_FRAME_DURATION. '#' starts a comment.
+    // Replaces the whole library; returns false (keeping the old one) on error.
+    bool loadFromFile(const std::string& path);
+
+    // Returns the clip index, or -1 if it has no frames or a duration isn't positive.
+    // Replaces an existing clip of the same name.
+    int addClip(const std::string& name, AnimationLoop loop, const std::vector<AnimationFrame>& frames);
+    void clear();
+
+    // -1 if there is no such clip
+    int findClip(const std::string& name) const;
+    const AnimationClip& getClip(int clip) const { return m_clips[clip]; }
+    int getClipCount() const { return static_cast<int>(m_clips.size()); }
+    const std::vector<AnimationFrame>& getFrames() const { return m_frames; }
+
+    // Events are interned: the id is what AnimationSystem reports
+    int getEventId(const std::string& name);
+    int findEvent(const std::string& name) const;
+    const std::string& getEventName(int event) const { return m_eventNames[event]; }
+
+private:
+    std::vector<AnimationClip> m_clips;
+    std::vector<AnimationFrame> m_frames;
+    std::unordered_map<std::string, int> m_clipLookup;
+    std::vector<std::string> m_eventNames;
+};
+
+using AnimatorId = uint32_t;
+constexpr AnimatorId INVALID_ANIMATOR = 0xFFFFFFFF;
+
+struct AnimationEvent {
+    AnimatorId animator;
+    int event;
+};
+
+// Plays clips for many animators at once.
+//
+// Animator state is kept as parallel arrays packed at the front (ids map to slots and
+// destroying swaps the last slot in), and update() is a single pass that subtracts the
+// frame time and only leaves the loop when a frame runs out, so ten thousand animators
+// take a few microseconds. Sprites read their current sheet cell from here instead of
+// ticking timers of their own.
+class AnimationSystem {
+public:
+    // The library must outlive the system and not change while clips play
+    explicit AnimationSystem(const AnimationLibrary& library);
+
+    AnimatorId create();
+    void destroy(AnimatorId animator);
+
+    // Starts a clip from its first frame; playing the current clip again only resumes it
+    // unless restart is set. -1 stops on the current frame.
+    void play(AnimatorId animator, int clip, bool restart = false);
+    void setSpeed(AnimatorId animator, float speed); // Playback rate, 1 = as authored
+
+    void update(float deltaTime);
+
+    int getClip(AnimatorId animator) const { return m_clips[m_slots[animator]]; }
+    bool isFinished(AnimatorId animator) const; // A ONCE clip reached its end (or nothing plays)
+    // Current frame; only valid while a clip was ever played
+    const AnimationFrame& getFrame(AnimatorId animator) const {
+        return m_library.getFrames()[m_frames[m_slots[animator]]];
+    }
+    bool hasFrame(AnimatorId animator) const { return m_frames[m_slots[animator]] >= 0; }
+
+    // Events of frames that came up during the last update()
+    const std::vector<AnimationEvent>& getEvents() const { return m_events; }
+
+    int getAnimatorCount() const { return static_cast<int>(m_ids.size()); }
+    const AnimationLibrary& getLibrary() const { return m_library; }
+
+private:
+    // A frame ran out: moves on (maybe several frames), firing events
+    void advance(uint32_t slot);
+    void enterFrame(uint32_t slot, int frame);
+
+    const AnimationLibrary& m_library;
+
+    // Per slot, packed; slot i belongs to m_ids[i]
+    std::vector<AnimatorId> m_ids;
+    std::vector<int> m_clips;          // -1 while stopped
+    std::vector<int> m_frames;         // Absolute frame index, -1 before the first play
+    std::vector<float> m_remaining;    // Seconds left on the frame
+    std::vector<float> m_speeds;
+    std::vector<int8_t> m_steps;       // +1 / -1, ping-pong direction
+
+    std::vector<uint32_t> m_slots;     // Per id
+    std::vector<AnimatorId> m_freeIds;
+    std::vector<AnimationEvent> m_events;
+};
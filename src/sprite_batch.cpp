@@ -0,0 +1,98 @@
+#include "sprite_batch.h"
+#include "sprite.h"
+#include "draw_stats.h"
+#include <algorithm>
+
+void SpriteBatch::begin() {
+    m_items.clear();
+    m_keys.clear();
+    m_textureIds.clear();
+}
+
+void SpriteBatch::add(const Texture2D& texture, Rectangle source, Rectangle dest, int sortY, Color tint) {
+    push({texture, source, dest, tint, nullptr}, sortY, getTextureSlot(texture.id));
+}
+
+void SpriteBatch::addPlaceholder(const Sprite& sprite, int x, int y, int sortY) {
+    Rectangle dest = {static_cast<float>(x), static_cast<float>(y), 0.0f, 0.0f};
+    push({Texture2D{}, Rectangle{}, dest, WHITE, &sprite}, sortY, PLACEHOLDER_SLOT);
+}
+
+void SpriteBatch::push(const Item& item, int sortY, uint32_t textureSlot) {
+    int64_t biased = static_cast<int64_t>(sortY) + SORT_Y_BIAS;
+    uint32_t y = static_cast<uint32_t>(std::min<int64_t>(std::max<int64_t>(biased, 0), MAX_SORT_Y));
+    m_items.push_back(item);
+    m_keys.push_back((y << 8) | textureSlot);
+}
+
+uint32_t SpriteBatch::getTextureSlot(unsigned int textureId) {
+    // A handful of textures per frame at most, so a scan beats hashing. Past 254 the
+    // slots stop separating textures, which only costs batching, not ordering.
+    for (size_t i = 0; i < m_textureIds.size(); i++) {
+        if (m_textureIds[i] == textureId) {
+            return static_cast<uint32_t>(i);
+        }
+    }
+    if (m_textureIds.size() < PLACEHOLDER_SLOT - 1) {
+        m_textureIds.push_back(textureId);
+        return static_cast<uint32_t>(m_textureIds.size() - 1);
+    }
+    return PLACEHOLDER_SLOT - 1;
+}
+
+void SpriteBatch::sort() {
+    size_t count = m_items.size();
+    m_order.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        m_order[i] = static_cast<uint32_t>(i);
+    }
+    m_sortKeys.assign(m_keys.begin(), m_keys.end());
+    m_keyScratch.resize(count);
+    m_orderScratch.resize(count);
+
+    // One counting pass per key byte, low byte first; bytes that are the same for
+    // every sprite (the high Y byte, usually) are skipped
+    for (int shift = 0; shift < 32; shift += 8) {
+        size_t counts[257] = {};
+        for (uint32_t key : m_sortKeys) {
+            counts[((key >> shift) & 0xFF) + 1]++;
+        }
+        if (counts[((m_sortKeys[0] >> shift) & 0xFF) + 1] == count) {
+            continue;
+        }
+        for (int i = 0; i < 256; i++) {
+            counts[i + 1] += counts[i];
+        }
+        for (size_t i = 0; i < count; i++) {
+            size_t slot = counts[(m_sortKeys[i] >> shift) & 0xFF]++;
+            m_keyScratch[slot] = m_sortKeys[i];
+            m_orderScratch[slot] = m_order[i];
+        }
+        m_sortKeys.swap(m_keyScratch);
+        m_order.swap(m_orderScratch);
+    }
+}
+
+void SpriteBatch::draw() {
+    m_lastBatchCount = 0;
+    if (m_items.empty()) {
+        return;
+    }
+    sort();
+
+    unsigned int currentTexture = 0;
+    for (uint32_t index : m_order) {
+        const Item& item = m_items[index];
+        if (item.placeholder) {
+            item.placeholder->render(static_cast<int>(item.dest.x), static_cast<int>(item.dest.y));
+            currentTexture = 0;
+            continue;
+        }
+        if (item.texture.id != currentTexture) {
+            currentTexture = item.texture.id;
+            m_lastBatchCount++;
+        }
+        DrawStats::useTexture(item.texture.id);
+        DrawTexturePro(item.texture, item.source, item.dest, {0.0f, 0.0f}, 0.0f, item.tint);
+    }
+}
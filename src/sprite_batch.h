@@ -0,0 +1,59 @@
+#pragma once
+
+#include <raylib.h>
+#include <cstdint>
+#include <vector>
+
+class Sprite;
+
+// Collects a frame's entity sprites and draws them back to front by foot Y, so whoever
+// stands lower on screen overlaps whoever stands behind them.
+//
+// draw() orders the sprites with an LSD radix sort on a 32-bit key: the foot Y in the
+// high 24 bits and a per-frame texture slot in the low 8, so sprites on the same row
+// that share a texture end up next to each other and raylib's batcher merges them.
+// With sprites packed in the TextureAtlas that is a single draw call for the lot. The
+// sort is stable and linear, and all buffers are reused, so thousands of sprites a
+// frame cost no allocations once warmed up.
+class SpriteBatch {
+public:
+    // Starts a new frame's list
+    void begin();
+
+    // A textured quad; sortY is usually the bottom edge of the sprite in world pixels
+    void add(const Texture2D& texture, Rectangle source, Rectangle dest, int sortY, Color tint = WHITE);
+    // A sprite without a texture, drawn with Sprite::render at (x, y)
+    void addPlaceholder(const Sprite& sprite, int x, int y, int sortY);
+
+    // Sorts and draws everything added since begin()
+    void draw();
+
+    int getSpriteCount() const { return static_cast<int>(m_items.size()); }
+    int getLastBatchCount() const { return m_lastBatchCount; } // Texture switches in the last draw()
+
+private:
+    struct Item {
+        Texture2D texture;
+        Rectangle source;
+        Rectangle dest;
+        Color tint;
+        const Sprite* placeholder; // Drawn through the sprite instead when set
+    };
+
+    static constexpr int SORT_Y_BIAS = 1 << 23; // Lets slightly negative Y keys sort first
+    static constexpr uint32_t MAX_SORT_Y = (1u << 24) - 1;
+    static constexpr uint32_t PLACEHOLDER_SLOT = 0xFF;
+
+    void push(const Item& item, int sortY, uint32_t textureSlot);
+    uint32_t getTextureSlot(unsigned int textureId);
+    void sort();
+
+    std::vector<Item> m_items;
+    std::vector<uint32_t> m_keys;        // Per item
+    std::vector<uint32_t> m_sortKeys;    // m_keys in m_order
+    std::vector<uint32_t> m_order;       // Item indices, sorted by draw()
+    std::vector<uint32_t> m_keyScratch;
+    std::vector<uint32_t> m_orderScratch;
+    std::vector<unsigned int> m_textureIds; // Slot -> texture id, this frame
+    int m_lastBatchCount = 0;
+};
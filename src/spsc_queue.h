@@ -0,0 +1,51 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// Bounded lock-free queue for exactly one producer thread and one consumer thread.
+// push() and pop() never block; they return false when the queue is full/empty.
+template <typename T>
+class SpscQueue {
+public:
+    explicit SpscQueue(size_t capacity) : m_slots(capacity + 1), m_head(0), m_tail(0) {}
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    // Producer side
+    bool push(T&& value) {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        size_t next = increment(tail);
+        if (next == m_head.load(std::memory_order_acquire)) {
+            return false;
+        }
+        m_slots[tail] = std::move(value);
+        m_tail.store(next, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side
+    bool pop(T& value) {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        value = std::move(m_slots[head]);
+        m_head.store(increment(head), std::memory_order_release);
+        return true;
+    }
+
+    size_t getCapacity() const { return m_slots.size() - 1; }
+
+private:
+    size_t increment(size_t index) const { return index + 1 == m_slots.size() ? 0 : index + 1; }
+
+    std::vector<T> m_slots; // One slot stays free to tell full from empty
+
+    // Written by different threads, so keep them on separate cache lines
+    alignas(64) std::atomic<size_t> m_head; // Consumer
+    alignas(64) std::atomic<size_t> m_tail; // Producer
+};
@@ -0,0 +1,131 @@
+#include "text_layout.h"
+#include "ui_font.h"
+#include <algorithm>
+
+namespace {
+
+// A glyph of the word being placed, before it has a position
+struct WordGlyph {
+    int codepoint;
+    float advance; // Unscaled
+};
+
+bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+}
+
+} // namespace
+
+void TextLayout::draw(int x, int y, int lineHeight, Color color) const {
+    for (const TextLine& line : lines) {
+        UIFont::drawGlyphs(glyphs.data() + line.firstGlyph, line.glyphCount, x, y, fontSize, color);
+        y += lineHeight;
+    }
+}
+
+TextLayoutCache::TextLayoutCache(int maxLayouts)
+    : m_maxLayouts(std::max(maxLayouts, 1)), m_useCounter(0), m_builds(0), m_hits(0) {
+}
+
+const TextLayout& TextLayoutCache::get(const std::string& text, int fontSize, int maxWidth) {
+    m_useCounter++;
+    for (Entry& entry : m_layouts) {
+        const TextLayout& layout = entry.layout;
+        if (layout.fontSize == fontSize && layout.maxWidth == maxWidth && layout.source == text) {
+            entry.lastUse = m_useCounter;
+            m_hits++;
+            return layout;
+        }
+    }
+
+    // Reuse the least recently used entry's buffers when full
+    Entry* entry;
+    if (static_cast<int>(m_layouts.size()) >= m_maxLayouts) {
+        entry = &*std::min_element(m_layouts.begin(), m_layouts.end(),
+                                   [](const Entry& a, const Entry& b) { return a.lastUse < b.lastUse; });
+    } else {
+        m_layouts.emplace_back();
+        entry = &m_layouts.back();
+    }
+    build(entry->layout, text, fontSize, maxWidth);
+    entry->lastUse = m_useCounter;
+    m_builds++;
+    return entry->layout;
+}
+
+void TextLayoutCache::clear() {
+    m_layouts.clear();
+}
+
+void TextLayoutCache::build(TextLayout& layout, const std::string& text, int fontSize, int maxWidth) {
+    layout.source = text;
+    layout.fontSize = fontSize;
+    layout.maxWidth = maxWidth;
+    layout.lines.clear();
+    layout.glyphs.clear();
+
+    // Widths are summed from unscaled advances and scaled once, like UIFont::measureText,
+    // so lines break exactly where measuring them would
+    float scale = UIFont::getScale(fontSize);
+    float spacing = UIFont::getSpacing(fontSize);
+    auto getWidth = [scale, spacing](float advances, int glyphCount) {
+        return glyphCount > 0 ? advances * scale + (glyphCount - 1) * spacing : 0.0f;
+    };
+    float spaceAdvance = UIFont::getGlyph(' ').advance;
+    std::vector<WordGlyph> word;
+    float lineAdvances = 0.0f;   // Of the current line, unscaled
+    float x = 0.0f;              // Where the next glyph of the current line goes
+
+    size_t pos = 0;
+    while (pos < text.size()) {
+        if (isSpace(text[pos])) {
+            pos++;
+            continue;
+        }
+        size_t wordStart = pos;
+        while (pos < text.size() && !isSpace(text[pos])) {
+            pos++;
+        }
+
+        word.clear();
+        float wordAdvances = 0.0f;
+        for (size_t i = wordStart; i < pos;) {
+            int size = 0;
+            int codepoint = GetCodepointNext(text.c_str() + i, &size);
+            i += std::max(size, 1);
+            float advance = UIFont::getGlyph(codepoint).advance;
+            wordAdvances += advance;
+            word.push_back({codepoint, advance});
+        }
+
+        // Joins the current line after a space if it still fits, else starts a new one
+        TextLine* line = layout.lines.empty() ? nullptr : &layout.lines.back();
+        if (line) {
+            float advances = lineAdvances + spaceAdvance + wordAdvances;
+            int glyphCount = line->glyphCount + 1 + static_cast<int>(word.size());
+            if (static_cast<int>(getWidth(advances, glyphCount)) > maxWidth) {
+                line = nullptr;
+            } else {
+                layout.glyphs.push_back({' ', x});
+                x += spaceAdvance * scale + spacing;
+                lineAdvances += spaceAdvance;
+                line->glyphCount++;
+            }
+        }
+        if (!line) {
+            layout.lines.push_back({static_cast<int>(layout.glyphs.size()), 0, 0.0f});
+            line = &layout.lines.back();
+            lineAdvances = 0.0f;
+            x = 0.0f;
+        }
+
+        // Positions advance glyph by glyph, the way UIFont::drawText places them
+        for (const WordGlyph& glyph : word) {
+            layout.glyphs.push_back({glyph.codepoint, x});
+            x += glyph.advance * scale + spacing;
+        }
+        lineAdvances += wordAdvances;
+        line->glyphCount += static_cast<int>(word.size());
+        line->width = getWidth(lineAdvances, line->glyphCount);
+    }
+}
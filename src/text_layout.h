@@ -0,0 +1,67 @@
+#pragma once
+
+#include <raylib.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// A glyph placed by TextLayout, relative to the start of its line
+struct TextGlyph {
+    int codepoint;
+    float x;
+};
+
+struct TextLine {
+    int firstGlyph;     // Into TextLayout::glyphs
+    int glyphCount;
+    float width;        // In pixels, as UIFont::measureText would report it
+};
+
+// Text word-wrapped to a width in the UI font. Words are split at whitespace and a
+// line breaks before the word that would make it wider than maxWidth; a word that is wider
+// on its own gets a line to itself.
+struct TextLayout {
+    std::string source;
+    int fontSize = 0;
+    int maxWidth = 0;
+    std::vector<TextLine> lines;
+    std::vector<TextGlyph> glyphs; // Line by line, spaces between words included
+
+    // Draws the placed glyphs line by line from (x, y) with UIFont, without decoding or
+    // measuring the text again
+    void draw(int x, int y, int lineHeight, Color color) const;
+};
+
+// Wrapped text by (string, font size, width). Scenes ask for the same dialog line or item
+// description every frame; get() lays it out the first time and hands back the stored
+// layout after that, and draw() places its stored glyphs, so a frame's text costs no
+// decoding, measuring or wrapping. The least recently used layout goes when the cache is full.
+class TextLayoutCache {
+public:
+    static constexpr int DEFAULT_MAX_LAYOUTS = 32;
+
+    explicit TextLayoutCache(int maxLayouts = DEFAULT_MAX_LAYOUTS);
+
+    // Valid until the next get() or clear()
+    const TextLayout& get(const std::string& text, int fontSize, int maxWidth);
+    void clear();
+
+    int getLayoutCount() const { return static_cast<int>(m_layouts.size()); }
+    int getBuildCount() const { return m_builds; } // Since creation
+    int getHitCount() const { return m_hits; }
+
+    // Lays out text without caching
+    static void build(TextLayout& layout, const std::string& text, int fontSize, int maxWidth);
+
+private:
+    struct Entry {
+        TextLayout layout;
+        uint64_t lastUse;
+    };
+
+    int m_maxLayouts;
+    std::vector<Entry> m_layouts;
+    uint64_t m_useCounter;
+    int m_builds;
+    int m_hits;
+};
@@ -0,0 +1,161 @@
+#include "texture_atlas.h"
+#include <algorithm>
+#include <iostream>
+
+TextureAtlas::TextureAtlas(int pageSize) : m_pageSize(std::max(64, pageSize)) {}
+
+TextureAtlas::~TextureAtlas() {
+    unloadPages();
+    for (auto& source : m_images) {
+        UnloadImage(source.image);
+    }
+}
+
+bool TextureAtlas::addImageFile(const std::string& path) {
+    Image image = LoadImage(path.c_str());
+    if (image.data == nullptr) {
+        std::cerr << "Failed to load atlas image: " << path << std::endl;
+        return false;
+    }
+    addImage(nameFromPath(path), image);
+    return true;
+}
+
+int TextureAtlas::addDirectory(const std::string& directory) {
+    FilePathList files = LoadDirectoryFilesEx(directory.c_str(), ".png", false);
+
+    // Sorted so the packing (and therefore every region) is the same on every run
+    std::vector<std::string> paths(files.paths, files.paths + files.count);
+    UnloadDirectoryFiles(files);
+    std::sort(paths.begin(), paths.end());
+
+    int added = 0;
+    for (const auto& path : paths) {
+        if (addImageFile(path)) {
+            added++;
+        }
+    }
+    return added;
+}
+
+void TextureAtlas::addImage(const std::string& name, Image image) {
+    for (auto& source : m_images) {
+        if (source.name == name) {
+            UnloadImage(source.image);
+            source.image = image;
+            return;
+        }
+    }
+    m_images.push_back({name, image});
+}
+
+bool TextureAtlas::build() {
+    unloadPages();
+    m_regions.clear();
+    if (m_images.empty()) {
+        return true;
+    }
+
+    // Shelf packing: tallest images first, filled left to right in rows ("shelves")
+    std::vector<const SourceImage*> order;
+    for (const auto& source : m_images) {
+        order.push_back(&source);
+    }
+    std::stable_sort(order.begin(), order.end(), [](const SourceImage* a, const SourceImage* b) {
+        return a->image.height > b->image.height;
+    });
+
+    struct PageLayout {
+        int width;
+        int usedHeight;
+        std::vector<std::pair<const SourceImage*, Rectangle>> placements;
+    };
+    std::vector<PageLayout> layouts;
+    int shelfX = 0;
+    int shelfY = 0;
+    int shelfHeight = 0;
+
+    for (const SourceImage* source : order) {
+        int width = source->image.width + PADDING;
+        int height = source->image.height + PADDING;
+
+        if (width > m_pageSize || height > m_pageSize) {
+            // Too big to share a page: give it one of its own
+            layouts.push_back({width, height, {}});
+            layouts.back().placements.emplace_back(source, Rectangle{0.0f, 0.0f,
+                static_cast<float>(source->image.width), static_cast<float>(source->image.height)});
+            shelfX = shelfY = shelfHeight = 0;
+            layouts.push_back({m_pageSize, 0, {}});
+            continue;
+        }
+
+        if (layouts.empty()) {
+            layouts.push_back({m_pageSize, 0, {}});
+        }
+        if (shelfX + width > m_pageSize) {
+            shelfY += shelfHeight;
+            shelfX = 0;
+            shelfHeight = 0;
+        }
+        if (shelfY + height > m_pageSize) {
+            layouts.push_back({m_pageSize, 0, {}});
+            shelfX = shelfY = shelfHeight = 0;
+        }
+
+        PageLayout& layout = layouts.back();
+        layout.placements.emplace_back(source, Rectangle{static_cast<float>(shelfX), static_cast<float>(shelfY),
+            static_cast<float>(source->image.width), static_cast<float>(source->image.height)});
+        layout.usedHeight = std::max(layout.usedHeight, shelfY + height);
+        shelfX += width;
+        shelfHeight = std::max(shelfHeight, height);
+    }
+
+    for (const PageLayout& layout : layouts) {
+        if (layout.placements.empty()) {
+            continue;
+        }
+
+        // Pages are only as tall as their content
+        Image page = GenImageColor(layout.width, layout.usedHeight, BLANK);
+        int pageIndex = static_cast<int>(m_pages.size());
+        for (const auto& placement : layout.placements) {
+            const Image& image = placement.first->image;
+            Rectangle source = {0.0f, 0.0f, static_cast<float>(image.width), static_cast<float>(image.height)};
+            ImageDraw(&page, image, source, placement.second, WHITE);
+            m_regions[placement.first->name] = {pageIndex, placement.second};
+        }
+
+        Texture2D texture = LoadTextureFromImage(page);
+        UnloadImage(page);
+        if (texture.id == 0) {
+            std::cerr << "Failed to upload atlas page " << pageIndex << std::endl;
+            unloadPages();
+            m_regions.clear();
+            return false;
+        }
+        m_pages.push_back(texture);
+    }
+    return true;
+}
+
+const AtlasRegion* TextureAtlas::find(const std::string& name) const {
+    auto it = m_regions.find(name);
+    return it == m_regions.end() ? nullptr : &it->second;
+}
+
+std::string TextureAtlas::nameFromPath(const std::string& path) {
+    size_t start = path.find_last_of("/\\");
+    start = start == std::string::npos ? 0 : start + 1;
+    size_t end = path.find_last_of('.');
+    if (end == std::string::npos || end < start) {
+        end = path.size();
+    }
+    return path.substr(start, end - start);
+}
+
+void TextureAtlas::unloadPages() {
+    for (const auto& page : m_pages) {
+        UnloadTexture(page);
+    }
+    m_pages.clear();
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <raylib.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Where a packed image ended up
+struct AtlasRegion {
+    int page;
+    Rectangle rect; // In pixels on the page texture
+};
+
+// Packs many small images (tilesets, sprite sheets, portraits) into a few large page
+// textures, so everything drawn from one page shares a texture binding and raylib can
+// batch it into a single draw call. Images are looked up by name: the file name
+// without directory and extension ("assets/player.png" -> "player").
+class TextureAtlas {
+public:
+    static constexpr int DEFAULT_PAGE_SIZE = 1024;
+    static constexpr int PADDING = 2; // Transparent pixels between regions, against bleeding
+
+    explicit TextureAtlas(int pageSize = DEFAULT_PAGE_SIZE);
+    ~TextureAtlas();
+
+    TextureAtlas(const TextureAtlas&) = delete;
+    TextureAtlas& operator=(const TextureAtlas&) = delete;
+
+    // Queue images for packing. Later images replace earlier ones with the same name.
+    bool addImageFile(const std::string& path);
+    int addDirectory(const std::string& directory); // Every .png directly inside; returns the count
+    void addImage(const std::string& name, Image image); // Takes ownership of the image
+
+    // Packs the queued images into pages and uploads them (needs a GL context).
+    // Can be called again after adding more images; that rebuilds every page.
+    bool build();
+
+    // nullptr if no image with that name was packed
+    const AtlasRegion* find(const std::string& name) const;
+
+    const Texture2D& getPage(int page) const { return m_pages[page]; }
+    int getPageCount() const { return static_cast<int>(m_pages.size()); }
+    int getRegionCount() const { return static_cast<int>(m_regions.size()); }
+
+    static std::string nameFromPath(const std::string& path);
+
+private:
+    struct SourceImage {
+        std::string name;
+        Image image;
+    };
+
+    void unloadPages();
+
+    int m_pageSize;
+    std::vector<SourceImage> m_images; // Kept so build() can run again
+    std::vector<Texture2D> m_pages;
+    std::unordered_map<std::string, AtlasRegion> m_regions;
+};
@@ -0,0 +1,38 @@
+#include "texture_cache.h"
+
+std::unordered_map<std::string, TextureCache::Entry> TextureCache::s_textures;
+int TextureCache::s_hits = 0;
+int TextureCache::s_misses = 0;
+size_t TextureCache::s_residentBytes = 0;
+
+TextureCache::Handle TextureCache::load(const std::string& path) {
+    auto it = s_textures.find(path);
+    if (it != s_textures.end()) {
+        if (Handle texture = it->second.texture.lock()) {
+            s_hits++;
+            return texture;
+        }
+    }
+
+    s_misses++;
+    Texture2D texture = LoadTexture(path.c_str());
+    if (texture.id == 0) {
+        return nullptr;
+    }
+
+    // The last handle unloads the texture and drops the entry
+    Handle handle(new Texture2D(texture), [path](const Texture2D* loaded) {
+        auto entry = s_textures.find(path);
+        if (entry != s_textures.end() && entry->second.texture.expired()) {
+            s_residentBytes -= entry->second.bytes;
+            s_textures.erase(entry);
+        }
+        UnloadTexture(*loaded);
+        delete loaded;
+    });
+
+    size_t bytes = static_cast<size_t>(GetPixelDataSize(texture.width, texture.height, texture.format));
+    s_textures[path] = {handle, bytes};
+    s_residentBytes += bytes;
+    return handle;
+}
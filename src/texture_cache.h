@@ -0,0 +1,37 @@
+#pragma once
+
+#include <raylib.h>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+// Textures loaded from image files, shared by path.
+//
+// load() hands out reference-counted handles: every sprite using "assets/guard.png"
+// holds the same texture, uploaded once, and it is unloaded when the last handle goes
+// away. Copying a handle never loads or unloads anything.
+// Like DrawStats this is process-wide state for the main (GL) thread.
+class TextureCache {
+public:
+    using Handle = std::shared_ptr<const Texture2D>;
+
+    // Null if the file can't be loaded
+    static Handle load(const std::string& path);
+
+    static int getHitCount() { return s_hits; }     // Loads served by a resident texture
+    static int getMissCount() { return s_misses; }  // Loads that went to the file
+    static int getResidentCount() { return static_cast<int>(s_textures.size()); }
+    static size_t getResidentBytes() { return s_residentBytes; }
+
+private:
+    struct Entry {
+        std::weak_ptr<const Texture2D> texture;
+        size_t bytes;
+    };
+
+    static std::unordered_map<std::string, Entry> s_textures;
+    static int s_hits;
+    static int s_misses;
+    static size_t s_residentBytes;
+};
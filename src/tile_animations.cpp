@@ -0,0 +1,88 @@
+#include "tile_animations.h"
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+bool TileAnimations::loadFromFile(const std::string& path) {
+    std::ifstream input(path);
+    if (!input) {
+        std::cerr << "Failed to open tile animations: " << path << std::endl;
+        return false;
+    }
+
+    TileAnimations loaded;
+
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(input, line)) {
+        lineNumber++;
+        line = line.substr(0, line.find('#'));
+
+        std::istringstream fields(line);
+        int tileId;
+        if (!(fields >> tileId)) {
+            // Blank or comment-only line
+            if (line.find_first_not_of(" \t\r") == std::string::npos) {
+                continue;
+            }
+            std::cerr << path << ":" << lineNumber << ": expected a tile ID" << std::endl;
+            return false;
+        }
+
+        float frameDuration;
+        if (!(fields >> frameDuration)) {
+            std::cerr << path << ":" << lineNumber << ": expected a frame duration" << std::endl;
+            return false;
+        }
+
+        std::vector<TileId> frames;
+        int frame;
+        while (fields >> frame) {
+            if (frame < 0 || frame >= 0xFFFF) {
+                std::cerr << path << ":" << lineNumber << ": frame tile ID out of range" << std::endl;
+                return false;
+            }
+            frames.push_back(static_cast<TileId>(frame));
+        }
+        if (!fields.eof()) {
+            std::cerr << path << ":" << lineNumber << ": expected a frame tile ID" << std::endl;
+            return false;
+        }
+
+        if (tileId < 0 || tileId >= 0xFFFF || !loaded.add(static_cast<TileId>(tileId), frames, frameDuration)) {
+            std::cerr << path << ":" << lineNumber << ": invalid animation (needs a tile ID, a positive duration, "
+                      << "at least one frame, and at most " << MAX_ANIMATIONS << " animations)" << std::endl;
+            return false;
+        }
+    }
+
+    *this = std::move(loaded);
+    return true;
+}
+
+bool TileAnimations::add(TileId tile, const std::vector<TileId>& frames, float frameDuration) {
+    if (frames.empty() || !(frameDuration > 0.0f)) {
+        return false;
+    }
+
+    int index = getAnimationIndex(tile);
+    if (index >= 0) {
+        m_animations[index] = {tile, frames, frameDuration};
+        return true;
+    }
+    if (static_cast<int>(m_animations.size()) >= MAX_ANIMATIONS) {
+        return false;
+    }
+
+    if (tile >= m_lookup.size()) {
+        m_lookup.resize(tile + 1, -1);
+    }
+    m_lookup[tile] = static_cast<int>(m_animations.size());
+    m_animations.push_back({tile, frames, frameDuration});
+    return true;
+}
+
+void TileAnimations::clear() {
+    m_animations.clear();
+    m_lookup.clear();
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "tile_layer.h"
+#include <string>
+#include <vector>
+
+// An animated tile: cells holding `tile` cycle through `frames`, each shown for
+// frameDuration seconds. The map itself never changes; renderers pick the frame.
+struct TileAnimation {
+    TileId tile;
+    std::vector<TileId> frames;
+    float frameDuration;
+
+    TileId getFrame(double time) const {
+        long long step = static_cast<long long>(time / frameDuration);
+        return frames[static_cast<size_t>(step % static_cast<long long>(frames.size()))];
+    }
+};
+
+// Animation table for a tileset, indexed by tile ID
+class TileAnimations {
+public:
+    // The batched tile shader keeps one UV offset per animation in a uniform array
+    static constexpr int MAX_ANIMATIONS = 32;
+
+    // Text format, one animation per line: <tileId> <frameDuration> <frameTileId> [frameTileId...]
+    // Duration is in seconds. '#' starts a comment.
+    // Replaces the whole table; returns false (keeping the old table) on error.
+    bool loadFromFile(const std::string& path);
+
+    // Returns false if the animation is invalid or the table is full. Replaces any
+    // existing animation of the same tile.
+    bool add(TileId tile, const std::vector<TileId>& frames, float frameDuration);
+    void clear();
+
+    // Index into getAnimations(), -1 for static tiles
+    int getAnimationIndex(TileId tile) const { return tile < m_lookup.size() ? m_lookup[tile] : -1; }
+    bool isAnimated(TileId tile) const { return getAnimationIndex(tile) >= 0; }
+
+    // Tile to draw for a cell holding `tile` at the given time
+    TileId getFrameTile(TileId tile, double time) const {
+        int index = getAnimationIndex(tile);
+        return index < 0 ? tile : m_animations[index].getFrame(time);
+    }
+
+    const std::vector<TileAnimation>& getAnimations() const { return m_animations; }
+    bool empty() const { return m_animations.empty(); }
+
+private:
+    std::vector<TileAnimation> m_animations;
+    std::vector<int> m_lookup;
+};
@@ -0,0 +1,229 @@
+#include "tile_layer.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+TileLayer::TileLayer(int width, int height, TileId defaultTile)
+    : m_chunksX((width + TileChunk::SIZE - 1) / TileChunk::SIZE), m_defaultTile(defaultTile) {
+    int chunksY = (height + TileChunk::SIZE - 1) / TileChunk::SIZE;
+    m_chunks.resize(m_chunksX * chunksY);
+    for (auto& chunk : m_chunks) {
+        chunk.uniformTile = defaultTile;
+    }
+}
+
+bool TileLayer::setTile(int x, int y, TileId tileId) {
+    if (getTile(x, y) == tileId) {
+        return false;
+    }
+
+    ChunkStorage& chunk = m_chunks[chunkIndexOf(x, y)];
+    int offset = offsetInChunk(x, y);
+    chunk.revision++;
+
+    if (chunk.encoding == ChunkEncoding::DENSE) {
+        reinterpret_cast<TileId*>(chunk.data)[offset] = tileId;
+        return true;
+    }
+
+    if (chunk.encoding == ChunkEncoding::PALETTE) {
+        auto* palette = reinterpret_cast<TileId*>(chunk.data);
+        int index = static_cast<int>(std::find(palette, palette + chunk.paletteSize, tileId) - palette);
+
+        // The palette always has room for every index value of the current width
+        if (index == chunk.paletteSize && index < (1 << chunk.indexBits)) {
+            palette[chunk.paletteSize++] = tileId;
+        }
+        if (index < chunk.paletteSize) {
+            int bit = offset * chunk.indexBits;
+            uint64_t& word = chunk.data[chunk.paletteWords + bit / 64];
+            uint64_t mask = ((uint64_t(1) << chunk.indexBits) - 1) << (bit % 64);
+            word = (word & ~mask) | (static_cast<uint64_t>(index) << (bit % 64));
+            return true;
+        }
+    }
+
+    // Uniform chunk or full palette: switch to the next larger encoding
+    std::array<TileId, TileChunk::AREA> tiles;
+    decodeChunk(chunk, tiles.data());
+    tiles[offset] = tileId;
+    encodeChunk(chunk, tiles.data());
+    return true;
+}
+
+ChunkData TileLayer::getChunkData(int chunkIndex) const {
+    const ChunkStorage& chunk = m_chunks[chunkIndex];
+    ChunkData result = {chunk.encoding, chunk.uniformTile, 0, 0, nullptr, nullptr, nullptr};
+    if (chunk.encoding == ChunkEncoding::PALETTE) {
+        result.paletteSize = chunk.paletteSize;
+        result.indexBits = chunk.indexBits;
+        result.palette = reinterpret_cast<const TileId*>(chunk.data);
+        result.indices = chunk.data + chunk.paletteWords;
+    } else if (chunk.encoding == ChunkEncoding::DENSE) {
+        result.tiles = reinterpret_cast<const TileId*>(chunk.data);
+    }
+    return result;
+}
+
+int TileLayer::getResidentChunkCount() const {
+    int count = 0;
+    for (int i = 0; i < getChunkCount(); i++) {
+        if (!isChunkUniform(i, m_defaultTile)) {
+            count++;
+        }
+    }
+    return count;
+}
+
+size_t TileLayer::getMemoryUsage() const {
+    size_t bytes = m_chunks.size() * sizeof(ChunkStorage);
+    for (const auto& chunk : m_chunks) {
+        bytes += getChunkBytes(chunk);
+    }
+    return bytes;
+}
+
+void TileLayer::compact() {
+    std::array<TileId, TileChunk::AREA> tiles;
+    for (auto& chunk : m_chunks) {
+        // Mapped chunks were already encoded by the writer
+        if (chunk.encoding == ChunkEncoding::UNIFORM || !chunk.owned) {
+            continue;
+        }
+        decodeChunk(chunk, tiles.data());
+        encodeChunk(chunk, tiles.data());
+    }
+}
+
+void TileLayer::attachUniformChunk(int chunkIndex, TileId tileId) {
+    ChunkStorage& chunk = m_chunks[chunkIndex];
+    chunk.owned.reset();
+    chunk.data = nullptr;
+    chunk.encoding = ChunkEncoding::UNIFORM;
+    chunk.uniformTile = tileId;
+    chunk.revision++;
+}
+
+void TileLayer::attachPaletteChunk(int chunkIndex, uint64_t* data, int paletteSize, int indexBits) {
+    ChunkStorage& chunk = m_chunks[chunkIndex];
+    chunk.owned.reset();
+    chunk.data = data;
+    chunk.encoding = ChunkEncoding::PALETTE;
+    chunk.paletteSize = static_cast<uint16_t>(paletteSize);
+    chunk.paletteWords = static_cast<uint8_t>(paletteWordCount(1 << indexBits));
+    chunk.indexBits = static_cast<uint8_t>(indexBits);
+    chunk.revision++;
+}
+
+void TileLayer::attachDenseChunk(int chunkIndex, TileId* tiles) {
+    ChunkStorage& chunk = m_chunks[chunkIndex];
+    chunk.owned.reset();
+    chunk.data = reinterpret_cast<uint64_t*>(tiles);
+    chunk.encoding = ChunkEncoding::DENSE;
+    chunk.revision++;
+}
+
+void TileLayer::installChunk(int chunkIndex, LoadedChunk&& loaded) {
+    ChunkStorage& chunk = m_chunks[chunkIndex];
+    chunk.owned = std::move(loaded.data);
+    chunk.data = chunk.owned.get();
+    chunk.encoding = loaded.encoding;
+    chunk.uniformTile = loaded.uniformTile;
+    chunk.paletteSize = static_cast<uint16_t>(loaded.paletteSize);
+    chunk.indexBits = static_cast<uint8_t>(loaded.indexBits);
+    chunk.paletteWords = loaded.encoding == ChunkEncoding::PALETTE
+                             ? static_cast<uint8_t>(paletteWordCount(1 << loaded.indexBits)) : 0;
+    chunk.revision++;
+}
+
+void TileLayer::evictChunk(int chunkIndex) {
+    ChunkStorage& chunk = m_chunks[chunkIndex];
+    chunk.owned.reset();
+    chunk.data = nullptr;
+    chunk.encoding = ChunkEncoding::UNIFORM;
+    chunk.uniformTile = m_defaultTile;
+    chunk.revision++;
+}
+
+LoadedChunk TileLayer::encodeLoadedChunk(const TileId* tiles) {
+    ChunkStorage chunk;
+    encodeChunk(chunk, tiles);
+
+    LoadedChunk loaded;
+    loaded.encoding = chunk.encoding;
+    loaded.uniformTile = chunk.uniformTile;
+    loaded.paletteSize = chunk.paletteSize;
+    loaded.indexBits = chunk.indexBits;
+    loaded.data = std::move(chunk.owned);
+    return loaded;
+}
+
+void TileLayer::decodeChunk(const ChunkStorage& chunk, TileId* tiles) const {
+    if (chunk.encoding == ChunkEncoding::UNIFORM) {
+        std::fill(tiles, tiles + TileChunk::AREA, chunk.uniformTile);
+    } else if (chunk.encoding == ChunkEncoding::DENSE) {
+        std::memcpy(tiles, chunk.data, TileChunk::AREA * sizeof(TileId));
+    } else {
+        const auto* palette = reinterpret_cast<const TileId*>(chunk.data);
+        const uint64_t* indices = chunk.data + chunk.paletteWords;
+        uint64_t mask = (uint64_t(1) << chunk.indexBits) - 1;
+        for (int i = 0; i < TileChunk::AREA; i++) {
+            int bit = i * chunk.indexBits;
+            tiles[i] = palette[(indices[bit / 64] >> (bit % 64)) & mask];
+        }
+    }
+}
+
+void TileLayer::encodeChunk(ChunkStorage& chunk, const TileId* tiles) {
+    std::array<TileId, TileChunk::AREA> palette;
+    std::copy(tiles, tiles + TileChunk::AREA, palette.begin());
+    std::sort(palette.begin(), palette.end());
+    int paletteSize = static_cast<int>(std::unique(palette.begin(), palette.end()) - palette.begin());
+
+    chunk.owned.reset();
+    chunk.data = nullptr;
+
+    if (paletteSize == 1) {
+        chunk.encoding = ChunkEncoding::UNIFORM;
+        chunk.uniformTile = tiles[0];
+        return;
+    }
+
+    if (paletteSize > 256) {
+        chunk.encoding = ChunkEncoding::DENSE;
+        chunk.owned = std::make_unique<uint64_t[]>(TileChunk::AREA * sizeof(TileId) / sizeof(uint64_t));
+        chunk.data = chunk.owned.get();
+        std::memcpy(chunk.data, tiles, TileChunk::AREA * sizeof(TileId));
+        return;
+    }
+
+    // Index width is a power of two so an index never straddles two words.
+    // Reserve palette slots up to the width's capacity so edits rarely re-encode.
+    int indexBits = paletteSize <= 2 ? 1 : paletteSize <= 4 ? 2 : paletteSize <= 16 ? 4 : 8;
+    int paletteWords = paletteWordCount(1 << indexBits);
+    chunk.encoding = ChunkEncoding::PALETTE;
+    chunk.paletteSize = static_cast<uint16_t>(paletteSize);
+    chunk.paletteWords = static_cast<uint8_t>(paletteWords);
+    chunk.indexBits = static_cast<uint8_t>(indexBits);
+    chunk.owned = std::make_unique<uint64_t[]>(paletteWords + indexWordCount(indexBits)); // Zeroed
+    chunk.data = chunk.owned.get();
+
+    std::copy(palette.begin(), palette.begin() + paletteSize, reinterpret_cast<TileId*>(chunk.data));
+    uint64_t* indices = chunk.data + paletteWords;
+    for (int i = 0; i < TileChunk::AREA; i++) {
+        uint64_t index = std::lower_bound(palette.begin(), palette.begin() + paletteSize, tiles[i]) - palette.begin();
+        int bit = i * indexBits;
+        indices[bit / 64] |= index << (bit % 64);
+    }
+}
+
+size_t TileLayer::getChunkBytes(const ChunkStorage& chunk) {
+    switch (chunk.encoding) {
+        case ChunkEncoding::PALETTE:
+            return (chunk.paletteWords + indexWordCount(chunk.indexBits)) * sizeof(uint64_t);
+        case ChunkEncoding::DENSE:
+            return TileChunk::AREA * sizeof(TileId);
+        default:
+            return 0;
+    }
+}
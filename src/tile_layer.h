@@ -0,0 +1,137 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+using TileId = uint16_t;
+
+// Chunk geometry shared by every layer
+struct TileChunk {
+    static constexpr int SIZE = 32;
+    static constexpr int AREA = SIZE * SIZE;
+};
+
+// How a chunk's tiles are stored. Values match the .jmap chunk block encoding.
+enum class ChunkEncoding : uint8_t {
+    UNIFORM = 0,    // Every tile is the same, no tile memory at all
+    PALETTE = 1,    // Up to 256 distinct tiles, 1/2/4/8-bit indices packed into 64-bit words
+    DENSE = 2       // TileChunk::AREA tile IDs in row-major order
+};
+
+// Read-only view of a chunk's storage (used when writing .jmap files)
+struct ChunkData {
+    ChunkEncoding encoding;
+    TileId uniformTile;         // UNIFORM
+    int paletteSize;            // PALETTE
+    int indexBits;              // PALETTE
+    const TileId* palette;      // PALETTE
+    const uint64_t* indices;    // PALETTE: TileChunk::AREA * indexBits / 64 words
+    const TileId* tiles;        // DENSE
+};
+
+// Chunk storage built off the main thread (e.g. by ChunkStreamer) and handed to
+// TileLayer::installChunk. Data uses the same layout as a .jmap chunk block payload.
+struct LoadedChunk {
+    ChunkEncoding encoding = ChunkEncoding::UNIFORM;
+    TileId uniformTile = 0;
+    int paletteSize = 0;
+    int indexBits = 0;
+    std::unique_ptr<uint64_t[]> data;   // PALETTE / DENSE
+};
+
+// One layer of tile IDs stored as a grid of compressed chunks.
+// Chunks start out uniform (the layer's default tile) and only grow a palette or a
+// dense tile array once different tiles are written, so large areas of grass or water
+// cost a few bytes per chunk. getTile stays O(1) for every encoding. Each chunk has a
+// revision counter that is bumped whenever one of its tiles changes, which render
+// caches use to find out what needs rebuilding.
+class TileLayer {
+public:
+    TileLayer(int width, int height, TileId defaultTile);
+
+    // Coordinates must be inside the layer
+    TileId getTile(int x, int y) const {
+        const ChunkStorage& chunk = m_chunks[chunkIndexOf(x, y)];
+        int offset = offsetInChunk(x, y);
+        switch (chunk.encoding) {
+            case ChunkEncoding::UNIFORM:
+                return chunk.uniformTile;
+            case ChunkEncoding::PALETTE: {
+                int bit = offset * chunk.indexBits;
+                uint64_t word = chunk.data[chunk.paletteWords + bit / 64];
+                int index = static_cast<int>((word >> (bit % 64)) & ((uint64_t(1) << chunk.indexBits) - 1));
+                return reinterpret_cast<const TileId*>(chunk.data)[index];
+            }
+            default:
+                return reinterpret_cast<const TileId*>(chunk.data)[offset];
+        }
+    }
+    bool setTile(int x, int y, TileId tileId); // Returns true if the tile changed
+
+    TileId getDefaultTile() const { return m_defaultTile; }
+
+    ChunkData getChunkData(int chunkIndex) const;
+    bool isChunkUniform(int chunkIndex, TileId tileId) const {
+        const ChunkStorage& chunk = m_chunks[chunkIndex];
+        return chunk.encoding == ChunkEncoding::UNIFORM && chunk.uniformTile == tileId;
+    }
+    uint32_t getChunkRevision(int chunkIndex) const { return m_chunks[chunkIndex].revision; }
+    int getChunkCount() const { return static_cast<int>(m_chunks.size()); }
+
+    // Chunks holding anything other than the default tile
+    int getResidentChunkCount() const;
+
+    // Bookkeeping plus tile storage, whether owned or mapped from a file
+    size_t getMemoryUsage() const;
+
+    // Re-encode every owned chunk with the smallest encoding for its current tiles.
+    // Palettes only grow while tiles are edited, so call this after bulk edits.
+    void compact();
+
+    // Use externally owned memory (e.g. a mapped file) as a chunk's storage.
+    // The memory must outlive the layer; tiles/indices are written in place on edits.
+    // Palette data holds paletteWordCount(1 << indexBits) palette words, then the indices.
+    void attachUniformChunk(int chunkIndex, TileId tileId);
+    void attachPaletteChunk(int chunkIndex, uint64_t* data, int paletteSize, int indexBits);
+    void attachDenseChunk(int chunkIndex, TileId* tiles);
+
+    // Take ownership of a loaded chunk / drop a chunk back to the default tile.
+    // Both only swap pointers, so they are cheap enough to run on the main thread.
+    void installChunk(int chunkIndex, LoadedChunk&& loaded);
+    void evictChunk(int chunkIndex);
+    size_t getChunkMemoryUsage(int chunkIndex) const { return getChunkBytes(m_chunks[chunkIndex]); }
+
+    // Smallest encoding of TileChunk::AREA row-major tiles, ready for installChunk.
+    // Touches no layer state, so chunk generators can call it from worker threads.
+    static LoadedChunk encodeLoadedChunk(const TileId* tiles);
+
+    // Words taken by paletteSize palette entries / by the indices of one chunk
+    static int paletteWordCount(int paletteSize) { return (paletteSize + 3) / 4; }
+    static int indexWordCount(int indexBits) { return TileChunk::AREA * indexBits / 64; }
+
+private:
+    // 32 bytes per chunk so uniform chunks stay cheap on 16k x 16k maps
+    struct ChunkStorage {
+        uint64_t* data = nullptr;           // PALETTE: palette words then indices, DENSE: tiles
+        std::unique_ptr<uint64_t[]> owned;  // Backs data unless it points into a mapped file
+        uint32_t revision = 0;
+        TileId uniformTile = 0;
+        uint16_t paletteSize = 0;
+        uint8_t paletteWords = 0;           // Offset of the indices in data
+        uint8_t indexBits = 0;
+        ChunkEncoding encoding = ChunkEncoding::UNIFORM;
+    };
+
+    int chunkIndexOf(int x, int y) const { return (y / TileChunk::SIZE) * m_chunksX + (x / TileChunk::SIZE); }
+    static int offsetInChunk(int x, int y) { return (y % TileChunk::SIZE) * TileChunk::SIZE + (x % TileChunk::SIZE); }
+
+    void decodeChunk(const ChunkStorage& chunk, TileId* tiles) const;
+    static void encodeChunk(ChunkStorage& chunk, const TileId* tiles);
+    static size_t getChunkBytes(const ChunkStorage& chunk);
+
+    int m_chunksX;
+    TileId m_defaultTile;
+    std::vector<ChunkStorage> m_chunks;
+};
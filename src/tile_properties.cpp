@@ -0,0 +1,80 @@
+#include "tile_properties.h"
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+TileProperties::TileProperties() {
+    setFlags(1, TILE_BLOCKING); // Wall
+    setFlags(2, TILE_BLOCKING); // Water
+}
+
+bool TileProperties::loadFromFile(const std::string& path) {
+    std::ifstream input(path);
+    if (!input) {
+        std::cerr << "Failed to open tile properties: " << path << std::endl;
+        return false;
+    }
+
+    TileProperties loaded;
+    loaded.clear();
+
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(input, line)) {
+        lineNumber++;
+        line = line.substr(0, line.find('#'));
+
+        std::istringstream fields(line);
+        int tileId;
+        if (!(fields >> tileId)) {
+            // Blank or comment-only line
+            if (line.find_first_not_of(" \t\r") == std::string::npos) {
+                continue;
+            }
+            std::cerr << path << ":" << lineNumber << ": expected a tile ID" << std::endl;
+            return false;
+        }
+        if (tileId < 0 || tileId >= 0xFFFF) {
+            std::cerr << path << ":" << lineNumber << ": tile ID out of range" << std::endl;
+            return false;
+        }
+
+        uint8_t flags = 0;
+        std::string name;
+        while (fields >> name) {
+            uint8_t flag;
+            if (!flagFromName(name, flag)) {
+                std::cerr << path << ":" << lineNumber << ": unknown flag '" << name << "'" << std::endl;
+                return false;
+            }
+            flags |= flag;
+        }
+
+        loaded.setFlags(static_cast<TileId>(tileId), flags);
+    }
+
+    m_flags = std::move(loaded.m_flags);
+    return true;
+}
+
+bool TileProperties::flagFromName(const std::string& name, uint8_t& flag) {
+    if (name == "blocking") {
+        flag = TILE_BLOCKING;
+    } else if (name == "encounter") {
+        flag = TILE_ENCOUNTER;
+    } else if (name == "damage") {
+        flag = TILE_DAMAGE;
+    } else if (name == "trigger") {
+        flag = TILE_TRIGGER;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+void TileProperties::setFlags(TileId tileId, uint8_t flags) {
+    if (tileId >= m_flags.size()) {
+        m_flags.resize(tileId + 1, 0);
+    }
+    m_flags[tileId] = flags;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "tile_layer.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Per-tile gameplay flags (bitmask)
+enum TileFlag : uint8_t {
+    TILE_BLOCKING  = 1 << 0,    // Can't be walked on
+    TILE_ENCOUNTER = 1 << 1,    // Random battles can start here
+    TILE_DAMAGE    = 1 << 2,    // Hurts the party when stepped on
+    TILE_TRIGGER   = 1 << 3     // Fires an event when stepped on
+};
+
+// Property table for a tileset, indexed by tile ID.
+// Tiles without an entry have no flags (walkable, no encounters).
+class TileProperties {
+public:
+    // Defaults match the built-in tiles: 1 (wall) and 2 (water) block movement
+    TileProperties();
+
+    // Text format, one tile per line: <tileId> <flag> [flag...]
+    // Flags: blocking, encounter, damage, trigger. '#' starts a comment.
+    // Replaces the whole table; returns false (keeping the old table) on error.
+    bool loadFromFile(const std::string& path);
+
+    // Maps a flag name used in property files ("blocking", ...) to its TileFlag
+    static bool flagFromName(const std::string& name, uint8_t& flag);
+
+    void setFlags(TileId tileId, uint8_t flags);
+    void clear() { m_flags.clear(); }
+    uint8_t getFlags(TileId tileId) const { return tileId < m_flags.size() ? m_flags[tileId] : 0; }
+    bool isBlocking(TileId tileId) const { return (getFlags(tileId) & TILE_BLOCKING) != 0; }
+
+    // Flags of tile IDs [0, getTileCount()), for serialization
+    int getTileCount() const { return static_cast<int>(m_flags.size()); }
+    const uint8_t* getFlagData() const { return m_flags.data(); }
+
+private:
+    std::vector<uint8_t> m_flags;
+};
@@ -1,22 +1,55 @@
 #include "tilemap.h"
+#include "jmap_format.h"
+#include "mapped_file.h"
+#include "draw_stats.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
 #include <iostream>
+#include <iterator>
 
 Tilemap::Tilemap(int width, int height, int tileSize)
     : m_width(width), m_height(height), m_tileSize(tileSize),
-      m_hasTileset(false), m_tilesPerRow(0) {
-    m_tiles.resize(height, std::vector<int>(width, 0));
+      m_chunksX((width + TileChunk::SIZE - 1) / TileChunk::SIZE),
+      m_chunksY((height + TileChunk::SIZE - 1) / TileChunk::SIZE),
+      m_revision(0),
+      m_animationTime(0.0),
+      m_collision(width, height),
+      m_collisionRevisions(static_cast<size_t>(m_chunksX) * m_chunksY, 0),
+      m_hasTileset(false), m_ownsTileset(false), m_tilesetOrigin{0.0f, 0.0f}, m_tilesPerRow(0),
+      m_renderMode(TileRenderMode::BAKED_CHUNKS),
+      m_chunkCache(TileChunk::SIZE * tileSize, DEFAULT_MAX_BAKED_CHUNKS),
+      m_meshRenderer(DEFAULT_MAX_CHUNK_MESHES),
+      m_lastDrawCalls(0), m_lastBakes(0) {
+    m_layers.reserve(LAYER_COUNT);
+    m_layers.emplace_back(width, height, DEFAULT_TILE);   // GROUND
+    m_layers.emplace_back(width, height, EMPTY_TILE);     // DECORATION
+    m_layers.emplace_back(width, height, EMPTY_TILE);     // OVERLAY
     m_tileset = {0}; // Initialize empty texture
+    m_fallbackTileset = {0};
 }
 
 Tilemap::~Tilemap() {
-    if (m_hasTileset && m_tileset.id > 0) {
+    if (m_ownsTileset && m_tileset.id > 0) {
         UnloadTexture(m_tileset);
     }
+    if (m_fallbackTileset.id > 0) {
+        UnloadTexture(m_fallbackTileset);
+    }
 }
 
 void Tilemap::loadTileset(const std::string& tilesetPath, int tilesPerRow) {
+    if (m_ownsTileset && m_tileset.id > 0) {
+        UnloadTexture(m_tileset);
+    }
     m_tileset = LoadTexture(tilesetPath.c_str());
+    m_tilesetOrigin = {0.0f, 0.0f};
 
+    // Every baked chunk was drawn with the previous tileset
+    m_chunkCache.clear();
+    m_meshRenderer.clear();
+
+    m_ownsTileset = m_tileset.id > 0;
     if (m_tileset.id > 0) {
         m_hasTileset = true;
         m_tilesPerRow = tilesPerRow;
@@ -26,68 +59,926 @@ void Tilemap::loadTileset(const std::string& tilesetPath, int tilesPerRow) {
     }
 }
 
-void Tilemap::setTile(int x, int y, int tileId) {
-    if (x >= 0 && x < m_width && y >= 0 && y < m_height) {
-        m_tiles[y][x] = tileId;
+bool Tilemap::setTileset(const TextureAtlas& atlas, const std::string& name, int tilesPerRow) {
+    const AtlasRegion* region = atlas.find(name);
+    if (!region) {
+        return false;
+    }
+
+    if (m_ownsTileset && m_tileset.id > 0) {
+        UnloadTexture(m_tileset);
+    }
+    m_tileset = atlas.getPage(region->page);
+    m_tilesetOrigin = {region->rect.x, region->rect.y};
+    m_ownsTileset = false;
+    m_hasTileset = true;
+    m_tilesPerRow = tilesPerRow;
+
+    m_chunkCache.clear();
+    m_meshRenderer.clear();
+    return true;
+}
+
+void Tilemap::setTile(int x, int y, int tileId, MapLayer layer) {
+    if (!inBounds(x, y) || tileId >= EMPTY_TILE) {
+        return;
+    }
+
+    TileId tile = tileId < 0 ? EMPTY_TILE : static_cast<TileId>(tileId);
+    if (!m_chunkStreamed.empty()) {
+        int chunkIndex = (y / TileChunk::SIZE) * m_chunksX + x / TileChunk::SIZE;
+        if (!m_chunkStreamed[chunkIndex]) {
+            m_streamEdits[chunkIndex].push_back({x, y, tile, layer});
+        }
+    }
+    if (!getLayer(layer).setTile(x, y, tile)) {
+        return;
+    }
+    m_revision++;
+    if (layer != MapLayer::OVERLAY) {
+        updateCollision(x, y);
+    }
+}
+
+int Tilemap::getTile(int x, int y, MapLayer layer) const {
+    if (!inBounds(x, y)) {
+        return -1;
+    }
+
+    TileId tile = getLayer(layer).getTile(x, y);
+    return tile == EMPTY_TILE ? -1 : tile;
+}
+
+void Tilemap::evictChunk(int chunkX, int chunkY, MapLayer layer) {
+    int chunkIndex = chunkY * m_chunksX + chunkX;
+    getLayer(layer).evictChunk(chunkIndex);
+    m_revision++;
+    if (!m_chunkStreamed.empty()) {
+        m_chunkStreamed[chunkIndex] = 0;
+    }
+}
+
+void Tilemap::finishChunkStream(int chunkX, int chunkY) {
+    int chunkIndex = chunkY * m_chunksX + chunkX;
+    if (m_chunkStreamed.empty() || m_chunkStreamed[chunkIndex]) {
+        return;
+    }
+    m_chunkStreamed[chunkIndex] = 1;
+    m_revision++; // Even with no blocks installed, so map-wide caches notice the chunk loaded
+
+    std::vector<TileEdit> edits;
+    edits.swap(m_streamEdits[chunkIndex]);
+    for (const TileEdit& edit : edits) {
+        if (getLayer(edit.layer).setTile(edit.x, edit.y, edit.tile)) {
+            m_revision++;
+        }
+        // Even when the file had the same tile: the edit's collision was worked out
+        // against the other layer's default tile
+        if (edit.layer != MapLayer::OVERLAY) {
+            updateCollision(edit.x, edit.y);
+        }
+    }
+}
+
+int Tilemap::getResidentChunkCount() const {
+    int count = 0;
+    for (const auto& layer : m_layers) {
+        count += layer.getResidentChunkCount();
     }
+    return count;
 }
 
-int Tilemap::getTile(int x, int y) const {
-    if (x >= 0 && x < m_width && y >= 0 && y < m_height) {
-        return m_tiles[y][x];
+void Tilemap::compact() {
+    for (auto& layer : m_layers) {
+        layer.compact();
     }
-    return -1;
 }
 
-bool Tilemap::isWalkable(int x, int y) const {
-    int tile = getTile(x, y);
-    // Tile ID 1 = wall (not walkable)
-    // Tile ID 2 = water (not walkable)
-    // All other tiles are walkable
-    return tile != 1 && tile != 2 && tile != -1;
+size_t Tilemap::getTileMemoryUsage() const {
+    size_t bytes = 0;
+    for (const auto& layer : m_layers) {
+        bytes += layer.getMemoryUsage();
+    }
+    return bytes;
+}
+
+float Tilemap::getBytesPerTile() const {
+    return static_cast<float>(getTileMemoryUsage()) / (static_cast<float>(m_width) * m_height);
+}
+
+bool Tilemap::isRowSpanWalkable(int y, int x0, int x1) const {
+    if (y < 0 || y >= m_height || x0 < 0 || x1 >= m_width || x0 > x1) {
+        return false;
+    }
+    return !m_collision.anyInRow(y, x0, x1);
+}
+
+bool Tilemap::isAreaWalkable(int x, int y, int w, int h) const {
+    if (w <= 0 || h <= 0 || !inBounds(x, y) || !inBounds(x + w - 1, y + h - 1)) {
+        return false;
+    }
+    return !m_collision.anyInRect(x, y, w, h);
+}
+
+uint8_t Tilemap::getTileFlags(int x, int y) const {
+    if (!inBounds(x, y)) {
+        return 0;
+    }
+    return m_tileProperties.getFlags(getLayer(MapLayer::GROUND).getTile(x, y)) |
+           m_tileProperties.getFlags(getLayer(MapLayer::DECORATION).getTile(x, y));
+}
+
+void Tilemap::setTileProperties(const TileProperties& properties) {
+    m_tileProperties = properties;
+    rebuildCollision();
+}
+
+void Tilemap::setTileAnimations(const TileAnimations& animations) {
+    m_tileAnimations = animations;
+
+    // Baked chunks leave animated cells out and animated meshes are built from the table
+    m_chunkCache.clear();
+    m_meshRenderer.clear();
 }
 
-void Tilemap::render(int cameraOffsetX, int cameraOffsetY) {
+void Tilemap::updateCollision(int x, int y) {
+    // Overlay tiles are drawn above entities and never block movement
+    bool blocked = (getTileFlags(x, y) & TILE_BLOCKING) != 0;
+    if (m_collision.test(x, y) != blocked) {
+        m_collision.set(x, y, blocked);
+        m_collisionRevisions[(y / TileChunk::SIZE) * m_chunksX + x / TileChunk::SIZE]++;
+    }
+}
+
+void Tilemap::rebuildCollision() {
+    const TileLayer& ground = getLayer(MapLayer::GROUND);
+    const TileLayer& decoration = getLayer(MapLayer::DECORATION);
+
+    // Assemble each 64-tile word in a register instead of setting bits one by one
     for (int y = 0; y < m_height; y++) {
-        for (int x = 0; x < m_width; x++) {
-            int tileId = m_tiles[y][x];
-
-            Rectangle destRect = {
-                static_cast<float>(x * m_tileSize - cameraOffsetX),
-                static_cast<float>(y * m_tileSize - cameraOffsetY),
-                static_cast<float>(m_tileSize),
-                static_cast<float>(m_tileSize)
-            };
+        uint64_t* row = m_collision.getWords() + static_cast<size_t>(y) * m_collision.getWordsPerRow();
+        for (int w = 0; w < m_collision.getWordsPerRow(); w++) {
+            uint64_t word = 0;
+            int endX = std::min(m_width, (w + 1) * 64);
+            for (int x = w * 64; x < endX; x++) {
+                bool blocked = m_tileProperties.isBlocking(ground.getTile(x, y)) ||
+                               m_tileProperties.isBlocking(decoration.getTile(x, y));
+                word |= uint64_t(blocked) << (x % 64);
+            }
+            row[w] = word;
+        }
+    }
+
+    // Any tile may have changed
+    for (uint32_t& revision : m_collisionRevisions) {
+        revision++;
+    }
+}
+
+namespace {
+
+uint64_t getChunkBlockSize(const ChunkData& chunk) {
+    jmap::ChunkBlock block = {static_cast<uint16_t>(chunk.encoding), chunk.uniformTile,
+                              static_cast<uint16_t>(chunk.paletteSize), static_cast<uint16_t>(chunk.indexBits)};
+    return jmap::getChunkBlockSize(block);
+}
+
+// True if [offset, offset + length) lies inside a file of the given size. Written so that
+// offsets near 2^64 from a corrupt file can't wrap around and pass.
+bool isInFile(uint64_t offset, uint64_t length, size_t size) {
+    return offset <= size && length <= size - offset;
+}
+
+const char* validateObjects(const unsigned char* data, size_t size, uint64_t offset) {
+    if (offset % jmap::BLOCK_ALIGNMENT != 0 || !isInFile(offset, sizeof(jmap::ObjectBlock), size)) {
+        return "objects out of range";
+    }
+
+    const auto* block = reinterpret_cast<const jmap::ObjectBlock*>(data + offset);
+    uint64_t blockSize = sizeof(jmap::ObjectBlock) + uint64_t(block->objectCount) * sizeof(jmap::ObjectRecord) +
+                         uint64_t(block->propertyCount) * sizeof(jmap::PropertyRecord) + block->stringBytes;
+    if (!isInFile(offset, blockSize, size)) {
+        return "objects out of range";
+    }
+
+    const auto* objects = reinterpret_cast<const jmap::ObjectRecord*>(block + 1);
+    const auto* properties = reinterpret_cast<const jmap::PropertyRecord*>(objects + block->objectCount);
+    const auto* strings = reinterpret_cast<const char*>(properties + block->propertyCount);
+    if (block->stringBytes == 0 || strings[block->stringBytes - 1] != '\0') {
+        return "corrupt object strings";
+    }
+
+    for (uint32_t i = 0; i < block->objectCount; i++) {
+        const jmap::ObjectRecord& object = objects[i];
+        if (object.type >= block->stringBytes || object.name >= block->stringBytes ||
+            uint64_t(object.firstProperty) + object.propertyCount > block->propertyCount) {
+            return "corrupt object";
+        }
+    }
+    for (uint32_t i = 0; i < block->propertyCount; i++) {
+        if (properties[i].key >= block->stringBytes || properties[i].value >= block->stringBytes) {
+            return "corrupt object property";
+        }
+    }
+    return nullptr;
+}
+
+// Expects a block that passed validateObjects
+std::vector<MapObject> readObjects(const unsigned char* data) {
+    const auto* block = reinterpret_cast<const jmap::ObjectBlock*>(data);
+    const auto* objects = reinterpret_cast<const jmap::ObjectRecord*>(block + 1);
+    const auto* properties = reinterpret_cast<const jmap::PropertyRecord*>(objects + block->objectCount);
+    const auto* strings = reinterpret_cast<const char*>(properties + block->propertyCount);
+
+    std::vector<MapObject> result(block->objectCount);
+    for (uint32_t i = 0; i < block->objectCount; i++) {
+        const jmap::ObjectRecord& record = objects[i];
+        MapObject& object = result[i];
+        object.type = strings + record.type;
+        object.name = strings + record.name;
+        object.x = record.x;
+        object.y = record.y;
+        object.width = record.width;
+        object.height = record.height;
+        for (uint32_t p = 0; p < record.propertyCount; p++) {
+            const jmap::PropertyRecord& property = properties[record.firstProperty + p];
+            object.properties.emplace_back(strings + property.key, strings + property.value);
+        }
+    }
+    return result;
+}
+
+// Returns an error message if the mapped file is not a usable .jmap, nullptr otherwise
+// Chunk blocks are only checked when they will be used straight from the mapping;
+// touching every block header would page in the whole file.
+const char* validateMapFile(const unsigned char* data, size_t size, bool checkChunkBlocks) {
+    if (size < sizeof(jmap::Header)) {
+        return "file too small";
+    }
+
+    const auto* header = reinterpret_cast<const jmap::Header*>(data);
+    if (header->magic != jmap::MAGIC) {
+        return "not a jmap file";
+    }
+    if (header->version != jmap::VERSION) {
+        return "unsupported version";
+    }
+    if (header->headerSize != sizeof(jmap::Header) || header->fileSize != size) {
+        return "corrupt header";
+    }
+    if (header->chunkSize != TileChunk::SIZE) {
+        return "chunk size mismatch";
+    }
+    if (header->tileSize == 0 || header->tileSize > jmap::MAX_TILE_SIZE) {
+        return "invalid tile size";
+    }
+    // Bounded before any arithmetic on them, which would otherwise wrap near 2^32
+    if (header->width == 0 || header->height == 0 ||
+        header->width > jmap::MAX_MAP_SIZE || header->height > jmap::MAX_MAP_SIZE) {
+        return "invalid dimensions";
+    }
+    if (header->layerCount == 0 ||
+        header->chunksX != (header->width + TileChunk::SIZE - 1) / TileChunk::SIZE ||
+        header->chunksY != (header->height + TileChunk::SIZE - 1) / TileChunk::SIZE ||
+        header->collisionWordsPerRow != (header->width + 63) / 64) {
+        return "inconsistent dimensions";
+    }
+
+    uint64_t indexSize = uint64_t(header->layerCount) * header->chunksX * header->chunksY * sizeof(jmap::ChunkIndexEntry);
+    uint64_t collisionSize = uint64_t(header->height) * header->collisionWordsPerRow * sizeof(uint64_t);
+    if (header->chunkIndexOffset % jmap::BLOCK_ALIGNMENT != 0 || !isInFile(header->chunkIndexOffset, indexSize, size) ||
+        header->collisionOffset % jmap::BLOCK_ALIGNMENT != 0 || !isInFile(header->collisionOffset, collisionSize, size)) {
+        return "block out of range";
+    }
+
+    const auto* index = reinterpret_cast<const jmap::ChunkIndexEntry*>(data + header->chunkIndexOffset);
+    uint64_t entryCount = indexSize / sizeof(jmap::ChunkIndexEntry);
+    for (uint64_t i = 0; i < entryCount && checkChunkBlocks; i++) {
+        uint64_t offset = index[i].offset;
+        if (offset == 0) {
+            continue;
+        }
+        if (offset % jmap::BLOCK_ALIGNMENT != 0 || !isInFile(offset, sizeof(jmap::ChunkBlock), size)) {
+            return "chunk block out of range";
+        }
+        uint64_t blockSize = jmap::getChunkBlockSize(*reinterpret_cast<const jmap::ChunkBlock*>(data + offset));
+        if (blockSize == 0) {
+            return "invalid chunk encoding";
+        }
+        if (!isInFile(offset, blockSize, size)) {
+            return "chunk block out of range";
+        }
+    }
+
+    if (header->tileFlagsOffset != 0 &&
+        (header->tileFlagsOffset % jmap::BLOCK_ALIGNMENT != 0 || !isInFile(header->tileFlagsOffset, header->tileFlagCount, size))) {
+        return "tile flags out of range";
+    }
+
+    if (header->objectsOffset != 0) {
+        return validateObjects(data, size, header->objectsOffset);
+    }
+
+    return nullptr;
+}
+
+void writePadding(std::ofstream& out, uint64_t& position, uint64_t target) {
+    static const char zeros[jmap::BLOCK_ALIGNMENT] = {};
+    while (position < target) {
+        uint64_t count = std::min<uint64_t>(target - position, sizeof(zeros));
+        out.write(zeros, static_cast<std::streamsize>(count));
+        position += count;
+    }
+}
+
+} // namespace
+
+std::unique_ptr<Tilemap> Tilemap::loadFromFile(const std::string& path, MapLoadMode mode) {
+    auto file = std::make_unique<MappedFile>(path);
+    if (!file->isOpen()) {
+        std::cerr << "Failed to open map: " << path << std::endl;
+        return nullptr;
+    }
+
+    unsigned char* data = file->getData();
+    if (const char* error = validateMapFile(data, file->getSize(), mode == MapLoadMode::MAPPED)) {
+        std::cerr << "Failed to load map " << path << ": " << error << std::endl;
+        return nullptr;
+    }
+
+    const auto* header = reinterpret_cast<const jmap::Header*>(data);
+    auto map = std::make_unique<Tilemap>(header->width, header->height, header->tileSize);
+
+    // Point chunk storage and the collision bitmap straight into the mapping.
+    // Layers beyond the ones this build knows about are ignored.
+    const auto* index = reinterpret_cast<const jmap::ChunkIndexEntry*>(data + header->chunkIndexOffset);
+    int chunkCount = map->m_chunksX * map->m_chunksY;
+    int layerCount = mode == MapLoadMode::MAPPED ? std::min<int>(header->layerCount, LAYER_COUNT) : 0;
+    for (int layer = 0; layer < layerCount; layer++) {
+        for (int i = 0; i < chunkCount; i++) {
+            uint64_t offset = index[layer * chunkCount + i].offset;
+            if (offset == 0) {
+                continue;
+            }
+
+            const auto* block = reinterpret_cast<const jmap::ChunkBlock*>(data + offset);
+            unsigned char* payload = data + offset + sizeof(jmap::ChunkBlock);
+            switch (static_cast<ChunkEncoding>(block->encoding)) {
+                case ChunkEncoding::UNIFORM:
+                    map->m_layers[layer].attachUniformChunk(i, block->uniformTile);
+                    break;
+                case ChunkEncoding::PALETTE:
+                    map->m_layers[layer].attachPaletteChunk(i, reinterpret_cast<uint64_t*>(payload),
+                                                            block->paletteSize, block->indexBits);
+                    break;
+                case ChunkEncoding::DENSE:
+                    map->m_layers[layer].attachDenseChunk(i, reinterpret_cast<TileId*>(payload));
+                    break;
+            }
+        }
+    }
+
+    map->m_collision.attach(reinterpret_cast<uint64_t*>(data + header->collisionOffset));
+
+    // The collision bitmap was baked with these flags, so no rebuild is needed
+    map->m_tileProperties.clear();
+    if (header->tileFlagsOffset != 0) {
+        for (uint32_t tile = 0; tile < header->tileFlagCount; tile++) {
+            map->m_tileProperties.setFlags(static_cast<TileId>(tile), data[header->tileFlagsOffset + tile]);
+        }
+    }
+    if (header->objectsOffset != 0) {
+        map->m_objects = readObjects(data + header->objectsOffset);
+    }
+
+    if (mode == MapLoadMode::STREAMED) {
+        map->m_chunkStreamed.assign(chunkCount, 0);
+        map->m_streamEdits.resize(chunkCount);
+    }
+
+    map->m_mapping = std::move(file);
+
+    return map;
+}
 
-            if (m_hasTileset) {
-                // Render from tileset
-                int tileCol = tileId % m_tilesPerRow;
-                int tileRow = tileId / m_tilesPerRow;
+bool Tilemap::saveToFile(const std::string& path) const {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        std::cerr << "Failed to write map: " << path << std::endl;
+        return false;
+    }
 
-                Rectangle sourceRect = {
-                    static_cast<float>(tileCol * m_tileSize),
-                    static_cast<float>(tileRow * m_tileSize),
-                    static_cast<float>(m_tileSize),
-                    static_cast<float>(m_tileSize)
-                };
+    size_t chunkCount = static_cast<size_t>(m_chunksX) * m_chunksY;
+    size_t entryCount = chunkCount * LAYER_COUNT;
 
-                DrawTexturePro(m_tileset, sourceRect, destRect, {0, 0}, 0.0f, WHITE);
+    // Chunks are written in their in-memory encoding; call compact() first for the smallest file.
+    // Chunks that only contain their layer's default tile get no block.
+    std::vector<jmap::ChunkIndexEntry> index(entryCount);
+    std::vector<ChunkData> blocks;
+    blocks.reserve(entryCount);
+    uint64_t indexOffset = jmap::alignBlock(sizeof(jmap::Header));
+    uint64_t position = jmap::alignBlock(indexOffset + entryCount * sizeof(jmap::ChunkIndexEntry));
+    for (int layer = 0; layer < LAYER_COUNT; layer++) {
+        for (size_t i = 0; i < chunkCount; i++) {
+            size_t entry = layer * chunkCount + i;
+            blocks.push_back(m_layers[layer].getChunkData(static_cast<int>(i)));
+            if (m_layers[layer].isChunkUniform(static_cast<int>(i), m_layers[layer].getDefaultTile())) {
+                index[entry].offset = 0;
             } else {
-                // Fallback: render as colored rectangles
-                Color color = getTileColor(tileId);
-                DrawRectangleRec(destRect, color);
-                DrawRectangleLinesEx(destRect, 1, ColorAlpha(DARKGRAY, 0.3f));
+                index[entry].offset = position;
+                position = jmap::alignBlock(position + getChunkBlockSize(blocks.back()));
+            }
+        }
+    }
+
+    uint64_t collisionOffset = position;
+    uint64_t collisionBytes = m_collision.getWordCount() * sizeof(uint64_t);
+    position = collisionOffset + collisionBytes;
+
+    uint64_t tileFlagsOffset = 0;
+    uint64_t tileFlagCount = m_tileProperties.getTileCount();
+    if (tileFlagCount > 0) {
+        tileFlagsOffset = jmap::alignBlock(position);
+        position = tileFlagsOffset + tileFlagCount;
+    }
+
+    // Flatten objects into records plus a string pool
+    std::vector<jmap::ObjectRecord> objectRecords;
+    std::vector<jmap::PropertyRecord> propertyRecords;
+    std::string strings;
+    auto addString = [&strings](const std::string& value) {
+        uint32_t offset = static_cast<uint32_t>(strings.size());
+        strings.append(value.c_str(), value.size() + 1);
+        return offset;
+    };
+    for (const MapObject& object : m_objects) {
+        jmap::ObjectRecord record = {object.x, object.y, object.width, object.height,
+                                     addString(object.type), addString(object.name),
+                                     static_cast<uint32_t>(propertyRecords.size()),
+                                     static_cast<uint32_t>(object.properties.size())};
+        objectRecords.push_back(record);
+        for (const auto& property : object.properties) {
+            propertyRecords.push_back({addString(property.first), addString(property.second)});
+        }
+    }
+
+    uint64_t objectsOffset = 0;
+    jmap::ObjectBlock objectBlock = {static_cast<uint32_t>(objectRecords.size()),
+                                     static_cast<uint32_t>(propertyRecords.size()),
+                                     static_cast<uint32_t>(strings.size()), 0};
+    if (!m_objects.empty()) {
+        objectsOffset = jmap::alignBlock(position);
+        position = objectsOffset + sizeof(objectBlock) + objectRecords.size() * sizeof(jmap::ObjectRecord) +
+                   propertyRecords.size() * sizeof(jmap::PropertyRecord) + strings.size();
+    }
+
+    jmap::Header header;
+    std::memset(&header, 0, sizeof(header));
+    header.magic = jmap::MAGIC;
+    header.version = jmap::VERSION;
+    header.headerSize = sizeof(jmap::Header);
+    header.width = m_width;
+    header.height = m_height;
+    header.tileSize = m_tileSize;
+    header.chunkSize = TileChunk::SIZE;
+    header.layerCount = LAYER_COUNT;
+    header.chunksX = m_chunksX;
+    header.chunksY = m_chunksY;
+    header.chunkIndexOffset = indexOffset;
+    header.collisionOffset = collisionOffset;
+    header.collisionWordsPerRow = m_collision.getWordsPerRow();
+    header.fileSize = position;
+    header.tileFlagsOffset = tileFlagsOffset;
+    header.tileFlagCount = static_cast<uint32_t>(tileFlagCount);
+    header.objectsOffset = objectsOffset;
+
+    uint64_t written = 0;
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    written += sizeof(header);
+
+    writePadding(out, written, indexOffset);
+    out.write(reinterpret_cast<const char*>(index.data()), entryCount * sizeof(jmap::ChunkIndexEntry));
+    written += entryCount * sizeof(jmap::ChunkIndexEntry);
+
+    for (size_t i = 0; i < entryCount; i++) {
+        if (index[i].offset == 0) {
+            continue;
+        }
+
+        const ChunkData& chunk = blocks[i];
+        writePadding(out, written, index[i].offset);
+        jmap::ChunkBlock block = {static_cast<uint16_t>(chunk.encoding), chunk.uniformTile,
+                                  static_cast<uint16_t>(chunk.paletteSize), static_cast<uint16_t>(chunk.indexBits)};
+        out.write(reinterpret_cast<const char*>(&block), sizeof(block));
+        written += sizeof(block);
+
+        if (chunk.encoding == ChunkEncoding::PALETTE) {
+            uint64_t paletteBytes = chunk.paletteSize * sizeof(TileId);
+            uint64_t indexBytes = TileLayer::indexWordCount(chunk.indexBits) * sizeof(uint64_t);
+            out.write(reinterpret_cast<const char*>(chunk.palette), paletteBytes);
+            written += paletteBytes;
+            // Unused palette slots are zero
+            writePadding(out, written, index[i].offset + getChunkBlockSize(chunk) - indexBytes);
+            out.write(reinterpret_cast<const char*>(chunk.indices), indexBytes);
+            written += indexBytes;
+        } else if (chunk.encoding == ChunkEncoding::DENSE) {
+            out.write(reinterpret_cast<const char*>(chunk.tiles), TileChunk::AREA * sizeof(TileId));
+            written += TileChunk::AREA * sizeof(TileId);
+        }
+    }
+
+    writePadding(out, written, collisionOffset);
+    out.write(reinterpret_cast<const char*>(m_collision.getWords()), collisionBytes);
+    written += collisionBytes;
+
+    if (tileFlagsOffset != 0) {
+        writePadding(out, written, tileFlagsOffset);
+        out.write(reinterpret_cast<const char*>(m_tileProperties.getFlagData()), tileFlagCount);
+        written += tileFlagCount;
+    }
+
+    if (objectsOffset != 0) {
+        writePadding(out, written, objectsOffset);
+        out.write(reinterpret_cast<const char*>(&objectBlock), sizeof(objectBlock));
+        out.write(reinterpret_cast<const char*>(objectRecords.data()), objectRecords.size() * sizeof(jmap::ObjectRecord));
+        out.write(reinterpret_cast<const char*>(propertyRecords.data()), propertyRecords.size() * sizeof(jmap::PropertyRecord));
+        out.write(strings.data(), static_cast<std::streamsize>(strings.size()));
+    }
+
+    if (!out) {
+        std::cerr << "Failed to write map: " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+namespace {
+// Integer division rounding towards negative infinity (camera offsets can be negative
+// when a small map is centered on screen)
+int floorDiv(int value, int divisor) {
+    int q = value / divisor;
+    return (value % divisor != 0 && value < 0) ? q - 1 : q;
+}
+}
+
+void Tilemap::render(int cameraOffsetX, int cameraOffsetY, int viewWidth, int viewHeight) {
+    m_lastDrawCalls = 0;
+    m_lastBakes = 0;
+
+    renderLayers(static_cast<int>(MapLayer::GROUND), static_cast<int>(MapLayer::DECORATION),
+                 cameraOffsetX, cameraOffsetY, viewWidth, viewHeight);
+}
+
+void Tilemap::renderOverlay(int cameraOffsetX, int cameraOffsetY, int viewWidth, int viewHeight) {
+    renderLayers(static_cast<int>(MapLayer::OVERLAY), static_cast<int>(MapLayer::OVERLAY),
+                 cameraOffsetX, cameraOffsetY, viewWidth, viewHeight);
+}
+
+void Tilemap::renderLayers(int firstLayer, int lastLayer, int cameraOffsetX, int cameraOffsetY, int viewWidth, int viewHeight) {
+    // Visible tile range with a one tile margin on every side
+    int startX = std::max(0, floorDiv(cameraOffsetX, m_tileSize) - 1);
+    int startY = std::max(0, floorDiv(cameraOffsetY, m_tileSize) - 1);
+    int endX = std::min(m_width - 1, floorDiv(cameraOffsetX + viewWidth, m_tileSize) + 1);
+    int endY = std::min(m_height - 1, floorDiv(cameraOffsetY + viewHeight, m_tileSize) + 1);
+
+    if (startX > endX || startY > endY) {
+        return;
+    }
+
+    for (int layer = firstLayer; layer <= lastLayer; layer++) {
+        switch (m_renderMode) {
+            case TileRenderMode::IMMEDIATE:
+                renderImmediate(layer, startX, startY, endX, endY, cameraOffsetX, cameraOffsetY);
+                break;
+            case TileRenderMode::BAKED_CHUNKS:
+                renderBakedChunks(layer, startX, startY, endX, endY, cameraOffsetX, cameraOffsetY);
+                break;
+            case TileRenderMode::BATCHED_MESH:
+                renderMeshChunks(layer, startX, startY, endX, endY, cameraOffsetX, cameraOffsetY);
+                break;
+        }
+    }
+}
+
+bool Tilemap::isChunkEmpty(int layerIndex, int chunkIndex) const {
+    return m_layers[layerIndex].isChunkUniform(chunkIndex, EMPTY_TILE);
+}
+
+void Tilemap::renderImmediate(int layerIndex, int startX, int startY, int endX, int endY, int cameraOffsetX, int cameraOffsetY) {
+    const TileLayer& layer = m_layers[layerIndex];
+    for (int y = startY; y <= endY; y++) {
+        for (int x = startX; x <= endX; x++) {
+            TileId tileId = layer.getTile(x, y);
+            if (tileId != EMPTY_TILE) {
+                drawTile(x, y, m_tileAnimations.getFrameTile(tileId, m_animationTime), cameraOffsetX, cameraOffsetY);
             }
         }
     }
 }
 
+void Tilemap::renderBakedChunks(int layerIndex, int startX, int startY, int endX, int endY, int cameraOffsetX, int cameraOffsetY) {
+    const TileLayer& layer = m_layers[layerIndex];
+    int chunkPixelSize = TileChunk::SIZE * m_tileSize;
+
+    for (int cy = startY / TileChunk::SIZE; cy <= endY / TileChunk::SIZE; cy++) {
+        for (int cx = startX / TileChunk::SIZE; cx <= endX / TileChunk::SIZE; cx++) {
+            int chunkIndex = cy * m_chunksX + cx;
+            if (isChunkEmpty(layerIndex, chunkIndex)) {
+                continue;
+            }
+
+            int key = cacheKey(layerIndex, chunkIndex);
+            uint32_t revision = layer.getChunkRevision(chunkIndex);
+
+            const RenderTexture2D* baked = m_chunkCache.find(key, revision);
+            if (!baked) {
+                baked = &m_chunkCache.acquire(key, revision);
+                bakeChunk(layerIndex, cx, cy, *baked);
+                m_lastBakes++;
+            }
+
+            // Render textures are stored upside down, so flip the source rectangle
+            Rectangle sourceRect = {
+                0.0f, 0.0f,
+                static_cast<float>(chunkPixelSize),
+                -static_cast<float>(chunkPixelSize)
+            };
+            Vector2 position = {
+                static_cast<float>(cx * chunkPixelSize - cameraOffsetX),
+                static_cast<float>(cy * chunkPixelSize - cameraOffsetY)
+            };
+
+            DrawStats::useTexture(baked->texture.id);
+            DrawTextureRec(baked->texture, sourceRect, position, WHITE);
+            m_lastDrawCalls++;
+        }
+    }
+
+    if (!m_tileAnimations.empty()) {
+        renderAnimatedChunks(layerIndex, startX, startY, endX, endY, cameraOffsetX, cameraOffsetY);
+    }
+}
+
+void Tilemap::renderAnimatedChunks(int layerIndex, int startX, int startY, int endX, int endY, int cameraOffsetX, int cameraOffsetY) {
+    const TileLayer& layer = m_layers[layerIndex];
+    const Texture2D& tileset = m_hasTileset ? m_tileset : getFallbackTileset();
+    int tilesPerRow = m_hasTileset ? m_tilesPerRow : FALLBACK_TILE_COUNT;
+
+    int startChunkX = startX / TileChunk::SIZE;
+    int startChunkY = startY / TileChunk::SIZE;
+    int endChunkX = endX / TileChunk::SIZE;
+    int endChunkY = endY / TileChunk::SIZE;
+
+    // Chunks without animated tiles keep an empty mesh, so this scan only happens per revision
+    for (int cy = startChunkY; cy <= endChunkY; cy++) {
+        for (int cx = startChunkX; cx <= endChunkX; cx++) {
+            int chunkIndex = cy * m_chunksX + cx;
+            if (isChunkEmpty(layerIndex, chunkIndex)) {
+                continue;
+            }
+
+            int key = animatedCacheKey(layerIndex, chunkIndex);
+            uint32_t revision = layer.getChunkRevision(chunkIndex);
+            if (!m_meshRenderer.hasMesh(key, revision)) {
+                buildChunkMesh(layerIndex, cx, cy, tileset, tilesPerRow, true);
+                m_meshRenderer.upload(key, revision, m_meshVertices);
+            }
+        }
+    }
+
+    bool begun = false;
+    for (int cy = startChunkY; cy <= endChunkY; cy++) {
+        for (int cx = startChunkX; cx <= endChunkX; cx++) {
+            int chunkIndex = cy * m_chunksX + cx;
+            int key = animatedCacheKey(layerIndex, chunkIndex);
+            if (isChunkEmpty(layerIndex, chunkIndex) || m_meshRenderer.isEmpty(key)) {
+                continue;
+            }
+            // Only switch to the mesh shader if something on screen is animated
+            if (!begun) {
+                m_meshRenderer.begin(tileset, cameraOffsetX, cameraOffsetY);
+                updateAnimationOffsets(tileset, tilesPerRow);
+                m_meshRenderer.setAnimationOffsets(m_animationOffsets);
+                begun = true;
+            }
+            m_meshRenderer.draw(key);
+            DrawStats::directDraw();
+            m_lastDrawCalls++;
+        }
+    }
+    if (begun) {
+        m_meshRenderer.end();
+    }
+}
+
+void Tilemap::bakeChunk(int layerIndex, int chunkX, int chunkY, const RenderTexture2D& target) {
+    const TileLayer& layer = m_layers[layerIndex];
+    int originX = chunkX * TileChunk::SIZE;
+    int originY = chunkY * TileChunk::SIZE;
+    int endX = std::min(m_width, originX + TileChunk::SIZE);
+    int endY = std::min(m_height, originY + TileChunk::SIZE);
+
+    // drawTile counts draw calls, but baking is not part of the per-frame cost.
+    // DrawStats does count them: they are real draw calls in the frame that bakes.
+    int drawCalls = m_lastDrawCalls;
+
+    // Animated tiles are drawn every frame on top of the baked texture (renderAnimatedChunks)
+    DrawStats::breakBatch();
+    BeginTextureMode(target);
+    ClearBackground(BLANK);
+    for (int y = originY; y < endY; y++) {
+        for (int x = originX; x < endX; x++) {
+            TileId tileId = layer.getTile(x, y);
+            if (tileId != EMPTY_TILE && !m_tileAnimations.isAnimated(tileId)) {
+                drawTile(x, y, tileId, originX * m_tileSize, originY * m_tileSize);
+            }
+        }
+    }
+    EndTextureMode();
+    DrawStats::breakBatch();
+
+    m_lastDrawCalls = drawCalls;
+}
+
+void Tilemap::drawTile(int x, int y, TileId tileId, int cameraOffsetX, int cameraOffsetY) {
+    Rectangle destRect = {
+        static_cast<float>(x * m_tileSize - cameraOffsetX),
+        static_cast<float>(y * m_tileSize - cameraOffsetY),
+        static_cast<float>(m_tileSize),
+        static_cast<float>(m_tileSize)
+    };
+
+    if (m_hasTileset) {
+        // Render from tileset
+        Rectangle sourceRect = getTileSourceRect(tileId, m_tilesPerRow);
+        DrawStats::useTexture(m_tileset.id);
+        DrawTexturePro(m_tileset, sourceRect, destRect, {0, 0}, 0.0f, WHITE);
+        m_lastDrawCalls++;
+    } else {
+        // Fallback: render as colored rectangles
+        Color color = getTileColor(tileId);
+        DrawStats::useShapes();
+        DrawRectangleRec(destRect, color);
+        DrawRectangleLinesEx(destRect, 1, ColorAlpha(DARKGRAY, 0.3f));
+        m_lastDrawCalls += 2;
+    }
+}
+
+void Tilemap::renderMeshChunks(int layerIndex, int startX, int startY, int endX, int endY, int cameraOffsetX, int cameraOffsetY) {
+    const TileLayer& layer = m_layers[layerIndex];
+    const Texture2D& tileset = m_hasTileset ? m_tileset : getFallbackTileset();
+    int tilesPerRow = m_hasTileset ? m_tilesPerRow : FALLBACK_TILE_COUNT;
+
+    int startChunkX = startX / TileChunk::SIZE;
+    int startChunkY = startY / TileChunk::SIZE;
+    int endChunkX = endX / TileChunk::SIZE;
+    int endChunkY = endY / TileChunk::SIZE;
+
+    // Rebuild stale meshes first so uploads don't interleave with drawing
+    for (int cy = startChunkY; cy <= endChunkY; cy++) {
+        for (int cx = startChunkX; cx <= endChunkX; cx++) {
+            int chunkIndex = cy * m_chunksX + cx;
+            if (isChunkEmpty(layerIndex, chunkIndex)) {
+                continue;
+            }
+
+            int key = cacheKey(layerIndex, chunkIndex);
+            uint32_t revision = layer.getChunkRevision(chunkIndex);
+            if (!m_meshRenderer.hasMesh(key, revision)) {
+                buildChunkMesh(layerIndex, cx, cy, tileset, tilesPerRow, false);
+                m_meshRenderer.upload(key, revision, m_meshVertices);
+                m_lastBakes++;
+            }
+        }
+    }
+
+    m_meshRenderer.begin(tileset, cameraOffsetX, cameraOffsetY);
+    if (!m_tileAnimations.empty()) {
+        updateAnimationOffsets(tileset, tilesPerRow);
+        m_meshRenderer.setAnimationOffsets(m_animationOffsets);
+    }
+    for (int cy = startChunkY; cy <= endChunkY; cy++) {
+        for (int cx = startChunkX; cx <= endChunkX; cx++) {
+            int chunkIndex = cy * m_chunksX + cx;
+            if (!isChunkEmpty(layerIndex, chunkIndex) && m_meshRenderer.draw(cacheKey(layerIndex, chunkIndex))) {
+                DrawStats::directDraw();
+                m_lastDrawCalls++;
+            }
+        }
+    }
+    m_meshRenderer.end();
+}
+
+void Tilemap::buildChunkMesh(int layerIndex, int chunkX, int chunkY, const Texture2D& tileset, int tilesPerRow,
+                             bool animatedOnly) {
+    const TileLayer& layer = m_layers[layerIndex];
+    int originX = chunkX * TileChunk::SIZE;
+    int originY = chunkY * TileChunk::SIZE;
+    int endX = std::min(m_width, originX + TileChunk::SIZE);
+    int endY = std::min(m_height, originY + TileChunk::SIZE);
+
+    float texWidth = static_cast<float>(tileset.width);
+    float texHeight = static_cast<float>(tileset.height);
+    float size = static_cast<float>(m_tileSize);
+
+    m_meshVertices.clear();
+    m_meshVertices.reserve(TileChunk::AREA * ChunkMeshRenderer::VERTICES_PER_TILE * ChunkMeshRenderer::FLOATS_PER_VERTEX);
+
+    for (int y = originY; y < endY; y++) {
+        for (int x = originX; x < endX; x++) {
+            TileId tileId = layer.getTile(x, y);
+            int animation = tileId == EMPTY_TILE ? -1 : m_tileAnimations.getAnimationIndex(tileId);
+            if (tileId == EMPTY_TILE || (animatedOnly && animation < 0)) {
+                continue;
+            }
+
+            // Animated tiles point at their base tile; the shader adds the current frame's offset
+            float a = static_cast<float>(animation);
+            Rectangle source = getTileSourceRect(tileId, tilesPerRow);
+
+            float x0 = static_cast<float>(x * m_tileSize);
+            float y0 = static_cast<float>(y * m_tileSize);
+            float x1 = x0 + size;
+            float y1 = y0 + size;
+            float u0 = source.x / texWidth;
+            float v0 = source.y / texHeight;
+            float u1 = (source.x + source.width) / texWidth;
+            float v1 = (source.y + source.height) / texHeight;
+
+            // Two triangles: top-left, bottom-left, bottom-right / top-left, bottom-right, top-right
+            const float quad[] = {
+                x0, y0, u0, v0, a,
+                x0, y1, u0, v1, a,
+                x1, y1, u1, v1, a,
+                x0, y0, u0, v0, a,
+                x1, y1, u1, v1, a,
+                x1, y0, u1, v0, a
+            };
+            m_meshVertices.insert(m_meshVertices.end(), std::begin(quad), std::end(quad));
+        }
+    }
+}
+
+void Tilemap::updateAnimationOffsets(const Texture2D& tileset, int tilesPerRow) {
+    static_assert(TileAnimations::MAX_ANIMATIONS <= ChunkMeshRenderer::MAX_ANIMATIONS,
+                  "tile shader can't hold every animation");
+
+    // One offset per animation, however many tiles use it
+    const auto& animations = m_tileAnimations.getAnimations();
+    m_animationOffsets.resize(animations.size());
+    for (size_t i = 0; i < animations.size(); i++) {
+        Rectangle base = getTileSourceRect(animations[i].tile, tilesPerRow);
+        Rectangle frame = getTileSourceRect(animations[i].getFrame(m_animationTime), tilesPerRow);
+        m_animationOffsets[i] = {
+            (frame.x - base.x) / static_cast<float>(tileset.width),
+            (frame.y - base.y) / static_cast<float>(tileset.height)
+        };
+    }
+}
+
+const Texture2D& Tilemap::getFallbackTileset() {
+    if (m_fallbackTileset.id == 0) {
+        // One cell per getTileColor entry, last cell doubles as the "unknown tile" color
+        Image image = GenImageColor(FALLBACK_TILE_COUNT * m_tileSize, m_tileSize, BLANK);
+        for (int i = 0; i < FALLBACK_TILE_COUNT; i++) {
+            Rectangle cell = {
+                static_cast<float>(i * m_tileSize), 0.0f,
+                static_cast<float>(m_tileSize), static_cast<float>(m_tileSize)
+            };
+            ImageDrawRectangleRec(&image, cell, getTileColor(i));
+            ImageDrawRectangleLines(&image, cell, 1, ColorAlpha(DARKGRAY, 0.3f));
+        }
+        m_fallbackTileset = LoadTextureFromImage(image);
+        UnloadImage(image);
+    }
+    return m_fallbackTileset;
+}
+
+Rectangle Tilemap::getTileSourceRect(TileId tileId, int tilesPerRow) const {
+    if (!m_hasTileset) {
+        tileId = std::min<TileId>(tileId, FALLBACK_TILE_COUNT - 1);
+    }
+
+    int tileCol = tileId % tilesPerRow;
+    int tileRow = tileId / tilesPerRow;
+
+    // The fallback tileset is a texture of its own, the real one may sit in an atlas page
+    Vector2 origin = m_hasTileset ? m_tilesetOrigin : Vector2{0.0f, 0.0f};
+    return {
+        origin.x + static_cast<float>(tileCol * m_tileSize),
+        origin.y + static_cast<float>(tileRow * m_tileSize),
+        static_cast<float>(m_tileSize),
+        static_cast<float>(m_tileSize)
+    };
+}
+
 Color Tilemap::getTileColor(int tileId) const {
     switch (tileId) {
         case 0: return GREEN;        // Grass
         case 1: return DARKGRAY;     // Wall
         case 2: return BLUE;         // Water
         case 3: return BROWN;        // Dirt/Path
+        case 4: return SKYBLUE;      // Water, second animation frame
         default: return MAGENTA;     // Unknown tile
     }
 }
@@ -1,37 +1,249 @@
 #pragma once
 
+#include "tile_layer.h"
+#include "tile_properties.h"
+#include "tile_animations.h"
+#include "collision_bitmap.h"
+#include "map_object.h"
+#include "chunk_render_cache.h"
+#include "chunk_mesh_renderer.h"
+#include "texture_atlas.h"
 #include <raylib.h>
+#include <cstdint>
+#include <memory>
 #include <vector>
 #include <string>
 
+class MappedFile;
+
+// Draw order: GROUND and DECORATION are drawn below entities, OVERLAY above them
+enum class MapLayer {
+    GROUND = 0,     // Terrain, every cell has a tile
+    DECORATION,     // Sparse props on top of the terrain (fences, rocks, flowers)
+    OVERLAY         // Sparse tiles drawn over the player and NPCs (roofs, tree tops)
+};
+
+// How Tilemap::render submits tiles
+enum class TileRenderMode {
+    IMMEDIATE,      // One draw call per visible tile
+    BAKED_CHUNKS,   // One quad per visible chunk, drawn from a cached render texture
+    BATCHED_MESH    // One rlgl vertex buffer draw per visible chunk
+};
+
+// How Tilemap::loadFromFile gets at the chunk tiles
+enum class MapLoadMode {
+    MAPPED,     // Chunks point straight into the mapped file
+    STREAMED    // Chunks start out as the default tile and are loaded by a ChunkStreamer
+};
+
 class Tilemap {
 public:
+    static constexpr int LAYER_COUNT = 3;
+
+    // Stored in DECORATION/OVERLAY cells that have no tile
+    static constexpr TileId EMPTY_TILE = 0xFFFF;
+
     Tilemap(int width, int height, int tileSize);
     ~Tilemap();
 
-    void setTile(int x, int y, int tileId);
-    int getTile(int x, int y) const;
-    bool isWalkable(int x, int y) const;
+    // Map a .jmap file and use it directly as tile storage (nullptr on failure).
+    // The collision bitmap, tile flags and objects always come from the mapping.
+    static std::unique_ptr<Tilemap> loadFromFile(const std::string& path, MapLoadMode mode = MapLoadMode::MAPPED);
+    bool saveToFile(const std::string& path) const;
+
+    // Negative tile IDs clear the cell; IDs from EMPTY_TILE up don't fit a cell and are
+    // ignored. getTile returns -1 outside the map and for empty cells.
+    void setTile(int x, int y, int tileId, MapLayer layer = MapLayer::GROUND);
+    int getTile(int x, int y, MapLayer layer = MapLayer::GROUND) const;
+
+    // Collision queries read the packed collision bitmap; anything outside the map blocks
+    bool isWalkable(int x, int y) const { return inBounds(x, y) && !m_collision.test(x, y); }
+    bool isRowSpanWalkable(int y, int x0, int x1) const;
+    bool isAreaWalkable(int x, int y, int w, int h) const;
+    const CollisionBitmap& getCollision() const { return m_collision; }
+
+    // Per chunk (row-major), incremented whenever a tile inside the chunk becomes walkable
+    // or blocked; pathfinding caches compare against it
+    const std::vector<uint32_t>& getCollisionRevisions() const { return m_collisionRevisions; }
+
+    // Combined TileFlag bits of the GROUND and DECORATION tiles (0 outside the map)
+    uint8_t getTileFlags(int x, int y) const;
+
+    // Replaces the tileset's property table and rebuilds the collision bitmap
+    void setTileProperties(const TileProperties& properties);
+    const TileProperties& getTileProperties() const { return m_tileProperties; }
+
+    // Animated tiles (water, lava, torches). Frames are picked at draw time, so animating
+    // never edits the map, bumps chunk revisions or re-bakes chunks.
+    void setTileAnimations(const TileAnimations& animations);
+    const TileAnimations& getTileAnimations() const { return m_tileAnimations; }
+    void updateAnimations(float deltaTime) { m_animationTime += deltaTime; }
+
+    // Object layers (NPC spawns, triggers), saved with the map
+    const std::vector<MapObject>& getObjects() const { return m_objects; }
+    void addObject(const MapObject& object) { m_objects.push_back(object); }
 
     // Load tileset texture
     void loadTileset(const std::string& tilesetPath, int tilesPerRow);
+    // Use a packed atlas image as the tileset (the atlas must outlive the map).
+    // Returns false if the atlas has no image with that name.
+    bool setTileset(const TextureAtlas& atlas, const std::string& name, int tilesPerRow);
+
+    // Draws the layers below entities (GROUND, DECORATION), only for tiles intersecting
+    // the view rectangle plus a one tile margin
+    void render(int cameraOffsetX, int cameraOffsetY, int viewWidth, int viewHeight);
 
-    void render(int cameraOffsetX, int cameraOffsetY);
+    // Draws the OVERLAY layer; call after entities
+    void renderOverlay(int cameraOffsetX, int cameraOffsetY, int viewWidth, int viewHeight);
+
+    void setRenderMode(TileRenderMode mode) { m_renderMode = mode; }
+    TileRenderMode getRenderMode() const { return m_renderMode; }
+
+    // Upper bound on baked chunk textures kept resident (BAKED_CHUNKS mode)
+    void setMaxBakedChunks(int maxBakedChunks) { m_chunkCache.setMaxBakedChunks(maxBakedChunks); }
 
     int getWidth() const { return m_width; }
     int getHeight() const { return m_height; }
     int getTileSize() const { return m_tileSize; }
 
+    // Flat color per tile, used for the fallback tileset and the map overview
+    Color getTileColor(int tileId) const;
+
+    // Chunk layout info
+    int getChunksX() const { return m_chunksX; }
+    int getChunksY() const { return m_chunksY; }
+    int getResidentChunkCount() const;
+
+    // Re-encodes edited chunks with the smallest storage (uniform, palette or dense)
+    void compact();
+
+    // Tile storage across all layers, including chunks mapped from a .jmap file
+    size_t getTileMemoryUsage() const;
+    float getBytesPerTile() const;
+
+    // Incremented whenever a tile inside the chunk changes; render caches compare against it.
+    // Layers are tracked separately, so editing one never invalidates the others.
+    uint32_t getChunkRevision(int chunkX, int chunkY, MapLayer layer = MapLayer::GROUND) const {
+        return getLayer(layer).getChunkRevision(chunkY * m_chunksX + chunkX);
+    }
+
+    // True (and the tile) if every cell of the chunk holds the same tile
+    bool getChunkUniformTile(int chunkX, int chunkY, MapLayer layer, TileId& tile) const {
+        ChunkData data = getLayer(layer).getChunkData(chunkY * m_chunksX + chunkX);
+        tile = data.uniformTile;
+        return data.encoding == ChunkEncoding::UNIFORM;
+    }
+
+    // Incremented whenever any chunk revision changes, so caches over the whole map can
+    // skip scanning every chunk on frames without edits
+    uint32_t getRevision() const { return m_revision; }
+
+    // Streaming hooks (see ChunkStreamer). Both bump the chunk revision.
+    void installChunk(int chunkX, int chunkY, MapLayer layer, LoadedChunk&& loaded) {
+        getLayer(layer).installChunk(chunkY * m_chunksX + chunkX, std::move(loaded));
+        m_revision++;
+    }
+    void evictChunk(int chunkX, int chunkY, MapLayer layer);
+    // False while a STREAMED map's chunk is still to be streamed in (or was evicted), when
+    // it holds only the default tile and any edits
+    bool isChunkLoaded(int chunkX, int chunkY) const {
+        return m_chunkStreamed.empty() || m_chunkStreamed[chunkY * m_chunksX + chunkX] != 0;
+    }
+    // Call once every streamed layer of the chunk is installed. Tiles set while it wasn't
+    // loaded are applied again on top of the file's, so edits win tile by tile.
+    void finishChunkStream(int chunkX, int chunkY);
+    size_t getChunkMemoryUsage(int chunkX, int chunkY, MapLayer layer) const {
+        return getLayer(layer).getChunkMemoryUsage(chunkY * m_chunksX + chunkX);
+    }
+
+    // Stats since the last render() call (including renderOverlay)
+    int getLastDrawCallCount() const { return m_lastDrawCalls; }
+    int getLastBakedChunkCount() const { return m_lastBakes; } // Chunk textures/meshes rebuilt
+    int getBakedChunkCount() const { return m_chunkCache.getBakedChunkCount(); }
+
 private:
     int m_width;
     int m_height;
     int m_tileSize;
-    std::vector<std::vector<int>> m_tiles;
+
+    // Chunk grid (m_chunksX * m_chunksY), shared by every layer
+    int m_chunksX;
+    int m_chunksY;
+    std::vector<TileLayer> m_layers;
+    uint32_t m_revision;
+
+    TileProperties m_tileProperties;
+
+    TileAnimations m_tileAnimations;
+    double m_animationTime;
+    std::vector<Vector2> m_animationOffsets; // Per animation, rebuilt before mesh draws
+
+    // Bit set = blocked by the GROUND or DECORATION tile. May live in the mapped file.
+    CollisionBitmap m_collision;
+    std::vector<uint32_t> m_collisionRevisions;
+
+    std::vector<MapObject> m_objects;
+
+    // STREAMED maps only: whether each chunk's file tiles are installed, and the tiles set
+    // on it while they weren't (replayed by finishChunkStream)
+    struct TileEdit {
+        int x;
+        int y;
+        TileId tile;
+        MapLayer layer;
+    };
+    std::vector<uint8_t> m_chunkStreamed;
+    std::vector<std::vector<TileEdit>> m_streamEdits;
+
+    // Backing file when loaded with loadFromFile (pages are copy-on-write)
+    std::unique_ptr<MappedFile> m_mapping;
 
     // Tileset support
     Texture2D m_tileset;
     bool m_hasTileset;
+    bool m_ownsTileset;         // False when m_tileset is an atlas page
+    Vector2 m_tilesetOrigin;    // Top-left of the tileset inside m_tileset
     int m_tilesPerRow;
 
-    Color getTileColor(int tileId) const;
+    // Render caches are keyed by (layer, chunk), see cacheKey()
+    TileRenderMode m_renderMode;
+    ChunkRenderCache m_chunkCache;
+    ChunkMeshRenderer m_meshRenderer;
+    std::vector<float> m_meshVertices; // Scratch buffer reused for mesh rebuilds
+
+    // Generated from getTileColor when no tileset is loaded (BATCHED_MESH needs a texture)
+    Texture2D m_fallbackTileset;
+
+    int m_lastDrawCalls;
+    int m_lastBakes;
+
+    static constexpr TileId DEFAULT_TILE = 0;
+    static constexpr int DEFAULT_MAX_BAKED_CHUNKS = 24;
+    static constexpr int DEFAULT_MAX_CHUNK_MESHES = 64;
+    static constexpr int FALLBACK_TILE_COUNT = 6;
+
+    bool inBounds(int x, int y) const { return x >= 0 && x < m_width && y >= 0 && y < m_height; }
+    TileLayer& getLayer(MapLayer layer) { return m_layers[static_cast<int>(layer)]; }
+    const TileLayer& getLayer(MapLayer layer) const { return m_layers[static_cast<int>(layer)]; }
+    int cacheKey(int layerIndex, int chunkIndex) const { return layerIndex * m_chunksX * m_chunksY + chunkIndex; }
+    // Mesh of only the animated tiles, drawn over a baked chunk (BAKED_CHUNKS mode)
+    int animatedCacheKey(int layerIndex, int chunkIndex) const {
+        return (LAYER_COUNT + layerIndex) * m_chunksX * m_chunksY + chunkIndex;
+    }
+
+    void updateCollision(int x, int y);
+    void rebuildCollision();
+
+    void renderLayers(int firstLayer, int lastLayer, int cameraOffsetX, int cameraOffsetY, int viewWidth, int viewHeight);
+    void drawTile(int x, int y, TileId tileId, int cameraOffsetX, int cameraOffsetY);
+    void renderImmediate(int layerIndex, int startX, int startY, int endX, int endY, int cameraOffsetX, int cameraOffsetY);
+    void renderBakedChunks(int layerIndex, int startX, int startY, int endX, int endY, int cameraOffsetX, int cameraOffsetY);
+    void bakeChunk(int layerIndex, int chunkX, int chunkY, const RenderTexture2D& target);
+    void renderAnimatedChunks(int layerIndex, int startX, int startY, int endX, int endY, int cameraOffsetX, int cameraOffsetY);
+    void renderMeshChunks(int layerIndex, int startX, int startY, int endX, int endY, int cameraOffsetX, int cameraOffsetY);
+    void buildChunkMesh(int layerIndex, int chunkX, int chunkY, const Texture2D& tileset, int tilesPerRow, bool animatedOnly);
+    void updateAnimationOffsets(const Texture2D& tileset, int tilesPerRow);
+    bool isChunkEmpty(int layerIndex, int chunkIndex) const;
+    const Texture2D& getFallbackTileset();
+    Rectangle getTileSourceRect(TileId tileId, int tilesPerRow) const;
 };
@@ -0,0 +1,401 @@
+#include "ui_font.h"
+#include "draw_stats.h"
+#include "text_layout.h"
+#include <rlgl.h>
+#include <algorithm>
+#include <iostream>
+
+unsigned char* UIFont::s_fontData = nullptr;
+int UIFont::s_fontDataSize = 0;
+Image UIFont::s_defaultFontImage = {};
+int UIFont::s_baseSize = DEFAULT_BASE_SIZE;
+Texture2D UIFont::s_atlas = {};
+int UIFont::s_cellSize = 0;
+int UIFont::s_cellsPerRow = 0;
+std::vector<UIFont::Cell> UIFont::s_cells;
+uint64_t UIFont::s_useCounter = 0;
+std::vector<GlyphMetrics> UIFont::s_latinGlyphs;
+std::unordered_map<int, GlyphMetrics> UIFont::s_otherGlyphs;
+int UIFont::s_residentCount = 0;
+int UIFont::s_rasterized = 0;
+int UIFont::s_evictions = 0;
+
+void UIFont::init(const std::string& path) {
+    shutdown();
+
+    if (FileExists(path.c_str())) {
+        s_fontData = LoadFileData(path.c_str(), &s_fontDataSize);
+    }
+    if (s_fontData) {
+        s_baseSize = BASE_SIZE;
+    } else {
+        std::cerr << "Failed to load UI font: " << path << " (using the default font)" << std::endl;
+        Font font = GetFontDefault();
+        s_defaultFontImage = LoadImageFromTexture(font.texture);
+        s_baseSize = font.baseSize > 0 ? font.baseSize : DEFAULT_BASE_SIZE;
+    }
+
+    // Cells leave room for glyphs half again as wide as the font size, plus a pixel of
+    // padding on each side so filtering doesn't bleed between neighbours
+    s_cellSize = s_baseSize * 3 / 2 + 2;
+    s_cellsPerRow = ATLAS_SIZE / s_cellSize;
+    s_cells.assign(static_cast<size_t>(s_cellsPerRow) * s_cellsPerRow, Cell());
+
+    std::vector<unsigned char> blank(static_cast<size_t>(ATLAS_SIZE) * ATLAS_SIZE * 2, 0);
+    Image image = {blank.data(), ATLAS_SIZE, ATLAS_SIZE, 1, PIXELFORMAT_UNCOMPRESSED_GRAY_ALPHA};
+    s_atlas = LoadTextureFromImage(image);
+    // The default font is pixel art; TrueType glyphs are drawn scaled down from BASE_SIZE
+    SetTextureFilter(s_atlas, s_fontData ? TEXTURE_FILTER_BILINEAR : TEXTURE_FILTER_POINT);
+
+    // ASCII and Latin-1 metrics up front; their bitmaps wait until they are drawn
+    s_latinGlyphs.assign(256, GlyphMetrics());
+    GlyphBitmap bitmap;
+    for (int codepoint = 32; codepoint < 256; codepoint++) {
+        if (codepoint >= 127 && codepoint < 160) {
+            continue; // Control characters
+        }
+        rasterize(codepoint, s_latinGlyphs[codepoint], bitmap);
+    }
+}
+
+void UIFont::shutdown() {
+    if (s_atlas.id != 0) {
+        UnloadTexture(s_atlas);
+    }
+    if (s_fontData) {
+        UnloadFileData(s_fontData);
+    }
+    if (s_defaultFontImage.data) {
+        UnloadImage(s_defaultFontImage);
+    }
+    s_atlas = {};
+    s_fontData = nullptr;
+    s_fontDataSize = 0;
+    s_defaultFontImage = {};
+    s_baseSize = DEFAULT_BASE_SIZE;
+    s_cells.clear();
+    s_latinGlyphs.clear();
+    s_otherGlyphs.clear();
+    s_residentCount = 0;
+}
+
+float UIFont::getScale(int fontSize) {
+    return static_cast<float>(std::max(fontSize, MIN_FONT_SIZE)) / s_baseSize;
+}
+
+float UIFont::getSpacing(int fontSize) {
+    // Same spacing DrawText uses with the default font
+    return static_cast<float>(std::max(fontSize, MIN_FONT_SIZE) / MIN_FONT_SIZE);
+}
+
+const GlyphMetrics& UIFont::getGlyph(int codepoint) {
+    if (!isReady()) {
+        // The default font's metrics, as MeasureText sees them
+        static GlyphMetrics metrics;
+        GlyphBitmap bitmap;
+        metrics = GlyphMetrics();
+        rasterizeDefaultFont(codepoint, metrics, bitmap);
+        return metrics;
+    }
+    return findOrAddGlyph(codepoint);
+}
+
+GlyphMetrics& UIFont::findOrAddGlyph(int codepoint) {
+    if (codepoint >= 0 && codepoint < static_cast<int>(s_latinGlyphs.size())) {
+        return s_latinGlyphs[codepoint];
+    }
+    auto it = s_otherGlyphs.find(codepoint);
+    if (it != s_otherGlyphs.end()) {
+        return it->second;
+    }
+
+    // First sighting: the bitmap comes with the metrics, so keep it
+    GlyphMetrics& metrics = s_otherGlyphs[codepoint];
+    GlyphBitmap bitmap;
+    rasterize(codepoint, metrics, bitmap);
+    upload(codepoint, metrics, bitmap);
+    return metrics;
+}
+
+bool UIFont::rasterize(int codepoint, GlyphMetrics& metrics, GlyphBitmap& bitmap) {
+    bitmap.width = 0;
+    bitmap.height = 0;
+    bitmap.coverage.clear();
+    bool found = s_fontData ? rasterizeTrueType(codepoint, metrics, bitmap)
+                            : rasterizeDefaultFont(codepoint, metrics, bitmap);
+    if (!found) {
+        found = rasterizeShape(codepoint, metrics, bitmap);
+    }
+    if (!found && codepoint != '?') {
+        // Like DrawText, glyphs the font lacks show as '?'
+        found = s_fontData ? rasterizeTrueType('?', metrics, bitmap)
+                           : rasterizeDefaultFont('?', metrics, bitmap);
+    }
+
+    // Blank glyphs (space) take no cell
+    if (std::none_of(bitmap.coverage.begin(), bitmap.coverage.end(), [](uint8_t c) { return c != 0; })) {
+        bitmap.width = 0;
+        bitmap.height = 0;
+        bitmap.coverage.clear();
+    }
+    metrics.width = bitmap.width;
+    metrics.height = bitmap.height;
+    s_rasterized++;
+    return found;
+}
+
+bool UIFont::rasterizeTrueType(int codepoint, GlyphMetrics& metrics, GlyphBitmap& bitmap) {
+    int requested = codepoint;
+    GlyphInfo* glyph = LoadFontData(s_fontData, s_fontDataSize, s_baseSize, &requested, 1, FONT_DEFAULT);
+    if (!glyph) {
+        return false;
+    }
+
+    // A font without the codepoint gives back an empty glyph (or its "missing" box)
+    const Image& image = glyph->image;
+    bool found = glyph->advanceX > 0 || image.data != nullptr;
+    metrics.advance = static_cast<float>(glyph->advanceX);
+    metrics.offsetX = static_cast<float>(glyph->offsetX);
+    metrics.offsetY = static_cast<float>(glyph->offsetY);
+    if (image.data && image.format == PIXELFORMAT_UNCOMPRESSED_GRAYSCALE) {
+        bitmap.width = image.width;
+        bitmap.height = image.height;
+        const uint8_t* pixels = static_cast<const uint8_t*>(image.data);
+        bitmap.coverage.assign(pixels, pixels + static_cast<size_t>(image.width) * image.height);
+    }
+    UnloadFontData(glyph, 1);
+    return found;
+}
+
+bool UIFont::rasterizeDefaultFont(int codepoint, GlyphMetrics& metrics, GlyphBitmap& bitmap) {
+    Font font = GetFontDefault();
+    if (!font.glyphs || !font.recs) {
+        return false; // No font before the window opens
+    }
+    // Unknown codepoints map to '?'
+    int index = GetGlyphIndex(font, codepoint);
+    if (font.glyphs[index].value != codepoint) {
+        return false;
+    }
+
+    const GlyphInfo& glyph = font.glyphs[index];
+    Rectangle rect = font.recs[index];
+    metrics.advance = glyph.advanceX != 0 ? glyph.advanceX : rect.width + glyph.offsetX;
+    metrics.offsetX = static_cast<float>(glyph.offsetX);
+    metrics.offsetY = static_cast<float>(glyph.offsetY);
+    if (!s_defaultFontImage.data) {
+        return true; // Metrics only
+    }
+
+    bitmap.width = static_cast<int>(rect.width);
+    bitmap.height = static_cast<int>(rect.height);
+    bitmap.coverage.resize(static_cast<size_t>(bitmap.width) * bitmap.height);
+    for (int y = 0; y < bitmap.height; y++) {
+        for (int x = 0; x < bitmap.width; x++) {
+            Color pixel = GetImageColor(s_defaultFontImage, static_cast<int>(rect.x) + x, static_cast<int>(rect.y) + y);
+            bitmap.coverage[static_cast<size_t>(y) * bitmap.width + x] = pixel.a;
+        }
+    }
+    return true;
+}
+
+bool UIFont::rasterizeShape(int codepoint, GlyphMetrics& metrics, GlyphBitmap& bitmap) {
+    // Triangles pointing up, right, down and left, as in U+25B2 / 25B6 / 25BC / 25C0
+    float corners[3][2];
+    switch (codepoint) {
+        case 0x25B2: corners[0][0] = 0.5f; corners[0][1] = 0.0f; corners[1][0] = 1.0f; corners[1][1] = 1.0f;
+                     corners[2][0] = 0.0f; corners[2][1] = 1.0f; break;
+        case 0x25B6: corners[0][0] = 0.0f; corners[0][1] = 0.0f; corners[1][0] = 1.0f; corners[1][1] = 0.5f;
+                     corners[2][0] = 0.0f; corners[2][1] = 1.0f; break;
+        case 0x25BC: corners[0][0] = 0.0f; corners[0][1] = 0.0f; corners[1][0] = 1.0f; corners[1][1] = 0.0f;
+                     corners[2][0] = 0.5f; corners[2][1] = 1.0f; break;
+        case 0x25C0: corners[0][0] = 1.0f; corners[0][1] = 0.0f; corners[1][0] = 1.0f; corners[1][1] = 1.0f;
+                     corners[2][0] = 0.0f; corners[2][1] = 0.5f; break;
+        default:
+            return false;
+    }
+
+    // Six tenths of the font size, centered on the line, with 4x4 samples per pixel
+    int size = std::max(s_baseSize * 6 / 10, 3);
+    bitmap.width = size;
+    bitmap.height = size;
+    bitmap.coverage.assign(static_cast<size_t>(size) * size, 0);
+    auto edge = [](const float* a, const float* b, float x, float y) {
+        return (b[0] - a[0]) * (y - a[1]) - (b[1] - a[1]) * (x - a[0]);
+    };
+    for (int y = 0; y < size; y++) {
+        for (int x = 0; x < size; x++) {
+            int inside = 0;
+            for (int sample = 0; sample < 16; sample++) {
+                float sx = (x + (sample % 4 + 0.5f) / 4.0f) / size;
+                float sy = (y + (sample / 4 + 0.5f) / 4.0f) / size;
+                float e0 = edge(corners[0], corners[1], sx, sy);
+                float e1 = edge(corners[1], corners[2], sx, sy);
+                float e2 = edge(corners[2], corners[0], sx, sy);
+                if ((e0 >= 0 && e1 >= 0 && e2 >= 0) || (e0 <= 0 && e1 <= 0 && e2 <= 0)) {
+                    inside++;
+                }
+            }
+            bitmap.coverage[static_cast<size_t>(y) * size + x] = static_cast<uint8_t>(inside * 255 / 16);
+        }
+    }
+
+    metrics.advance = static_cast<float>(size + std::max(s_baseSize / 10, 1));
+    metrics.offsetX = 0.0f;
+    metrics.offsetY = static_cast<float>((s_baseSize - size) / 2);
+    return true;
+}
+
+void UIFont::upload(int codepoint, GlyphMetrics& metrics, const GlyphBitmap& bitmap) {
+    if (!isReady() || bitmap.width <= 0 || bitmap.height <= 0) {
+        return;
+    }
+
+    int cell;
+    if (s_residentCount < static_cast<int>(s_cells.size())) {
+        cell = s_residentCount++;
+    } else {
+        auto oldest = std::min_element(s_cells.begin(), s_cells.end(),
+                                       [](const Cell& a, const Cell& b) { return a.lastUse < b.lastUse; });
+        cell = static_cast<int>(oldest - s_cells.begin());
+        findOrAddGlyph(oldest->codepoint).cell = -1;
+        s_evictions++;
+        // Quads already queued may still point at the cell
+        rlDrawRenderBatchActive();
+        DrawStats::breakBatch();
+    }
+
+    // Oversized glyphs are cropped to the cell
+    int width = std::min(bitmap.width, s_cellSize - 2);
+    int height = std::min(bitmap.height, s_cellSize - 2);
+    std::vector<uint8_t> pixels(static_cast<size_t>(width) * height * 2);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            size_t pixel = static_cast<size_t>(y) * width + x;
+            pixels[pixel * 2] = 255;
+            pixels[pixel * 2 + 1] = bitmap.coverage[static_cast<size_t>(y) * bitmap.width + x];
+        }
+    }
+
+    metrics.width = width;
+    metrics.height = height;
+    metrics.cell = cell;
+    s_cells[cell] = {codepoint, ++s_useCounter};
+    UpdateTextureRec(s_atlas, getCellRect(cell, metrics), pixels.data());
+}
+
+void UIFont::makeResident(int codepoint, GlyphMetrics& metrics) {
+    if (metrics.cell >= 0) {
+        s_cells[metrics.cell].lastUse = ++s_useCounter;
+        return;
+    }
+    if (metrics.width == 0) {
+        return; // Nothing to draw
+    }
+    GlyphMetrics fresh;
+    GlyphBitmap bitmap;
+    rasterize(codepoint, fresh, bitmap);
+    upload(codepoint, metrics, bitmap);
+}
+
+Rectangle UIFont::getCellRect(int cell, const GlyphMetrics& metrics) {
+    return {
+        static_cast<float>((cell % s_cellsPerRow) * s_cellSize + 1),
+        static_cast<float>((cell / s_cellsPerRow) * s_cellSize + 1),
+        static_cast<float>(metrics.width),
+        static_cast<float>(metrics.height)
+    };
+}
+
+void UIFont::drawText(const char* text, int x, int y, int fontSize, Color color) {
+    if (!isReady()) {
+        DrawStats::useDefaultFont();
+        DrawText(text, x, y, fontSize, color);
+        return;
+    }
+    if (!text) {
+        return;
+    }
+
+    DrawStats::useTexture(s_atlas.id);
+    float scale = getScale(fontSize);
+    float spacing = getSpacing(fontSize);
+    float penX = static_cast<float>(x);
+    float penY = static_cast<float>(y);
+    for (int i = 0; text[i] != '\0';) {
+        int size = 0;
+        int codepoint = GetCodepointNext(text + i, &size);
+        i += std::max(size, 1);
+        if (codepoint == '\n') {
+            penX = static_cast<float>(x);
+            penY += std::max(fontSize, MIN_FONT_SIZE) + LINE_SPACING;
+            continue;
+        }
+
+        penX += drawGlyph(codepoint, penX, penY, scale, color) * scale + spacing;
+    }
+}
+
+void UIFont::drawGlyphs(const TextGlyph* glyphs, int count, int x, int y, int fontSize, Color color) {
+    if (!isReady()) {
+        DrawStats::useDefaultFont();
+        Font font = GetFontDefault();
+        float size = static_cast<float>(std::max(fontSize, MIN_FONT_SIZE));
+        for (int i = 0; i < count; i++) {
+            DrawTextCodepoint(font, glyphs[i].codepoint, {x + glyphs[i].x, static_cast<float>(y)}, size, color);
+        }
+        return;
+    }
+
+    DrawStats::useTexture(s_atlas.id);
+    float scale = getScale(fontSize);
+    for (int i = 0; i < count; i++) {
+        drawGlyph(glyphs[i].codepoint, x + glyphs[i].x, static_cast<float>(y), scale, color);
+    }
+}
+
+float UIFont::drawGlyph(int codepoint, float penX, float penY, float scale, Color color) {
+    GlyphMetrics& glyph = findOrAddGlyph(codepoint);
+    makeResident(codepoint, glyph);
+    if (glyph.cell >= 0) {
+        Rectangle dest = {penX + glyph.offsetX * scale, penY + glyph.offsetY * scale,
+                          glyph.width * scale, glyph.height * scale};
+        DrawTexturePro(s_atlas, getCellRect(glyph.cell, glyph), dest, {0.0f, 0.0f}, 0.0f, color);
+    }
+    return glyph.advance;
+}
+
+int UIFont::measureText(const char* text, int fontSize) {
+    if (!isReady()) {
+        return MeasureText(text, fontSize);
+    }
+    if (!text) {
+        return 0;
+    }
+
+    // Widest line; advances are summed unscaled and scaled once, like MeasureText
+    float scale = getScale(fontSize);
+    float spacing = getSpacing(fontSize);
+    float widest = 0.0f;
+    float advances = 0.0f;
+    int glyphCount = 0;
+    for (int i = 0;; ) {
+        int size = 0;
+        int codepoint = text[i] != '\0' ? GetCodepointNext(text + i, &size) : '\n';
+        if (codepoint == '\n') {
+            if (glyphCount > 0) {
+                widest = std::max(widest, advances * scale + (glyphCount - 1) * spacing);
+            }
+            if (text[i] == '\0') {
+                break;
+            }
+            advances = 0.0f;
+            glyphCount = 0;
+        } else {
+            advances += findOrAddGlyph(codepoint).advance;
+            glyphCount++;
+        }
+        i += std::max(size, 1);
+    }
+    return static_cast<int>(widest);
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <raylib.h>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct TextGlyph;
+
+// Glyph size and placement in the font's own pixels (UIFont::getBaseSize()); scale by
+// UIFont::getScale() for a font size
+struct GlyphMetrics {
+    float advance = 0.0f;
+    float offsetX = 0.0f;
+    float offsetY = 0.0f;
+    int width = 0;
+    int height = 0;
+    int cell = -1; // Atlas cell holding the bitmap, -1 while not resident
+};
+
+// Text for the whole UI, drawn from one glyph atlas texture.
+//
+// Glyphs come from a TrueType file when there is one, rasterized the first time they are
+// drawn into fixed-size cells of the atlas; when the atlas is full the least recently used
+// glyph gives up its cell. Without the file the glyphs are copied out of raylib's default
+// font instead. Either way a few geometric shapes the UI uses (like the dialog's "▼") are
+// drawn by hand when the font lacks them.
+//
+// Metrics of ASCII and Latin-1 are worked out once in init(); others the first time they
+// are asked for. Measuring and laying out text never goes back to the font file.
+//
+// Since every glyph shares the atlas texture, raylib's batcher merges all text drawn in a
+// row into one draw call. Text stays in draw order with the shapes around it instead of
+// being deferred to the end of the frame, so a panel drawn over some text still hides it.
+//
+// Like TextureCache this is process-wide state for the main (GL) thread. Before init()
+// (or after shutdown()) calls fall through to raylib's DrawText and MeasureText.
+class UIFont {
+public:
+    static constexpr int BASE_SIZE = 32;      // Rasterized size of TrueType glyphs
+    static constexpr int ATLAS_SIZE = 1024;
+    static constexpr int LINE_SPACING = 2;    // Extra pixels between '\n'-separated lines
+    static constexpr int MIN_FONT_SIZE = 10;  // Smaller sizes draw at this, as with DrawText
+
+    // Needs the window. Falls back to the default font's glyphs if the file can't be read.
+    static void init(const std::string& path);
+    static void shutdown();
+    static bool isReady() { return s_atlas.id != 0; }
+
+    // Same arguments and placement as DrawText / MeasureText
+    static void drawText(const char* text, int x, int y, int fontSize, Color color);
+    static int measureText(const char* text, int fontSize);
+    // Glyphs already placed by TextLayout, each at (x + glyph.x, y). Skips decoding and
+    // advancing, leaving only the cell lookup and the quad.
+    static void drawGlyphs(const TextGlyph* glyphs, int count, int x, int y, int fontSize, Color color);
+
+    static const GlyphMetrics& getGlyph(int codepoint);
+    static float getScale(int fontSize);
+    static float getSpacing(int fontSize);     // Pixels between glyphs
+    static int getBaseSize() { return s_baseSize; }
+
+    static int getResidentCount() { return s_residentCount; }
+    static int getRasterizedCount() { return s_rasterized; } // Since init()
+    static int getEvictionCount() { return s_evictions; }
+
+private:
+    static constexpr int DEFAULT_BASE_SIZE = 10; // raylib's default font
+
+    struct Cell {
+        int codepoint = -1;
+        uint64_t lastUse = 0;
+    };
+
+    // Coverage (0-255) of one glyph, row by row
+    struct GlyphBitmap {
+        int width = 0;
+        int height = 0;
+        std::vector<uint8_t> coverage;
+    };
+
+    static GlyphMetrics& findOrAddGlyph(int codepoint);
+    static bool rasterize(int codepoint, GlyphMetrics& metrics, GlyphBitmap& bitmap);
+    static bool rasterizeTrueType(int codepoint, GlyphMetrics& metrics, GlyphBitmap& bitmap);
+    static bool rasterizeDefaultFont(int codepoint, GlyphMetrics& metrics, GlyphBitmap& bitmap);
+    static bool rasterizeShape(int codepoint, GlyphMetrics& metrics, GlyphBitmap& bitmap);
+    // Puts the bitmap in a free or evicted cell
+    static void upload(int codepoint, GlyphMetrics& metrics, const GlyphBitmap& bitmap);
+    static void makeResident(int codepoint, GlyphMetrics& metrics);
+    static Rectangle getCellRect(int cell, const GlyphMetrics& metrics);
+    // Pen position is the glyph's origin; the atlas must be the current texture.
+    // Returns the glyph's unscaled advance.
+    static float drawGlyph(int codepoint, float penX, float penY, float scale, Color color);
+
+    static unsigned char* s_fontData;  // TrueType file, null when using the default font
+    static int s_fontDataSize;
+    static Image s_defaultFontImage;   // CPU copy of the default font, when it's the source
+    static int s_baseSize;
+
+    static Texture2D s_atlas;
+    static int s_cellSize;
+    static int s_cellsPerRow;
+    static std::vector<Cell> s_cells;
+    static uint64_t s_useCounter;
+
+    static std::vector<GlyphMetrics> s_latinGlyphs;             // Codepoints below 256
+    static std::unordered_map<int, GlyphMetrics> s_otherGlyphs; // Filled on first use
+    static int s_residentCount;
+    static int s_rasterized;
+    static int s_evictions;
+};
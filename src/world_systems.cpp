@@ -0,0 +1,312 @@
+#include "world_systems.h"
+#include "ui_font.h"
+#include <raylib.h>
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+
+Direction directionOf(int dx, int dy) {
+    if (dy < 0) {
+        return Direction::UP;
+    } else if (dy > 0) {
+        return Direction::DOWN;
+    } else if (dx < 0) {
+        return Direction::LEFT;
+    }
+    return Direction::RIGHT;
+}
+
+// Step requested by the keyboard, gamepad stick or d-pad; the gamepad wins
+void readInput(int& dx, int& dy) {
+    dx = 0;
+    dy = 0;
+    if (IsKeyDown(KEY_W) || IsKeyDown(KEY_UP)) {
+        dy = -1;
+    } else if (IsKeyDown(KEY_S) || IsKeyDown(KEY_DOWN)) {
+        dy = 1;
+    } else if (IsKeyDown(KEY_A) || IsKeyDown(KEY_LEFT)) {
+        dx = -1;
+    } else if (IsKeyDown(KEY_D) || IsKeyDown(KEY_RIGHT)) {
+        dx = 1;
+    }
+
+    if (!IsGamepadAvailable(0)) {
+        return;
+    }
+    float axisX = GetGamepadAxisMovement(0, GAMEPAD_AXIS_LEFT_X);
+    float axisY = GetGamepadAxisMovement(0, GAMEPAD_AXIS_LEFT_Y);
+    if (axisY < -0.5f) {
+        dx = 0; dy = -1;
+    } else if (axisY > 0.5f) {
+        dx = 0; dy = 1;
+    } else if (axisX < -0.5f) {
+        dx = -1; dy = 0;
+    } else if (axisX > 0.5f) {
+        dx = 1; dy = 0;
+    }
+
+    // D-pad support
+    if (IsGamepadButtonDown(0, GAMEPAD_BUTTON_LEFT_FACE_UP)) {
+        dx = 0; dy = -1;
+    } else if (IsGamepadButtonDown(0, GAMEPAD_BUTTON_LEFT_FACE_DOWN)) {
+        dx = 0; dy = 1;
+    } else if (IsGamepadButtonDown(0, GAMEPAD_BUTTON_LEFT_FACE_LEFT)) {
+        dx = -1; dy = 0;
+    } else if (IsGamepadButtonDown(0, GAMEPAD_BUTTON_LEFT_FACE_RIGHT)) {
+        dx = 1; dy = 0;
+    }
+}
+
+} // namespace
+
+WorldSystems::WorldSystems(EntityWorld& world, const Tilemap& tilemap, int tileSize)
+    : m_world(world), m_tilemap(tilemap), m_tileSize(tileSize),
+      m_occupancy(std::make_unique<OccupancyGrid>(tilemap.getWidth(), tilemap.getHeight())),
+      m_grid(std::make_unique<SpatialGrid>(tilemap.getWidth(), tilemap.getHeight())) {
+}
+
+Entity WorldSystems::spawn(int tileX, int tileY, float speed, Sprite sprite, bool turns) {
+    Entity entity = m_world.create();
+    m_world.getPositions().add(entity, {tileX, tileY, tileX * m_tileSize, tileY * m_tileSize});
+    Movement movement;
+    movement.speed = speed;
+    movement.targetX = tileX;
+    movement.targetY = tileY;
+    m_world.getMovements().add(entity, movement);
+    m_world.getSprites().add(entity, {std::move(sprite), turns});
+
+    m_occupancy->setOccupied(tileX, tileY, true);
+    m_grid->insert(static_cast<int>(entity), tileX, tileY);
+    return entity;
+}
+
+Entity WorldSystems::spawnPlayer(int tileX, int tileY, const std::string& spritePath, const TextureAtlas* atlas) {
+    // The player sheet has a walk cycle per direction (see assets/ASSET_SPECS.md)
+    Entity player = spawn(tileX, tileY, PLAYER_SPEED,
+                          spritePath.empty() ? Sprite(m_tileSize - 4, m_tileSize - 4, YELLOW) :
+                                               Sprite(spritePath, m_tileSize, m_tileSize, atlas),
+                          true);
+    m_world.getPlayerControls().add(player, {});
+    return player;
+}
+
+Entity WorldSystems::spawnNPC(const std::string& name, int tileX, int tileY, int dialogId, NPCType type,
+                              const std::string& spritePath, const TextureAtlas* atlas) {
+    // NPC images are single frames, so their sprites don't turn
+    Color placeholder = (type == NPCType::SHOP) ? ORANGE : BLUE;
+    Entity npc = spawn(tileX, tileY, NPC_SPEED,
+                       spritePath.empty() ? Sprite(m_tileSize - 4, m_tileSize - 4, placeholder) :
+                                            Sprite(spritePath, m_tileSize, m_tileSize, atlas),
+                       false);
+    m_world.getInteractions().add(npc, {name, dialogId, type});
+    m_world.getFollowers().add(npc, {});
+    return npc;
+}
+
+void WorldSystems::despawn(Entity entity) {
+    if (const Position* position = m_world.getPositions().find(entity)) {
+        m_occupancy->setOccupied(position->tileX, position->tileY, false);
+        const Movement* movement = m_world.getMovements().find(entity);
+        if (movement && movement->moving) {
+            m_occupancy->setOccupied(movement->targetX, movement->targetY, false);
+        }
+    }
+    m_grid->remove(static_cast<int>(entity));
+    m_world.destroy(entity);
+}
+
+void WorldSystems::updatePlayerControl() {
+    ComponentArray<PlayerControl>& controls = m_world.getPlayerControls();
+    for (size_t i = 0; i < controls.size(); i++) {
+        Entity entity = controls.getEntity(i);
+        const Movement* movement = m_world.getMovements().find(entity);
+        if (movement && movement->moving) {
+            continue; // Don't accept input while moving
+        }
+
+        PlayerControl& control = controls.at(i);
+        int dx, dy;
+        readInput(dx, dy);
+        if (dx != 0 || dy != 0) {
+            control.path.clear();
+            control.pathIndex = 0;
+            step(entity, dx, dy);
+            continue;
+        }
+
+        // No input: take the next step of the route, if any
+        if (control.pathIndex < control.path.size()) {
+            const Position& position = m_world.getPositions().get(entity);
+            TilePoint next = control.path[control.pathIndex++];
+            dx = next.x - position.tileX;
+            dy = next.y - position.tileY;
+            if (std::abs(dx) + std::abs(dy) != 1 || !step(entity, dx, dy)) {
+                control.path.clear();
+                control.pathIndex = 0;
+            }
+        }
+    }
+}
+
+void WorldSystems::updateFollowers(FlowFieldCache& flowFields, TilePoint goal, bool everyone) {
+    // Every follower shares one flow field, so each step is a lookup
+    const FlowField* field = nullptr;
+
+    ComponentArray<FollowAI>& followers = m_world.getFollowers();
+    for (size_t i = 0; i < followers.size(); i++) {
+        if (!everyone && !followers.at(i).followsPlayer) {
+            continue;
+        }
+        Entity entity = followers.getEntity(i);
+        const Movement* movement = m_world.getMovements().find(entity);
+        const Position* position = m_world.getPositions().find(entity);
+        if (!movement || !position || movement->moving) {
+            continue;
+        }
+
+        if (!field) {
+            field = &flowFields.get(goal);
+        }
+        int dx = 0, dy = 0;
+        if (field->getDistance(position->tileX, position->tileY) <= FOLLOW_DISTANCE ||
+            !field->getStep(position->tileX, position->tileY, dx, dy)) {
+            continue;
+        }
+        // Waits while the player or another entity holds the tile
+        step(entity, dx, dy);
+    }
+}
+
+void WorldSystems::updateMovement(float deltaTime) {
+    ComponentArray<Movement>& movements = m_world.getMovements();
+    for (size_t i = 0; i < movements.size(); i++) {
+        Movement& movement = movements.at(i);
+        if (!movement.moving) {
+            continue;
+        }
+
+        Entity entity = movements.getEntity(i);
+        Position& position = m_world.getPositions().get(entity);
+        movement.progress += deltaTime * movement.speed;
+        if (movement.progress >= 1.0f) {
+            m_occupancy->setOccupied(position.tileX, position.tileY, false);
+            position.tileX = movement.targetX;
+            position.tileY = movement.targetY;
+            movement.moving = false;
+            movement.progress = 0.0f;
+            if (SpriteComponent* sprite = m_world.getSprites().find(entity)) {
+                sprite->sprite.setAnimating(false);
+            }
+        }
+
+        float x = position.tileX + (movement.targetX - position.tileX) * movement.progress;
+        float y = position.tileY + (movement.targetY - position.tileY) * movement.progress;
+        position.pixelX = static_cast<int>(x * m_tileSize);
+        position.pixelY = static_cast<int>(y * m_tileSize);
+    }
+}
+
+bool WorldSystems::step(Entity entity, int dx, int dy) {
+    Movement* movement = m_world.getMovements().find(entity);
+    Position* position = m_world.getPositions().find(entity);
+    if (!movement || !position || movement->moving) {
+        return false;
+    }
+
+    // Turn even if the way is blocked, so the player faces the wall
+    SpriteComponent* sprite = m_world.getSprites().find(entity);
+    if (sprite && sprite->turns) {
+        sprite->sprite.setDirection(directionOf(dx, dy));
+    }
+
+    int targetX = position->tileX + dx;
+    int targetY = position->tileY + dy;
+    if (!m_tilemap.isWalkable(targetX, targetY) || m_occupancy->isOccupied(targetX, targetY)) {
+        return false;
+    }
+
+    m_occupancy->setOccupied(targetX, targetY, true);
+    m_grid->move(static_cast<int>(entity), targetX, targetY);
+    movement->targetX = targetX;
+    movement->targetY = targetY;
+    movement->moving = true;
+    movement->progress = 0.0f;
+    if (sprite) {
+        sprite->sprite.setAnimating(true);
+    }
+    return true;
+}
+
+void WorldSystems::followPath(Entity entity, std::vector<TilePoint> path) {
+    if (PlayerControl* control = m_world.getPlayerControls().find(entity)) {
+        control->path = std::move(path);
+        control->pathIndex = 0;
+    }
+}
+
+int WorldSystems::getMoveDirectionX(Entity entity) const {
+    const Movement* movement = m_world.getMovements().find(entity);
+    return movement && movement->moving ? movement->targetX - m_world.getPositions().get(entity).tileX : 0;
+}
+
+int WorldSystems::getMoveDirectionY(Entity entity) const {
+    const Movement* movement = m_world.getMovements().find(entity);
+    return movement && movement->moving ? movement->targetY - m_world.getPositions().get(entity).tileY : 0;
+}
+
+const std::vector<int>& WorldSystems::query(int x, int y, int w, int h) {
+    m_query.clear();
+    m_grid->query(x, y, w, h, m_query);
+    // Same order whatever cells they came from
+    std::sort(m_query.begin(), m_query.end());
+    return m_query;
+}
+
+Entity WorldSystems::findInteraction(int tileX, int tileY) {
+    // Two tiles out, for entities whose step has not ended yet
+    for (int id : query(tileX - 2, tileY - 2, 5, 5)) {
+        Entity entity = static_cast<Entity>(id);
+        const Position* position = m_world.getPositions().find(entity);
+        if (!position || !m_world.getInteractions().has(entity)) {
+            continue;
+        }
+        int dx = std::abs(position->tileX - tileX);
+        int dy = std::abs(position->tileY - tileY);
+        if ((dx == 1 && dy == 0) || (dx == 0 && dy == 1)) {
+            return entity;
+        }
+    }
+    return INVALID_ENTITY;
+}
+
+void WorldSystems::queueSprites(SpriteBatch& batch, const std::vector<int>& entities,
+                                int cameraOffsetX, int cameraOffsetY) const {
+    for (int id : entities) {
+        Entity entity = static_cast<Entity>(id);
+        const SpriteComponent* sprite = m_world.getSprites().find(entity);
+        const Position* position = m_world.getPositions().find(entity);
+        if (!sprite || !position) {
+            continue;
+        }
+        // Sorted by the bottom of the entity's tile
+        sprite->sprite.submit(batch, position->pixelX - cameraOffsetX + 2, position->pixelY - cameraOffsetY + 2,
+                              position->pixelY + m_tileSize);
+    }
+}
+
+void WorldSystems::drawLabels(const std::vector<int>& entities, int cameraOffsetX, int cameraOffsetY) const {
+    for (int id : entities) {
+        Entity entity = static_cast<Entity>(id);
+        const Interaction* interaction = m_world.getInteractions().find(entity);
+        const Position* position = m_world.getPositions().find(entity);
+        if (!interaction || !position) {
+            continue;
+        }
+        int screenX = position->pixelX - cameraOffsetX + 2;
+        int screenY = position->pixelY - cameraOffsetY + 2;
+        int size = m_tileSize - 4;
+        int textWidth = UIFont::measureText(interaction->name.c_str(), 10);
+        UIFont::drawText(interaction->name.c_str(), screenX + (size - textWidth) / 2, screenY - 15, 10, WHITE);
+    }
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "entity_world.h"
+#include "flow_field.h"
+#include "occupancy_grid.h"
+#include "spatial_grid.h"
+#include "sprite_batch.h"
+#include "tilemap.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+class TextureAtlas;
+
+// Runs the exploration world. Each update walks the dense array of the component it is
+// about (PlayerControl, FollowAI, Movement) rather than a list per kind of object, so a
+// new kind of entity is just a new mix of components.
+//
+// Also keeps the two indexes every entity with a Position is in: the OccupancyGrid of the
+// tiles entities hold, and a SpatialGrid by the tile each one stands on or steps to.
+class WorldSystems {
+public:
+    static constexpr float PLAYER_SPEED = 4.0f; // Tiles per second
+    static constexpr float NPC_SPEED = 3.0f;    // A bit slower than the player
+    static constexpr int FOLLOW_DISTANCE = 1;   // Followers stop this many steps from the player
+
+    // The tilemap must outlive the systems
+    WorldSystems(EntityWorld& world, const Tilemap& tilemap, int tileSize);
+
+    // Without a sprite path the entity is drawn as a colored placeholder
+    Entity spawnPlayer(int tileX, int tileY, const std::string& spritePath, const TextureAtlas* atlas);
+    Entity spawnNPC(const std::string& name, int tileX, int tileY, int dialogId, NPCType type,
+                    const std::string& spritePath, const TextureAtlas* atlas);
+    void despawn(Entity entity);
+
+    // Keyboard and gamepad steps for PlayerControl entities, or the next step of their route
+    void updatePlayerControl();
+    // FollowAI entities that follow (all of them if everyone is set) step toward the goal
+    void updateFollowers(FlowFieldCache& flowFields, TilePoint goal, bool everyone);
+    // Advances steps; the tile changes when a step ends
+    void updateMovement(float deltaTime);
+
+    // Starts a step to the neighbouring tile, turning the sprite if it turns. False if the
+    // entity is already stepping or the tile is blocked or held.
+    bool step(Entity entity, int dx, int dy);
+
+    // Walks a route (Pathfinder::findPath format) one tile at a time from the tile the
+    // entity is standing on or stepping to. Input, or a blocked step, drops it.
+    void followPath(Entity entity, std::vector<TilePoint> path);
+
+    // Direction of the step in progress (-1, 0 or 1 per axis), 0 when standing still
+    int getMoveDirectionX(Entity entity) const;
+    int getMoveDirectionY(Entity entity) const;
+
+    // Entities inside the tile rectangle, in ascending order; valid until the next query
+    const std::vector<int>& query(int x, int y, int w, int h);
+    // An Interaction entity next to the tile (no diagonals), or INVALID_ENTITY
+    Entity findInteraction(int tileX, int tileY);
+
+    // Queues the sprites of the given entities into the frame's batch, sorted by their feet
+    void queueSprites(SpriteBatch& batch, const std::vector<int>& entities, int cameraOffsetX, int cameraOffsetY) const;
+    // Interaction names above the given entities; drawn once every sprite has gone out
+    void drawLabels(const std::vector<int>& entities, int cameraOffsetX, int cameraOffsetY) const;
+
+    const OccupancyGrid& getOccupancy() const { return *m_occupancy; }
+    const SpatialGrid& getGrid() const { return *m_grid; }
+
+private:
+    Entity spawn(int tileX, int tileY, float speed, Sprite sprite, bool turns);
+
+    EntityWorld& m_world;
+    const Tilemap& m_tilemap;
+    int m_tileSize;
+    std::unique_ptr<OccupancyGrid> m_occupancy;
+    std::unique_ptr<SpatialGrid> m_grid;
+    std::vector<int> m_query;
+};
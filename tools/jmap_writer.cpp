@@ -0,0 +1,135 @@
+// jmap_writer - converts a plain text map into the binary .jmap format
+//
+// Usage: jmap_writer <input.txt> <output.jmap> [tileSize] [tile_properties.txt]
+//
+// Each line of the input is one row of tiles, one character per tile:
+//   .  grass (0)    #  wall (1)    ~  water (2)    =  path (3)
+//   0-9 any other tile ID
+//   space  no tile (decoration/overlay layers only)
+// Rows start on the ground layer. A line reading [decoration] or [overlay] switches
+// the following rows to that layer, starting again from the top of the map.
+// Short ground rows are padded with grass.
+// The collision bitmap is baked from the tile properties file (built-in defaults if omitted).
+#include "tilemap.h"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr int DEFAULT_TILE_SIZE = 32;
+constexpr int NO_TILE = -1;       // Clears the cell
+constexpr int INVALID_TILE = -2;  // Unknown character
+
+struct LayerRows {
+    MapLayer layer;
+    std::vector<std::string> rows;
+};
+
+int tileIdFromChar(char c) {
+    switch (c) {
+        case ' ': return NO_TILE;
+        case '.': return 0;
+        case '#': return 1;
+        case '~': return 2;
+        case '=': return 3;
+        default:
+            if (c >= '0' && c <= '9') {
+                return c - '0';
+            }
+            return INVALID_TILE;
+    }
+}
+
+bool parseLayerName(const std::string& line, MapLayer& layer) {
+    if (line == "[ground]") {
+        layer = MapLayer::GROUND;
+    } else if (line == "[decoration]") {
+        layer = MapLayer::DECORATION;
+    } else if (line == "[overlay]") {
+        layer = MapLayer::OVERLAY;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " <input.txt> <output.jmap> [tileSize] [tile_properties.txt]" << std::endl;
+        return 1;
+    }
+
+    std::ifstream input(argv[1]);
+    if (!input) {
+        std::cerr << "Failed to open " << argv[1] << std::endl;
+        return 1;
+    }
+
+    int tileSize = (argc > 3) ? std::atoi(argv[3]) : DEFAULT_TILE_SIZE;
+    if (tileSize <= 0) {
+        std::cerr << "Invalid tile size: " << argv[3] << std::endl;
+        return 1;
+    }
+
+    TileProperties properties;
+    if (argc > 4 && !properties.loadFromFile(argv[4])) {
+        return 1;
+    }
+
+    std::vector<LayerRows> layers = {{MapLayer::GROUND, {}}};
+    std::string line;
+    size_t width = 0;
+    size_t height = 0;
+    while (std::getline(input, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+
+        MapLayer layer;
+        if (parseLayerName(line, layer)) {
+            layers.push_back({layer, {}});
+            continue;
+        }
+
+        layers.back().rows.push_back(line);
+        width = std::max(width, line.size());
+        height = std::max(height, layers.back().rows.size());
+    }
+
+    if (height == 0 || width == 0) {
+        std::cerr << "Map is empty: " << argv[1] << std::endl;
+        return 1;
+    }
+
+    Tilemap map(static_cast<int>(width), static_cast<int>(height), tileSize);
+    map.setTileProperties(properties);
+    for (const LayerRows& layer : layers) {
+        for (size_t y = 0; y < layer.rows.size(); y++) {
+            const std::string& row = layer.rows[y];
+            for (size_t x = 0; x < row.size(); x++) {
+                int tileId = tileIdFromChar(row[x]);
+                if (tileId == INVALID_TILE || (tileId == NO_TILE && layer.layer == MapLayer::GROUND)) {
+                    std::cerr << argv[1] << ": unknown tile '" << row[x] << "' at "
+                              << x << "," << y << std::endl;
+                    return 1;
+                }
+                map.setTile(static_cast<int>(x), static_cast<int>(y), tileId, layer.layer);
+            }
+        }
+    }
+
+    map.compact();
+    if (!map.saveToFile(argv[2])) {
+        return 1;
+    }
+
+    std::cout << "Wrote " << argv[2] << " (" << width << "x" << height << ", "
+              << map.getBytesPerTile() << " bytes/tile)" << std::endl;
+    return 0;
+}
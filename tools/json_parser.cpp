@@ -0,0 +1,270 @@
+#include "json_parser.h"
+#include "utf8.h"
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+class JsonReader {
+public:
+    explicit JsonReader(const std::string& text) : m_text(text), m_pos(0) {}
+
+    bool parseDocument(JsonValue& result, std::string& error) {
+        if (!parseValue(result, 0)) {
+            error = m_error;
+            return false;
+        }
+        skipWhitespace();
+        if (m_pos != m_text.size()) {
+            fail("trailing characters after document");
+            error = m_error;
+            return false;
+        }
+        return true;
+    }
+
+private:
+    static constexpr int MAX_DEPTH = 256;
+
+    const std::string& m_text;
+    size_t m_pos;
+    std::string m_error;
+
+    bool fail(const char* message) {
+        int line = 1;
+        for (size_t i = 0; i < m_pos && i < m_text.size(); i++) {
+            if (m_text[i] == '\n') {
+                line++;
+            }
+        }
+        m_error = "line " + std::to_string(line) + ": " + message;
+        return false;
+    }
+
+    void skipWhitespace() {
+        while (m_pos < m_text.size()) {
+            char c = m_text[m_pos];
+            if (c != ' ' && c != '\t' && c != '\r' && c != '\n') {
+                break;
+            }
+            m_pos++;
+        }
+    }
+
+    bool consume(char c) {
+        skipWhitespace();
+        if (m_pos < m_text.size() && m_text[m_pos] == c) {
+            m_pos++;
+            return true;
+        }
+        return false;
+    }
+
+    bool matchLiteral(const char* literal) {
+        size_t length = std::strlen(literal);
+        if (m_text.compare(m_pos, length, literal) == 0) {
+            m_pos += length;
+            return true;
+        }
+        return false;
+    }
+
+    bool parseValue(JsonValue& value, int depth) {
+        if (depth > MAX_DEPTH) {
+            return fail("nesting too deep");
+        }
+
+        skipWhitespace();
+        if (m_pos >= m_text.size()) {
+            return fail("unexpected end of input");
+        }
+
+        char c = m_text[m_pos];
+        if (c == '{') {
+            return parseObject(value, depth);
+        }
+        if (c == '[') {
+            return parseArray(value, depth);
+        }
+        if (c == '"') {
+            value.type = JsonValue::Type::STRING;
+            return parseString(value.string);
+        }
+        if (matchLiteral("true")) {
+            value.type = JsonValue::Type::BOOL;
+            value.boolean = true;
+            return true;
+        }
+        if (matchLiteral("false")) {
+            value.type = JsonValue::Type::BOOL;
+            value.boolean = false;
+            return true;
+        }
+        if (matchLiteral("null")) {
+            value.type = JsonValue::Type::NUL;
+            return true;
+        }
+        return parseNumber(value);
+    }
+
+    bool parseObject(JsonValue& value, int depth) {
+        value.type = JsonValue::Type::OBJECT;
+        m_pos++; // '{'
+        if (consume('}')) {
+            return true;
+        }
+
+        do {
+            skipWhitespace();
+            std::string key;
+            if (m_pos >= m_text.size() || m_text[m_pos] != '"' || !parseString(key)) {
+                return m_error.empty() ? fail("expected object key") : false;
+            }
+            if (!consume(':')) {
+                return fail("expected ':'");
+            }
+            value.keys.push_back(std::move(key));
+            value.children.emplace_back();
+            if (!parseValue(value.children.back(), depth + 1)) {
+                return false;
+            }
+        } while (consume(','));
+
+        return consume('}') || fail("expected ',' or '}'");
+    }
+
+    bool parseArray(JsonValue& value, int depth) {
+        value.type = JsonValue::Type::ARRAY;
+        m_pos++; // '['
+        if (consume(']')) {
+            return true;
+        }
+
+        do {
+            value.children.emplace_back();
+            if (!parseValue(value.children.back(), depth + 1)) {
+                return false;
+            }
+        } while (consume(','));
+
+        return consume(']') || fail("expected ',' or ']'");
+    }
+
+    bool parseNumber(JsonValue& value) {
+        const char* start = m_text.c_str() + m_pos;
+        char* end = nullptr;
+        double number = std::strtod(start, &end);
+        if (end == start) {
+            return fail("unexpected character");
+        }
+        m_pos += end - start;
+        value.type = JsonValue::Type::NUMBER;
+        value.number = number;
+        return true;
+    }
+
+    bool parseHex4(unsigned& codepoint) {
+        if (m_pos + 4 > m_text.size()) {
+            return fail("truncated \\u escape");
+        }
+        codepoint = 0;
+        for (int i = 0; i < 4; i++) {
+            char c = m_text[m_pos++];
+            codepoint <<= 4;
+            if (c >= '0' && c <= '9') {
+                codepoint |= c - '0';
+            } else if (c >= 'a' && c <= 'f') {
+                codepoint |= c - 'a' + 10;
+            } else if (c >= 'A' && c <= 'F') {
+                codepoint |= c - 'A' + 10;
+            } else {
+                return fail("invalid \\u escape");
+            }
+        }
+        return true;
+    }
+
+    bool parseString(std::string& out) {
+        m_pos++; // opening quote
+        while (m_pos < m_text.size()) {
+            char c = m_text[m_pos++];
+            if (c == '"') {
+                return true;
+            }
+            if (c != '\\') {
+                out += c;
+                continue;
+            }
+
+            if (m_pos >= m_text.size()) {
+                break;
+            }
+            char escape = m_text[m_pos++];
+            switch (escape) {
+                case '"': out += '"'; break;
+                case '\\': out += '\\'; break;
+                case '/': out += '/'; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'n': out += '\n'; break;
+                case 'r': out += '\r'; break;
+                case 't': out += '\t'; break;
+                case 'u': {
+                    unsigned codepoint;
+                    if (!parseHex4(codepoint)) {
+                        return false;
+                    }
+                    // Surrogate pair
+                    if (codepoint >= 0xD800 && codepoint < 0xDC00 && matchLiteral("\\u")) {
+                        unsigned low;
+                        if (!parseHex4(low)) {
+                            return false;
+                        }
+                        codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (low - 0xDC00);
+                    }
+                    appendUtf8(out, codepoint);
+                    break;
+                }
+                default:
+                    return fail("invalid escape");
+            }
+        }
+        return fail("unterminated string");
+    }
+};
+
+} // namespace
+
+const JsonValue* JsonValue::find(const std::string& key) const {
+    for (size_t i = 0; i < keys.size(); i++) {
+        if (keys[i] == key) {
+            return &children[i];
+        }
+    }
+    return nullptr;
+}
+
+std::string JsonValue::getString(const std::string& key, const std::string& fallback) const {
+    const JsonValue* value = find(key);
+    return (value && value->type == Type::STRING) ? value->string : fallback;
+}
+
+double JsonValue::getNumber(const std::string& key, double fallback) const {
+    const JsonValue* value = find(key);
+    return (value && value->type == Type::NUMBER) ? value->number : fallback;
+}
+
+int JsonValue::getInt(const std::string& key, int fallback) const {
+    return static_cast<int>(getNumber(key, fallback));
+}
+
+bool JsonValue::getBool(const std::string& key, bool fallback) const {
+    const JsonValue* value = find(key);
+    return (value && value->type == Type::BOOL) ? value->boolean : fallback;
+}
+
+bool parseJson(const std::string& text, JsonValue& result, std::string& error) {
+    result = JsonValue();
+    JsonReader reader(text);
+    return reader.parseDocument(result, error);
+}
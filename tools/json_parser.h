@@ -0,0 +1,31 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// Minimal JSON document model for the offline map tools.
+// Objects keep their members in file order (keys[i] names children[i]).
+struct JsonValue {
+    enum class Type { NUL, BOOL, NUMBER, STRING, ARRAY, OBJECT };
+
+    Type type = Type::NUL;
+    bool boolean = false;
+    double number = 0.0;
+    std::string string;
+    std::vector<std::string> keys;      // OBJECT
+    std::vector<JsonValue> children;    // ARRAY elements or OBJECT values
+
+    bool isObject() const { return type == Type::OBJECT; }
+    bool isArray() const { return type == Type::ARRAY; }
+
+    // Member lookup on objects, nullptr if missing
+    const JsonValue* find(const std::string& key) const;
+
+    std::string getString(const std::string& key, const std::string& fallback = "") const;
+    double getNumber(const std::string& key, double fallback = 0.0) const;
+    int getInt(const std::string& key, int fallback = 0) const;
+    bool getBool(const std::string& key, bool fallback = false) const;
+};
+
+// Returns false and sets error (with line number) on malformed input
+bool parseJson(const std::string& text, JsonValue& result, std::string& error);
@@ -0,0 +1,209 @@
+// Pathfinding benchmark
+// Generates a world with MapGenerator and times long routes between random walkable
+// tiles: plain A* over the whole map against the hierarchical search, cold (clusters
+// built on demand) and warm. Then blocks tiles along a route and times the repair, and
+// solves the routes through PathQueryQueue's workers. Finally compares a crowd sharing
+// one flow field against one A* per agent.
+//
+// Usage: path_bench [mapSize] [queries] [seed] [workers]
+#include "flow_field.h"
+#include "map_generator.h"
+#include "path_query_queue.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double microsecondsSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+}
+
+TilePoint randomWalkableTile(const Tilemap& map, uint64_t& state) {
+    while (true) {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        int x = static_cast<int>((state >> 33) % map.getWidth());
+        int y = static_cast<int>((state >> 13) % map.getHeight());
+        if (map.isWalkable(x, y)) {
+            return {x, y};
+        }
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    MapGeneratorSettings settings;
+    settings.width = (argc > 1) ? std::atoi(argv[1]) : 2048;
+    settings.height = settings.width;
+    int queries = (argc > 2) ? std::atoi(argv[2]) : 50;
+    settings.seed = (argc > 3) ? std::strtoull(argv[3], nullptr, 10) : 1;
+    int workers = (argc > 4) ? std::atoi(argv[4]) : PathQueryQueue::DEFAULT_WORKER_COUNT;
+    if (settings.width <= 0 || queries <= 0 || workers <= 0) {
+        std::fprintf(stderr, "Usage: %s [mapSize] [queries] [seed] [workers]\n", argv[0]);
+        return 1;
+    }
+
+    MapGenerator generator(settings);
+    std::unique_ptr<Tilemap> map = generator.generate();
+    std::printf("Map %dx%d, seed %llu\n", map->getWidth(), map->getHeight(),
+                static_cast<unsigned long long>(settings.seed));
+
+    // Pairs at least a quarter of the map apart
+    std::vector<std::pair<TilePoint, TilePoint>> routes;
+    uint64_t state = settings.seed;
+    while (static_cast<int>(routes.size()) < queries) {
+        TilePoint start = randomWalkableTile(*map, state);
+        TilePoint goal = randomWalkableTile(*map, state);
+        if (std::abs(start.x - goal.x) + std::abs(start.y - goal.y) >= settings.width / 4) {
+            routes.push_back({start, goal});
+        }
+    }
+
+    Pathfinder pathfinder(*map);
+    std::vector<TilePoint> path;
+    std::vector<int> hierarchicalLengths;
+
+    const char* passes[] = {"HPA* cold", "HPA* warm"};
+    for (const char* pass : passes) {
+        double total = 0.0;
+        long long expanded = 0;
+        int found = 0;
+        hierarchicalLengths.clear();
+        std::vector<double> times;
+        for (const auto& route : routes) {
+            Clock::time_point start = Clock::now();
+            bool ok = pathfinder.findPath(route.first, route.second, path);
+            times.push_back(microsecondsSince(start));
+            total += times.back();
+            expanded += pathfinder.getLastExpandedNodes();
+            found += ok ? 1 : 0;
+            hierarchicalLengths.push_back(ok ? static_cast<int>(path.size()) : -1);
+        }
+        std::sort(times.begin(), times.end());
+        std::printf("%-10s %10.1f us/route (median %.1f)  %8lld nodes/route  %d/%d found  %d clusters built\n", pass,
+                    total / routes.size(), times[times.size() / 2], expanded / static_cast<long long>(routes.size()), found,
+                    static_cast<int>(routes.size()), pathfinder.getBuiltClusterCount());
+    }
+
+    // Plain A* is exact, so it also measures how far the hierarchical routes are off
+    {
+        double total = 0.0;
+        long long expanded = 0;
+        long long exactLength = 0;
+        long long hierarchicalLength = 0;
+        int mismatches = 0;
+        for (size_t i = 0; i < routes.size(); i++) {
+            Clock::time_point start = Clock::now();
+            bool ok = pathfinder.findPathInArea(routes[i].first, routes[i].second, 0, 0, map->getWidth(),
+                                                map->getHeight(), path);
+            total += microsecondsSince(start);
+            expanded += pathfinder.getLastExpandedNodes();
+            if (ok != (hierarchicalLengths[i] >= 0)) {
+                mismatches++;
+            } else if (ok) {
+                exactLength += static_cast<long long>(path.size());
+                hierarchicalLength += hierarchicalLengths[i];
+            }
+        }
+        std::printf("%-10s %10.1f us/route  %8lld nodes/route  HPA* routes %.1f%% longer, %d reachability mismatches\n",
+                    "A*", total / routes.size(), expanded / static_cast<long long>(routes.size()),
+                    exactLength > 0 ? 100.0 * (hierarchicalLength - exactLength) / exactLength : 0.0, mismatches);
+    }
+
+    // Wall off a tile in the middle of each route; only the clusters around it rebuild
+    {
+        double repair = 0.0;
+        int repaired = 0;
+        for (const auto& route : routes) {
+            if (!pathfinder.findPath(route.first, route.second, path) || path.size() < 3) {
+                continue;
+            }
+            TilePoint blocked = path[path.size() / 2];
+            map->setTile(blocked.x, blocked.y, 1, MapLayer::DECORATION);
+            Clock::time_point start = Clock::now();
+            pathfinder.findPath(route.first, route.second, path);
+            repair += microsecondsSince(start);
+            repaired++;
+            map->setTile(blocked.x, blocked.y, -1, MapLayer::DECORATION);
+        }
+        if (repaired > 0) {
+            std::printf("%-10s %10.1f us/route after blocking a tile on it\n", "Repair", repair / repaired);
+        }
+    }
+
+    // All routes requested at once, as a crowd of NPCs would, with ~1 ms frames. The
+    // longest beginFrame() is what the main thread pays; routes must match the above.
+    {
+        PathQueryQueue queue(*map, workers);
+        Clock::time_point start = Clock::now();
+        std::vector<PathHandle> handles;
+        for (const auto& route : routes) {
+            handles.push_back(queue.request(route.first, route.second));
+        }
+        double longestFrame = 0.0;
+        int frames = 0;
+        int mismatches = 0;
+        while (queue.getPendingCount() > 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            Clock::time_point frame = Clock::now();
+            queue.beginFrame();
+            longestFrame = std::max(longestFrame, microsecondsSince(frame));
+            frames++;
+            for (size_t i = 0; i < handles.size(); i++) {
+                if (handles[i] != INVALID_PATH_HANDLE && queue.getStatus(handles[i]) != PathStatus::PENDING) {
+                    bool ok = queue.takePath(handles[i], path);
+                    mismatches += (ok ? static_cast<int>(path.size()) : -1) != hierarchicalLengths[i] ? 1 : 0;
+                    handles[i] = INVALID_PATH_HANDLE;
+                }
+            }
+        }
+        std::printf("%-10s %10.1f us/route over %d workers, %d frames, longest beginFrame %.1f us, %d mismatches\n",
+                    "Queued", microsecondsSince(start) / routes.size(), queue.getWorkerCount(), frames, longestFrame,
+                    mismatches);
+    }
+
+    // A crowd of agents within a flow field's radius of one goal, each walking to it
+    {
+        TilePoint goal = routes.front().first;
+        std::vector<TilePoint> agents;
+        while (static_cast<int>(agents.size()) < queries) {
+            TilePoint agent = randomWalkableTile(*map, state);
+            if (std::abs(agent.x - goal.x) <= FlowField::DEFAULT_RADIUS &&
+                std::abs(agent.y - goal.y) <= FlowField::DEFAULT_RADIUS) {
+                agents.push_back(agent);
+            }
+        }
+
+        Clock::time_point start = Clock::now();
+        FlowField field(*map, goal);
+        double build = microsecondsSince(start);
+        start = Clock::now();
+        long long steps = 0;
+        for (TilePoint agent : agents) {
+            int dx = 0, dy = 0;
+            while (field.getStep(agent.x, agent.y, dx, dy)) {
+                agent.x += dx;
+                agent.y += dy;
+                steps++;
+            }
+        }
+        double walk = microsecondsSince(start);
+
+        start = Clock::now();
+        long long pathSteps = 0;
+        for (TilePoint agent : agents) {
+            if (pathfinder.findPath(agent, goal, path)) {
+                pathSteps += static_cast<long long>(path.size());
+            }
+        }
+        double search = microsecondsSince(start);
+        std::printf("%-10s %10.1f us build + %.1f us for %d agents to walk %lld steps (A* per agent: %.1f us, %lld steps)\n",
+                    "Flow field", build, walk, static_cast<int>(agents.size()), steps, search, pathSteps);
+    }
+    return 0;
+}
@@ -0,0 +1,593 @@
+// tiled_importer - cooks a Tiled map (JSON .tmj/.json or XML .tmx) into the binary .jmap format
+//
+// Usage: tiled_importer <map.tmj|map.tmx> <output.jmap>
+//
+// Tile layers named "ground", "decoration" or "overlay" (any case) go to that engine layer;
+// other tile layers use their position (first = ground, second = decoration, third = overlay).
+// Layers that land on the same engine layer are merged and empty cells never overwrite.
+// Group layers are flattened.
+//
+// All tilesets are treated as one continuous tile sheet: tile ID = gid - firstgid of the
+// first tileset. Boolean tile properties named blocking, encounter, damage or trigger
+// become TileFlags; tiles without them have no flags.
+//
+// Objects keep their type ("class" in Tiled 1.9+), name and custom properties. Positions
+// and sizes are converted to tiles (rounded outwards, at least one tile).
+//
+// Layer data must be CSV, uncompressed base64 or plain <tile> elements. Compressed layer
+// data and infinite maps are rejected.
+#include "tilemap.h"
+#include "json_parser.h"
+#include "xml_parser.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Top bits of a gid hold the flip/rotation flags
+constexpr uint32_t GID_MASK = 0x0FFFFFFF;
+
+struct TiledTileset {
+    int firstGid = 1;
+    std::vector<std::pair<int, uint8_t>> tileFlags; // Local tile ID -> TileFlag mask
+};
+
+struct TiledLayer {
+    std::string name;
+    std::vector<uint32_t> gids;
+};
+
+struct TiledMap {
+    int width = 0;
+    int height = 0;
+    int tileWidth = 0;
+    int tileHeight = 0;
+    std::vector<TiledTileset> tilesets;
+    std::vector<TiledLayer> layers;
+    std::vector<MapObject> objects;
+};
+
+bool readFile(const std::string& path, std::string& contents) {
+    std::ifstream input(path, std::ios::binary);
+    if (!input) {
+        return false;
+    }
+    std::ostringstream buffer;
+    buffer << input.rdbuf();
+    contents = buffer.str();
+    return true;
+}
+
+std::string directoryOf(const std::string& path) {
+    size_t slash = path.find_last_of("/\\");
+    return slash == std::string::npos ? "" : path.substr(0, slash + 1);
+}
+
+std::string toLower(std::string text) {
+    std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) { return std::tolower(c); });
+    return text;
+}
+
+bool endsWith(const std::string& text, const std::string& suffix) {
+    return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+std::string formatNumber(double value) {
+    char buffer[32];
+    if (value == std::floor(value) && std::fabs(value) < 1e15) {
+        std::snprintf(buffer, sizeof(buffer), "%.0f", value);
+    } else {
+        std::snprintf(buffer, sizeof(buffer), "%g", value);
+    }
+    return buffer;
+}
+
+bool decodeBase64(const std::string& text, std::vector<uint8_t>& bytes) {
+    uint32_t accumulator = 0;
+    int bits = 0;
+    for (char c : text) {
+        int value;
+        if (c >= 'A' && c <= 'Z') {
+            value = c - 'A';
+        } else if (c >= 'a' && c <= 'z') {
+            value = c - 'a' + 26;
+        } else if (c >= '0' && c <= '9') {
+            value = c - '0' + 52;
+        } else if (c == '+') {
+            value = 62;
+        } else if (c == '/') {
+            value = 63;
+        } else if (c == '=' || std::isspace(static_cast<unsigned char>(c))) {
+            continue;
+        } else {
+            return false;
+        }
+
+        accumulator = (accumulator << 6) | value;
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            bytes.push_back(static_cast<uint8_t>(accumulator >> bits));
+        }
+    }
+    return true;
+}
+
+// Layer data encoded as base64 little-endian uint32 gids
+bool decodeBase64Gids(const std::string& text, const std::string& compression,
+                      std::vector<uint32_t>& gids, std::string& error) {
+    if (!compression.empty()) {
+        error = "compressed layer data (" + compression + ") is not supported, save with CSV or uncompressed base64";
+        return false;
+    }
+    std::vector<uint8_t> bytes;
+    if (!decodeBase64(text, bytes) || bytes.size() % 4 != 0) {
+        error = "invalid base64 layer data";
+        return false;
+    }
+    for (size_t i = 0; i < bytes.size(); i += 4) {
+        gids.push_back(bytes[i] | (bytes[i + 1] << 8) | (bytes[i + 2] << 16) | (uint32_t(bytes[i + 3]) << 24));
+    }
+    return true;
+}
+
+bool parseCsvGids(const std::string& text, std::vector<uint32_t>& gids, std::string& error) {
+    std::string field;
+    std::istringstream input(text);
+    while (std::getline(input, field, ',')) {
+        size_t start = field.find_first_not_of(" \t\r\n");
+        if (start == std::string::npos) {
+            continue;
+        }
+        size_t end = field.find_last_not_of(" \t\r\n");
+        std::string number = field.substr(start, end - start + 1);
+        char* parsedEnd = nullptr;
+        unsigned long gid = std::strtoul(number.c_str(), &parsedEnd, 10);
+        if (*parsedEnd != '\0') {
+            error = "invalid CSV layer data '" + number + "'";
+            return false;
+        }
+        gids.push_back(static_cast<uint32_t>(gid));
+    }
+    return true;
+}
+
+// Tile objects are anchored at their bottom-left corner, everything else at the top-left
+MapObject makeObject(const TiledMap& map, const std::string& type, const std::string& name,
+                     double x, double y, double width, double height, bool tileObject) {
+    if (tileObject) {
+        y -= height;
+    }
+
+    MapObject object;
+    object.type = type;
+    object.name = name;
+    object.x = static_cast<int>(std::floor(x / map.tileWidth));
+    object.y = static_cast<int>(std::floor(y / map.tileHeight));
+    object.width = std::max(1, static_cast<int>(std::ceil((x + width) / map.tileWidth)) - object.x);
+    object.height = std::max(1, static_cast<int>(std::ceil((y + height) / map.tileHeight)) - object.y);
+    return object;
+}
+
+void addTileFlag(TiledTileset& tileset, int tileId, const std::string& propertyName, bool value) {
+    uint8_t flag;
+    if (!value || !TileProperties::flagFromName(propertyName, flag)) {
+        return;
+    }
+    for (auto& entry : tileset.tileFlags) {
+        if (entry.first == tileId) {
+            entry.second |= flag;
+            return;
+        }
+    }
+    tileset.tileFlags.emplace_back(tileId, flag);
+}
+
+// --- Tiled JSON ---
+
+std::string jsonPropertyValue(const JsonValue& value) {
+    switch (value.type) {
+        case JsonValue::Type::BOOL:
+            return value.boolean ? "true" : "false";
+        case JsonValue::Type::NUMBER:
+            return formatNumber(value.number);
+        case JsonValue::Type::STRING:
+            return value.string;
+        default:
+            return "";
+    }
+}
+
+void readJsonTileset(const JsonValue& json, TiledTileset& tileset) {
+    const JsonValue* tiles = json.find("tiles");
+    if (!tiles || !tiles->isArray()) {
+        return;
+    }
+    for (const JsonValue& tile : tiles->children) {
+        const JsonValue* properties = tile.find("properties");
+        if (!properties || !properties->isArray()) {
+            continue;
+        }
+        for (const JsonValue& property : properties->children) {
+            const JsonValue* value = property.find("value");
+            if (value && value->type == JsonValue::Type::BOOL) {
+                addTileFlag(tileset, tile.getInt("id"), property.getString("name"), value->boolean);
+            }
+        }
+    }
+}
+
+bool importJsonLayers(const JsonValue& layers, TiledMap& map, std::string& error) {
+    for (const JsonValue& layer : layers.children) {
+        std::string type = layer.getString("type");
+        if (type == "tilelayer") {
+            TiledLayer tileLayer;
+            tileLayer.name = layer.getString("name");
+            const JsonValue* data = layer.find("data");
+            if (!data) {
+                error = "tile layer '" + tileLayer.name + "' has no data";
+                return false;
+            }
+            if (data->isArray()) {
+                for (const JsonValue& gid : data->children) {
+                    tileLayer.gids.push_back(static_cast<uint32_t>(gid.number));
+                }
+            } else if (!decodeBase64Gids(data->string, layer.getString("compression"), tileLayer.gids, error)) {
+                return false;
+            }
+            map.layers.push_back(std::move(tileLayer));
+        } else if (type == "objectgroup") {
+            const JsonValue* objects = layer.find("objects");
+            if (!objects || !objects->isArray()) {
+                continue;
+            }
+            for (const JsonValue& json : objects->children) {
+                std::string objectType = json.getString("type", json.getString("class"));
+                MapObject object = makeObject(map, objectType, json.getString("name"),
+                                              json.getNumber("x"), json.getNumber("y"),
+                                              json.getNumber("width"), json.getNumber("height"),
+                                              json.find("gid") != nullptr);
+                const JsonValue* properties = json.find("properties");
+                if (properties && properties->isArray()) {
+                    for (const JsonValue& property : properties->children) {
+                        const JsonValue* value = property.find("value");
+                        object.setProperty(property.getString("name"), value ? jsonPropertyValue(*value) : "");
+                    }
+                }
+                map.objects.push_back(std::move(object));
+            }
+        } else if (type == "group") {
+            const JsonValue* children = layer.find("layers");
+            if (children && !importJsonLayers(*children, map, error)) {
+                return false;
+            }
+        }
+        // Image layers have nothing to import
+    }
+    return true;
+}
+
+void readXmlTileset(const XmlElement& element, TiledTileset& tileset);
+
+bool importJsonMap(const std::string& path, const std::string& text, TiledMap& map, std::string& error) {
+    JsonValue json;
+    if (!parseJson(text, json, error)) {
+        return false;
+    }
+    if (json.getBool("infinite")) {
+        error = "infinite maps are not supported";
+        return false;
+    }
+
+    map.width = json.getInt("width");
+    map.height = json.getInt("height");
+    map.tileWidth = json.getInt("tilewidth");
+    map.tileHeight = json.getInt("tileheight");
+    if (map.width <= 0 || map.height <= 0 || map.tileWidth <= 0 || map.tileHeight <= 0) {
+        error = "missing or invalid map size";
+        return false;
+    }
+
+    const JsonValue* tilesets = json.find("tilesets");
+    if (tilesets && tilesets->isArray()) {
+        for (const JsonValue& entry : tilesets->children) {
+            TiledTileset tileset;
+            tileset.firstGid = entry.getInt("firstgid", 1);
+
+            std::string source = entry.getString("source");
+            if (source.empty()) {
+                readJsonTileset(entry, tileset);
+            } else {
+                std::string sourcePath = directoryOf(path) + source;
+                std::string sourceText;
+                if (!readFile(sourcePath, sourceText)) {
+                    error = "failed to open tileset " + sourcePath;
+                    return false;
+                }
+                if (endsWith(toLower(source), ".tsx")) {
+                    XmlElement element;
+                    if (!parseXml(sourceText, element, error)) {
+                        error = sourcePath + ": " + error;
+                        return false;
+                    }
+                    readXmlTileset(element, tileset);
+                } else {
+                    JsonValue external;
+                    if (!parseJson(sourceText, external, error)) {
+                        error = sourcePath + ": " + error;
+                        return false;
+                    }
+                    readJsonTileset(external, tileset);
+                }
+            }
+            map.tilesets.push_back(std::move(tileset));
+        }
+    }
+
+    const JsonValue* layers = json.find("layers");
+    return !layers || importJsonLayers(*layers, map, error);
+}
+
+// --- Tiled XML (TMX/TSX) ---
+
+std::string xmlPropertyValue(const XmlElement& property) {
+    const std::string* value = property.findAttribute("value");
+    return value ? *value : property.text; // Multi-line strings are stored as text
+}
+
+void readXmlTileset(const XmlElement& element, TiledTileset& tileset) {
+    for (const XmlElement& tile : element.children) {
+        if (tile.name != "tile") {
+            continue;
+        }
+        const XmlElement* properties = tile.findChild("properties");
+        if (!properties) {
+            continue;
+        }
+        for (const XmlElement& property : properties->children) {
+            if (property.getAttribute("type") == "bool") {
+                addTileFlag(tileset, tile.getIntAttribute("id"), property.getAttribute("name"),
+                            xmlPropertyValue(property) == "true");
+            }
+        }
+    }
+}
+
+bool readXmlLayerData(const XmlElement& layer, TiledLayer& tileLayer, std::string& error) {
+    const XmlElement* data = layer.findChild("data");
+    if (!data) {
+        error = "tile layer '" + tileLayer.name + "' has no data";
+        return false;
+    }
+    if (data->findChild("chunk")) {
+        error = "infinite maps are not supported";
+        return false;
+    }
+
+    std::string encoding = data->getAttribute("encoding");
+    if (encoding == "csv") {
+        return parseCsvGids(data->text, tileLayer.gids, error);
+    }
+    if (encoding == "base64") {
+        return decodeBase64Gids(data->text, data->getAttribute("compression"), tileLayer.gids, error);
+    }
+    if (!encoding.empty()) {
+        error = "unknown layer encoding '" + encoding + "'";
+        return false;
+    }
+    for (const XmlElement& tile : data->children) {
+        if (tile.name == "tile") {
+            tileLayer.gids.push_back(static_cast<uint32_t>(std::strtoul(tile.getAttribute("gid", "0").c_str(), nullptr, 10)));
+        }
+    }
+    return true;
+}
+
+bool importXmlLayers(const XmlElement& parent, TiledMap& map, std::string& error) {
+    for (const XmlElement& element : parent.children) {
+        if (element.name == "layer") {
+            TiledLayer tileLayer;
+            tileLayer.name = element.getAttribute("name");
+            if (!readXmlLayerData(element, tileLayer, error)) {
+                return false;
+            }
+            map.layers.push_back(std::move(tileLayer));
+        } else if (element.name == "objectgroup") {
+            for (const XmlElement& child : element.children) {
+                if (child.name != "object") {
+                    continue;
+                }
+                std::string objectType = child.getAttribute("type", child.getAttribute("class"));
+                MapObject object = makeObject(map, objectType, child.getAttribute("name"),
+                                              child.getDoubleAttribute("x"), child.getDoubleAttribute("y"),
+                                              child.getDoubleAttribute("width"), child.getDoubleAttribute("height"),
+                                              child.findAttribute("gid") != nullptr);
+                if (const XmlElement* properties = child.findChild("properties")) {
+                    for (const XmlElement& property : properties->children) {
+                        object.setProperty(property.getAttribute("name"), xmlPropertyValue(property));
+                    }
+                }
+                map.objects.push_back(std::move(object));
+            }
+        } else if (element.name == "group") {
+            if (!importXmlLayers(element, map, error)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool importXmlMap(const std::string& path, const std::string& text, TiledMap& map, std::string& error) {
+    XmlElement root;
+    if (!parseXml(text, root, error)) {
+        return false;
+    }
+    if (root.name != "map") {
+        error = "root element is <" + root.name + ">, expected <map>";
+        return false;
+    }
+    if (root.getIntAttribute("infinite") != 0) {
+        error = "infinite maps are not supported";
+        return false;
+    }
+
+    map.width = root.getIntAttribute("width");
+    map.height = root.getIntAttribute("height");
+    map.tileWidth = root.getIntAttribute("tilewidth");
+    map.tileHeight = root.getIntAttribute("tileheight");
+    if (map.width <= 0 || map.height <= 0 || map.tileWidth <= 0 || map.tileHeight <= 0) {
+        error = "missing or invalid map size";
+        return false;
+    }
+
+    for (const XmlElement& element : root.children) {
+        if (element.name != "tileset") {
+            continue;
+        }
+        TiledTileset tileset;
+        tileset.firstGid = element.getIntAttribute("firstgid", 1);
+
+        std::string source = element.getAttribute("source");
+        if (source.empty()) {
+            readXmlTileset(element, tileset);
+        } else {
+            std::string sourcePath = directoryOf(path) + source;
+            std::string sourceText;
+            XmlElement external;
+            if (!readFile(sourcePath, sourceText)) {
+                error = "failed to open tileset " + sourcePath;
+                return false;
+            }
+            if (!parseXml(sourceText, external, error)) {
+                error = sourcePath + ": " + error;
+                return false;
+            }
+            readXmlTileset(external, tileset);
+        }
+        map.tilesets.push_back(std::move(tileset));
+    }
+
+    return importXmlLayers(root, map, error);
+}
+
+// --- Conversion to the engine map ---
+
+MapLayer engineLayerFor(const std::string& name, int position) {
+    std::string lower = toLower(name);
+    if (lower == "ground") {
+        return MapLayer::GROUND;
+    }
+    if (lower == "decoration") {
+        return MapLayer::DECORATION;
+    }
+    if (lower == "overlay") {
+        return MapLayer::OVERLAY;
+    }
+    return static_cast<MapLayer>(position);
+}
+
+bool buildTilemap(const TiledMap& tiled, Tilemap& map, std::string& error) {
+    std::vector<TiledTileset> tilesets = tiled.tilesets;
+    std::sort(tilesets.begin(), tilesets.end(),
+              [](const TiledTileset& a, const TiledTileset& b) { return a.firstGid < b.firstGid; });
+    int baseGid = tilesets.empty() ? 1 : tilesets.front().firstGid;
+
+    TileProperties properties;
+    properties.clear();
+    for (const TiledTileset& tileset : tilesets) {
+        for (const auto& entry : tileset.tileFlags) {
+            properties.setFlags(static_cast<TileId>(tileset.firstGid - baseGid + entry.first), entry.second);
+        }
+    }
+    map.setTileProperties(properties);
+
+    size_t cellCount = static_cast<size_t>(tiled.width) * tiled.height;
+    bool warnedFlipped = false;
+    for (size_t i = 0; i < tiled.layers.size(); i++) {
+        const TiledLayer& layer = tiled.layers[i];
+        if (layer.gids.size() != cellCount) {
+            error = "tile layer '" + layer.name + "' has " + std::to_string(layer.gids.size()) +
+                    " tiles, expected " + std::to_string(cellCount);
+            return false;
+        }
+
+        MapLayer target = engineLayerFor(layer.name, static_cast<int>(i));
+        if (static_cast<int>(target) >= Tilemap::LAYER_COUNT) {
+            error = "tile layer '" + layer.name + "' has no engine layer, name it ground, decoration or overlay";
+            return false;
+        }
+
+        for (size_t cell = 0; cell < cellCount; cell++) {
+            uint32_t gid = layer.gids[cell] & GID_MASK;
+            if (gid == 0) {
+                continue;
+            }
+            if (gid != layer.gids[cell] && !warnedFlipped) {
+                std::cerr << "Warning: flipped/rotated tiles are imported unflipped" << std::endl;
+                warnedFlipped = true;
+            }
+            if (gid < static_cast<uint32_t>(baseGid) || gid - baseGid >= Tilemap::EMPTY_TILE) {
+                error = "tile layer '" + layer.name + "' uses unknown gid " + std::to_string(gid);
+                return false;
+            }
+            map.setTile(static_cast<int>(cell % tiled.width), static_cast<int>(cell / tiled.width),
+                        static_cast<int>(gid - baseGid), target);
+        }
+    }
+
+    for (const MapObject& object : tiled.objects) {
+        map.addObject(object);
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " <map.tmj|map.tmx> <output.jmap>" << std::endl;
+        return 1;
+    }
+
+    std::string path = argv[1];
+    std::string text;
+    if (!readFile(path, text)) {
+        std::cerr << "Failed to open " << path << std::endl;
+        return 1;
+    }
+
+    TiledMap tiled;
+    std::string error;
+    bool xml = endsWith(toLower(path), ".tmx");
+    if (!(xml ? importXmlMap(path, text, tiled, error) : importJsonMap(path, text, tiled, error))) {
+        std::cerr << path << ": " << error << std::endl;
+        return 1;
+    }
+
+    if (tiled.tileWidth != tiled.tileHeight) {
+        std::cerr << "Warning: " << path << " has non-square tiles, using the tile width" << std::endl;
+    }
+
+    Tilemap map(tiled.width, tiled.height, tiled.tileWidth);
+    if (!buildTilemap(tiled, map, error)) {
+        std::cerr << path << ": " << error << std::endl;
+        return 1;
+    }
+
+    map.compact();
+    if (!map.saveToFile(argv[2])) {
+        return 1;
+    }
+
+    std::cout << "Wrote " << argv[2] << " (" << tiled.width << "x" << tiled.height << ", "
+              << tiled.layers.size() << " tile layers, " << tiled.objects.size() << " objects)" << std::endl;
+    return 0;
+}
@@ -0,0 +1,178 @@
+// Tilemap render benchmark
+// Renders maps of increasing size through a fixed 800x600 camera and reports the
+// per-frame draw call count and average frame time for each render mode. With
+// viewport culling both numbers should stay flat regardless of map size.
+// Also checks that a streamed map keeps tiles set before their chunk was loaded.
+#include "tilemap.h"
+#include "camera.h"
+#include "chunk_streamer.h"
+#include "draw_stats.h"
+#include <raylib.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+constexpr int SCREEN_WIDTH = 800;
+constexpr int SCREEN_HEIGHT = 600;
+constexpr int TILE_SIZE = 32;
+
+struct MapSize {
+    int width;
+    int height;
+};
+
+struct RenderModeInfo {
+    TileRenderMode mode;
+    const char* name;
+};
+
+void fillTestPattern(Tilemap& map) {
+    for (int y = 0; y < map.getHeight(); y++) {
+        for (int x = 0; x < map.getWidth(); x++) {
+            if (x == 0 || y == 0 || x == map.getWidth() - 1 || y == map.getHeight() - 1) {
+                map.setTile(x, y, 1); // Wall
+            } else if ((x / 7 + y / 5) % 11 == 0) {
+                map.setTile(x, y, 2); // Water
+            } else if (y % 16 == 0) {
+                map.setTile(x, y, 3); // Path
+            }
+        }
+    }
+}
+
+// Edits tiles of a STREAMED map before any chunk is loaded, streams every chunk in and
+// counts the tiles that differ from the file (other than the edits themselves)
+int checkStreamedEdits() {
+    const char* path = "tilemap_bench_stream.jmap";
+    Tilemap source(256, 256, TILE_SIZE);
+    fillTestPattern(source);
+    source.compact();
+    if (!source.saveToFile(path)) {
+        return -1;
+    }
+
+    auto reference = Tilemap::loadFromFile(path);
+    auto streamed = Tilemap::loadFromFile(path, MapLoadMode::STREAMED);
+    if (!reference || !streamed) {
+        std::remove(path);
+        return -1;
+    }
+
+    struct Edit {
+        int x;
+        int y;
+        int tile;
+        MapLayer layer;
+    };
+    const Edit edits[] = {
+        {40, 40, 5, MapLayer::GROUND},
+        {41, 40, 4, MapLayer::DECORATION},
+        {200, 130, 2, MapLayer::GROUND}
+    };
+    for (const Edit& edit : edits) {
+        streamed->setTile(edit.x, edit.y, edit.tile, edit.layer);
+    }
+
+    int mismatches = 0;
+    {
+        ChunkStreamer streamer(*streamed, path);
+        streamer.setStreamRadius(std::max(streamed->getChunksX(), streamed->getChunksY()));
+        int chunkCount = streamed->getChunksX() * streamed->getChunksY();
+        while (streamer.getResidentChunkCount() < chunkCount) {
+            streamer.update(0, 0, 0, 0);
+            streamer.flush();
+        }
+
+        for (int layer = 0; layer < Tilemap::LAYER_COUNT; layer++) {
+            MapLayer mapLayer = static_cast<MapLayer>(layer);
+            for (int y = 0; y < streamed->getHeight(); y++) {
+                for (int x = 0; x < streamed->getWidth(); x++) {
+                    int expected = reference->getTile(x, y, mapLayer);
+                    for (const Edit& edit : edits) {
+                        if (edit.x == x && edit.y == y && edit.layer == mapLayer) {
+                            expected = edit.tile;
+                        }
+                    }
+                    mismatches += streamed->getTile(x, y, mapLayer) != expected ? 1 : 0;
+                }
+            }
+        }
+    }
+
+    std::remove(path);
+    return mismatches;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int frames = (argc > 1) ? std::atoi(argv[1]) : 300;
+    if (frames <= 0) {
+        frames = 300;
+    }
+
+    SetConfigFlags(FLAG_WINDOW_HIDDEN);
+    InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "Tilemap Benchmark");
+    SetTargetFPS(0);
+
+    const MapSize sizes[] = {
+        {30, 20},
+        {256, 256},
+        {1024, 1024},
+        {4096, 4096}
+    };
+
+    const RenderModeInfo modes[] = {
+        {TileRenderMode::IMMEDIATE, "immediate"},
+        {TileRenderMode::BAKED_CHUNKS, "baked"},
+        {TileRenderMode::BATCHED_MESH, "mesh"}
+    };
+
+    // "draws" counts draw requests, "batches" the GPU calls left after raylib's batching
+    std::printf("%-12s %-10s %12s %10s %14s %12s\n", "map", "mode", "draws", "batches", "frame (ms)", "bytes/tile");
+
+    for (const MapSize& size : sizes) {
+        Tilemap map(size.width, size.height, TILE_SIZE);
+        fillTestPattern(map);
+        map.compact();
+
+        GameCamera camera(SCREEN_WIDTH, SCREEN_HEIGHT, size.width, size.height, TILE_SIZE);
+        camera.followPlayer(size.width / 2 * TILE_SIZE, size.height / 2 * TILE_SIZE, TILE_SIZE, TILE_SIZE);
+
+        for (const RenderModeInfo& modeInfo : modes) {
+            map.setRenderMode(modeInfo.mode);
+
+            auto renderFrame = [&]() {
+                BeginDrawing();
+                ClearBackground(BLACK);
+                DrawStats::beginFrame();
+                map.render(camera.getOffsetX(), camera.getOffsetY(), camera.getViewWidth(), camera.getViewHeight());
+                EndDrawing();
+            };
+
+            // Warm-up frame so one-off work (chunk baking) isn't part of the average
+            renderFrame();
+
+            double total = 0.0;
+            for (int i = 0; i < frames; i++) {
+                double start = GetTime();
+                renderFrame();
+                total += GetTime() - start;
+            }
+
+            char label[32];
+            std::snprintf(label, sizeof(label), "%dx%d", size.width, size.height);
+            DrawStats::beginFrame();
+            std::printf("%-12s %-10s %12d %10d %14.3f %12.3f\n", label, modeInfo.name, map.getLastDrawCallCount(),
+                        DrawStats::getLastFrameDrawCalls(), total * 1000.0 / frames, map.getBytesPerTile());
+        }
+    }
+
+    int mismatches = checkStreamedEdits();
+    std::printf("streamed edits: %d mismatched tiles\n", mismatches);
+
+    CloseWindow();
+    return mismatches == 0 ? 0 : 1;
+}
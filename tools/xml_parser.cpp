@@ -0,0 +1,288 @@
+#include "xml_parser.h"
+#include "utf8.h"
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+class XmlReader {
+public:
+    explicit XmlReader(const std::string& text) : m_text(text), m_pos(0) {}
+
+    bool parseDocument(XmlElement& root, std::string& error) {
+        if (!skipMisc() || !parseElement(root, 0) || !skipMisc()) {
+            error = m_error;
+            return false;
+        }
+        if (m_pos != m_text.size()) {
+            fail("content after the root element");
+            error = m_error;
+            return false;
+        }
+        return true;
+    }
+
+private:
+    static constexpr int MAX_DEPTH = 256;
+
+    const std::string& m_text;
+    size_t m_pos;
+    std::string m_error;
+
+    bool fail(const std::string& message) {
+        int line = 1;
+        for (size_t i = 0; i < m_pos && i < m_text.size(); i++) {
+            if (m_text[i] == '\n') {
+                line++;
+            }
+        }
+        m_error = "line " + std::to_string(line) + ": " + message;
+        return false;
+    }
+
+    bool startsWith(const char* prefix) const {
+        return m_text.compare(m_pos, std::strlen(prefix), prefix) == 0;
+    }
+
+    void skipWhitespace() {
+        while (m_pos < m_text.size() && isSpace(m_text[m_pos])) {
+            m_pos++;
+        }
+    }
+
+    static bool isSpace(char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n'; }
+    static bool isNameChar(char c) { return !isSpace(c) && !std::strchr("=/>\"'<", c) && c != '\0'; }
+
+    // Skips up to and including the terminator; fails if it is missing
+    bool skipPast(const char* terminator, const char* what) {
+        size_t end = m_text.find(terminator, m_pos);
+        if (end == std::string::npos) {
+            return fail(std::string("unterminated ") + what);
+        }
+        m_pos = end + std::strlen(terminator);
+        return true;
+    }
+
+    // Whitespace, comments, <?...?> and <!DOCTYPE ...> outside the root element
+    bool skipMisc() {
+        while (true) {
+            skipWhitespace();
+            if (startsWith("<!--")) {
+                if (!skipPast("-->", "comment")) {
+                    return false;
+                }
+            } else if (startsWith("<?")) {
+                if (!skipPast("?>", "processing instruction")) {
+                    return false;
+                }
+            } else if (startsWith("<!")) {
+                if (!skipPast(">", "declaration")) {
+                    return false;
+                }
+            } else {
+                return true;
+            }
+        }
+    }
+
+    bool parseName(std::string& name) {
+        size_t start = m_pos;
+        while (m_pos < m_text.size() && isNameChar(m_text[m_pos])) {
+            m_pos++;
+        }
+        if (m_pos == start) {
+            return fail("expected a name");
+        }
+        name = m_text.substr(start, m_pos - start);
+        return true;
+    }
+
+    bool appendDecoded(std::string& out, size_t start, size_t end) {
+        for (size_t i = start; i < end; i++) {
+            if (m_text[i] != '&') {
+                out += m_text[i];
+                continue;
+            }
+
+            size_t semicolon = m_text.find(';', i);
+            if (semicolon == std::string::npos || semicolon >= end) {
+                m_pos = i;
+                return fail("unterminated entity");
+            }
+            std::string entity = m_text.substr(i + 1, semicolon - i - 1);
+            if (entity == "lt") {
+                out += '<';
+            } else if (entity == "gt") {
+                out += '>';
+            } else if (entity == "amp") {
+                out += '&';
+            } else if (entity == "quot") {
+                out += '"';
+            } else if (entity == "apos") {
+                out += '\'';
+            } else if (entity.size() > 1 && entity[0] == '#') {
+                bool hex = entity[1] == 'x' || entity[1] == 'X';
+                unsigned long codepoint = std::strtoul(entity.c_str() + (hex ? 2 : 1), nullptr, hex ? 16 : 10);
+                appendUtf8(out, static_cast<unsigned>(codepoint));
+            } else {
+                m_pos = i;
+                return fail("unknown entity &" + entity + ";");
+            }
+            i = semicolon;
+        }
+        return true;
+    }
+
+    bool parseAttributes(XmlElement& element, bool& selfClosing) {
+        while (true) {
+            skipWhitespace();
+            if (m_pos >= m_text.size()) {
+                return fail("unterminated tag <" + element.name + ">");
+            }
+            if (startsWith("/>")) {
+                m_pos += 2;
+                selfClosing = true;
+                return true;
+            }
+            if (m_text[m_pos] == '>') {
+                m_pos++;
+                selfClosing = false;
+                return true;
+            }
+
+            std::string key;
+            if (!parseName(key)) {
+                return false;
+            }
+            skipWhitespace();
+            if (m_pos >= m_text.size() || m_text[m_pos] != '=') {
+                return fail("expected '=' after attribute " + key);
+            }
+            m_pos++;
+            skipWhitespace();
+            if (m_pos >= m_text.size() || (m_text[m_pos] != '"' && m_text[m_pos] != '\'')) {
+                return fail("expected quoted value for attribute " + key);
+            }
+            char quote = m_text[m_pos++];
+            size_t end = m_text.find(quote, m_pos);
+            if (end == std::string::npos) {
+                return fail("unterminated attribute " + key);
+            }
+            std::string value;
+            if (!appendDecoded(value, m_pos, end)) {
+                return false;
+            }
+            m_pos = end + 1;
+            element.attributes.emplace_back(std::move(key), std::move(value));
+        }
+    }
+
+    bool parseElement(XmlElement& element, int depth) {
+        if (depth > MAX_DEPTH) {
+            return fail("nesting too deep");
+        }
+        if (m_pos >= m_text.size() || m_text[m_pos] != '<') {
+            return fail("expected an element");
+        }
+        m_pos++;
+
+        bool selfClosing = false;
+        if (!parseName(element.name) || !parseAttributes(element, selfClosing)) {
+            return false;
+        }
+        if (selfClosing) {
+            return true;
+        }
+
+        while (m_pos < m_text.size()) {
+            if (startsWith("</")) {
+                m_pos += 2;
+                std::string closing;
+                if (!parseName(closing)) {
+                    return false;
+                }
+                if (closing != element.name) {
+                    return fail("</" + closing + "> closes <" + element.name + ">");
+                }
+                skipWhitespace();
+                if (m_pos >= m_text.size() || m_text[m_pos] != '>') {
+                    return fail("expected '>'");
+                }
+                m_pos++;
+                return true;
+            }
+
+            if (startsWith("<!--")) {
+                if (!skipPast("-->", "comment")) {
+                    return false;
+                }
+            } else if (startsWith("<![CDATA[")) {
+                size_t start = m_pos + 9;
+                if (!skipPast("]]>", "CDATA section")) {
+                    return false;
+                }
+                element.text.append(m_text, start, m_pos - 3 - start);
+            } else if (startsWith("<?")) {
+                if (!skipPast("?>", "processing instruction")) {
+                    return false;
+                }
+            } else if (m_text[m_pos] == '<') {
+                element.children.emplace_back();
+                if (!parseElement(element.children.back(), depth + 1)) {
+                    return false;
+                }
+            } else {
+                size_t end = m_text.find('<', m_pos);
+                if (end == std::string::npos) {
+                    end = m_text.size();
+                }
+                if (!appendDecoded(element.text, m_pos, end)) {
+                    return false;
+                }
+                m_pos = end;
+            }
+        }
+        return fail("missing </" + element.name + ">");
+    }
+};
+
+} // namespace
+
+const std::string* XmlElement::findAttribute(const std::string& key) const {
+    for (const auto& attribute : attributes) {
+        if (attribute.first == key) {
+            return &attribute.second;
+        }
+    }
+    return nullptr;
+}
+
+std::string XmlElement::getAttribute(const std::string& key, const std::string& fallback) const {
+    const std::string* value = findAttribute(key);
+    return value ? *value : fallback;
+}
+
+int XmlElement::getIntAttribute(const std::string& key, int fallback) const {
+    const std::string* value = findAttribute(key);
+    return value ? std::atoi(value->c_str()) : fallback;
+}
+
+double XmlElement::getDoubleAttribute(const std::string& key, double fallback) const {
+    const std::string* value = findAttribute(key);
+    return value ? std::atof(value->c_str()) : fallback;
+}
+
+const XmlElement* XmlElement::findChild(const std::string& childName) const {
+    for (const auto& child : children) {
+        if (child.name == childName) {
+            return &child;
+        }
+    }
+    return nullptr;
+}
+
+bool parseXml(const std::string& text, XmlElement& root, std::string& error) {
+    root = XmlElement();
+    XmlReader reader(text);
+    return reader.parseDocument(root, error);
+}
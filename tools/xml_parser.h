@@ -0,0 +1,26 @@
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+// Minimal XML element tree for the offline map tools (enough for Tiled's TMX/TSX files).
+// Comments, processing instructions and DOCTYPE are skipped; CDATA is kept as text.
+struct XmlElement {
+    std::string name;
+    std::vector<std::pair<std::string, std::string>> attributes;
+    std::vector<XmlElement> children;
+    std::string text; // Concatenated character data directly inside this element
+
+    const std::string* findAttribute(const std::string& key) const;
+    std::string getAttribute(const std::string& key, const std::string& fallback = "") const;
+    int getIntAttribute(const std::string& key, int fallback = 0) const;
+    double getDoubleAttribute(const std::string& key, double fallback = 0.0) const;
+
+    // First child with the given name, nullptr if there is none
+    const XmlElement* findChild(const std::string& childName) const;
+};
+
+// Parses the document's root element. Returns false and sets error (with line number)
+// on malformed input.
+bool parseXml(const std::string& text, XmlElement& root, std::string& error);